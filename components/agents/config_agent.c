@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
 #include "agents/config_agent.h"
 #include "agents/config_parser.h"
+#include "agents/contact_plan_parser.h"
 
 #include "ud3tn/bundle_processor.h"
 #include "ud3tn/common.h"
@@ -21,6 +22,7 @@ static struct config_parser parser;
 struct config_agent_params {
 	const char *local_eid;
 	bool allow_remote_configuration;
+	QueueIdentifier_t bp_queue;
 };
 
 static void router_command_send(struct router_command *cmd, void *param)
@@ -57,12 +59,24 @@ static void callback(struct bundle_adu data, void *param)
 		free(node_id);
 	}
 
-	config_parser_reset(&parser);
-	config_parser_read(
-		&parser,
-		data.payload,
-		data.length
-	);
+	if (contact_plan_is_bulk(data.payload, data.length)) {
+		struct router_command *const cmd = contact_plan_parse(
+			data.payload,
+			data.length
+		);
+
+		if (cmd != NULL)
+			router_command_send(cmd, ca_param->bp_queue);
+		else
+			LOG("ConfigAgent: Dropped invalid bulk contact plan");
+	} else {
+		config_parser_reset(&parser);
+		config_parser_read(
+			&parser,
+			data.payload,
+			data.length
+		);
+	}
 	bundle_adu_free_members(data);
 }
 
@@ -81,6 +95,7 @@ int config_agent_setup(
 	);
 	ca_param->local_eid = local_eid;
 	ca_param->allow_remote_configuration = allow_remote_configuration;
+	ca_param->bp_queue = bundle_processor_signaling_queue;
 
 	return bundle_processor_perform_agent_action(
 		bundle_processor_signaling_queue,
@@ -11,6 +11,7 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 static char const EID_START_DELIMITER = '(';
 static char const EID_END_DELIMITER = ')';
@@ -155,20 +156,36 @@ static void begin_read_integer(struct config_parser *parser)
 	parser->current_index = 0;
 }
 
+static void append_int_char(struct config_parser *parser, const char byte)
+{
+	parser->current_int_data[parser->current_index++] = byte;
+	if (parser->current_index >= DEFAULT_INT_BUFFER_SIZE)
+		parser->current_int_data = realloc(
+			parser->current_int_data,
+			(parser->current_index + 1) * sizeof(char));
+}
+
 static bool read_integer(struct config_parser *parser, const char byte)
 {
 	if (byte >= 0x30 && byte <= 0x39) { /* 0..9 */
-		parser->current_int_data[parser->current_index++] = byte;
-		if (parser->current_index >= DEFAULT_INT_BUFFER_SIZE)
-			parser->current_int_data = realloc(
-				parser->current_int_data,
-				(parser->current_index + 1) * sizeof(char));
+		append_int_char(parser, byte);
 		return true;
 	} else {
 		return false;
 	}
 }
 
+/* Timestamps are in seconds, optionally with a fractional part (".250") */
+static bool read_timestamp(struct config_parser *parser, const char byte)
+{
+	if (byte == '.' && parser->current_index != 0 &&
+	    !memchr(parser->current_int_data, '.', parser->current_index)) {
+		append_int_char(parser, byte);
+		return true;
+	}
+	return read_integer(parser, byte);
+}
+
 static void end_read_uint64(struct config_parser *parser, uint64_t *out)
 {
 	parser->current_int_data[parser->current_index] = '\0';
@@ -178,11 +195,24 @@ static void end_read_uint64(struct config_parser *parser, uint64_t *out)
 	parser->current_int_data = NULL;
 }
 
-static void end_read_uint32(struct config_parser *parser, uint32_t *out)
+/* Converts the timestamp to ms, further fractional digits are ignored */
+static void end_read_timestamp_ms(struct config_parser *parser, uint64_t *out)
 {
+	char *fraction;
+	uint64_t ms = 0;
+	int i;
+
 	parser->current_int_data[parser->current_index] = '\0';
-	/* No further checks because read_integer already checks for digits */
-	*out = strtoul(parser->current_int_data, NULL, 10);
+	fraction = strchr(parser->current_int_data, '.');
+	if (fraction != NULL) {
+		*fraction++ = '\0';
+		for (i = 0; i < 3; i++) {
+			ms *= 10;
+			if (*fraction != '\0')
+				ms += *fraction++ - '0';
+		}
+	}
+	*out = strtoull(parser->current_int_data, NULL, 10) * 1000 + ms;
 	free(parser->current_int_data);
 	parser->current_int_data = NULL;
 }
@@ -356,40 +386,40 @@ static void read_command(struct config_parser *parser, const uint8_t byte)
 		break;
 	case RP_EXPECT_CONTACT_START_TIME:
 		if (byte == OBJECT_ELEMENT_SEPARATOR) {
-			end_read_uint64(parser,
+			end_read_timestamp_ms(parser,
 				&(parser->current_contact->data->from));
 			begin_read_integer(parser);
 			parser->stage = RP_EXPECT_CONTACT_END_TIME;
-		} else if (!read_integer(parser, byte)) {
+		} else if (!read_timestamp(parser, byte)) {
 			parser->basedata->status = PARSER_STATUS_ERROR;
 		}
 		break;
 	case RP_EXPECT_CONTACT_END_TIME:
 		if (byte == OBJECT_ELEMENT_SEPARATOR) {
-			end_read_uint64(parser,
+			end_read_timestamp_ms(parser,
 				&(parser->current_contact->data->to));
 			if (parser->current_contact->data->to >
 				parser->current_contact->data->from
 				&& parser->current_contact->data->to >
-				hal_time_get_timestamp_s()
+				hal_time_get_timestamp_ms()
 			) {
 				begin_read_integer(parser);
 				parser->stage = RP_EXPECT_CONTACT_BITRATE;
 			} else {
 				parser->basedata->status = PARSER_STATUS_ERROR;
 			}
-		} else if (!read_integer(parser, byte)) {
+		} else if (!read_timestamp(parser, byte)) {
 			parser->basedata->status = PARSER_STATUS_ERROR;
 		}
 		break;
 	case RP_EXPECT_CONTACT_BITRATE:
 		if (byte == OBJECT_ELEMENT_SEPARATOR) {
-			end_read_uint32(parser,
+			end_read_uint64(parser,
 				&(parser->current_contact->data->bitrate));
 			parser->stage
 				= RP_EXPECT_CONTACT_NODE_LIST_START_DELIMITER;
 		} else if (byte == OBJECT_END_DELIMITER) {
-			end_read_uint32(parser,
+			end_read_uint64(parser,
 				&(parser->current_contact->data->bitrate));
 			parser->stage = RP_EXPECT_CONTACT_SEPARATOR;
 		} else if (!read_integer(parser, byte)) {
@@ -462,7 +492,7 @@ static void config_parser_read_byte(struct config_parser *parser, uint8_t byte)
 	if (parser->stage == RP_EXPECT_COMMAND_TYPE) {
 		parser->stage = RP_EXPECT_NODE_CONF_START_DELIMITER;
 		if (byte >= (uint8_t)ROUTER_COMMAND_ADD
-			&& byte <= (uint8_t)ROUTER_COMMAND_QUERY
+			&& byte <= (uint8_t)ROUTER_COMMAND_MODIFY
 		) {
 			parser->router_command->type
 				= (enum router_command_type)byte;
@@ -523,6 +553,8 @@ enum ud3tn_result config_parser_reset(struct config_parser *parser)
 	if (parser->router_command == NULL)
 		return UD3TN_FAIL;
 	parser->router_command->type = ROUTER_COMMAND_UNDEFINED;
+	parser->router_command->nodes = NULL;
+	parser->router_command->node_count = 0;
 	parser->router_command->data = node_create(NULL);
 	if (parser->router_command->data == NULL)
 		return UD3TN_FAIL;
@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#include "agents/contact_plan_parser.h"
+
+#include "ud3tn/common.h"
+#include "ud3tn/node.h"
+#include "ud3tn/router.h"
+
+#include "platform/hal_io.h"
+#include "platform/hal_time.h"
+
+#include "cbor.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+bool contact_plan_is_bulk(const uint8_t *buffer, size_t length)
+{
+	// CBOR major type 4 (array)
+	return length != 0 && (buffer[0] & 0xE0) == 0x80;
+}
+
+static CborError parse_string(CborValue *it, char **result)
+{
+	size_t length;
+
+	if (!cbor_value_is_text_string(it))
+		return CborErrorIllegalType;
+	// Allocates exactly the length of the string and advances the value.
+	return cbor_value_dup_text_string(it, result, &length, it);
+}
+
+static CborError parse_uint(CborValue *it, uint64_t *result)
+{
+	CborError err;
+
+	if (!cbor_value_is_unsigned_integer(it))
+		return CborErrorIllegalType;
+	err = cbor_value_get_uint64(it, result);
+	if (err != CborNoError)
+		return err;
+	return cbor_value_advance_fixed(it);
+}
+
+static CborError parse_eid_list(CborValue *it, struct endpoint_list **list)
+{
+	struct endpoint_list *entry;
+	CborValue item;
+	CborError err;
+
+	if (!cbor_value_is_array(it))
+		return CborErrorIllegalType;
+	err = cbor_value_enter_container(it, &item);
+	while (err == CborNoError && !cbor_value_at_end(&item)) {
+		// The order does not matter, the list is sorted later.
+		entry = malloc(sizeof(struct endpoint_list));
+		if (entry == NULL)
+			return CborErrorOutOfMemory;
+		entry->eid = NULL;
+		entry->next = *list;
+		*list = entry;
+		err = parse_string(&item, &entry->eid);
+	}
+	if (err != CborNoError)
+		return err;
+	return cbor_value_leave_container(it, &item);
+}
+
+static CborError parse_contact(CborValue *it, struct node *node)
+{
+	struct contact_list *entry;
+	struct contact *contact;
+	CborValue field;
+	CborError err;
+
+	if (!cbor_value_is_array(it))
+		return CborErrorIllegalType;
+	entry = malloc(sizeof(struct contact_list));
+	if (entry == NULL)
+		return CborErrorOutOfMemory;
+	contact = contact_create(node);
+	if (contact == NULL) {
+		free(entry);
+		return CborErrorOutOfMemory;
+	}
+	// The order does not matter, the list is sorted by the routing table.
+	entry->data = contact;
+	entry->next = node->contacts;
+	node->contacts = entry;
+
+	err = cbor_value_enter_container(it, &field);
+	if (err == CborNoError)
+		err = parse_uint(&field, &contact->from);
+	if (err == CborNoError)
+		err = parse_uint(&field, &contact->to);
+	if (err == CborNoError)
+		err = parse_uint(&field, &contact->bitrate);
+	// The list of EIDs reachable via the contact is optional.
+	if (err == CborNoError && !cbor_value_at_end(&field))
+		err = parse_eid_list(&field, &contact->contact_endpoints);
+	if (err == CborNoError && !cbor_value_at_end(&field))
+		err = CborErrorTooManyItems;
+	// Same constraints as for the text format
+	if (err == CborNoError && (contact->to <= contact->from ||
+				   contact->to <= hal_time_get_timestamp_ms()))
+		err = CborErrorIllegalNumber;
+	if (err != CborNoError)
+		return err;
+	return cbor_value_leave_container(it, &field);
+}
+
+static CborError parse_contact_list(CborValue *it, struct node *node)
+{
+	CborValue item;
+	CborError err;
+
+	if (!cbor_value_is_array(it))
+		return CborErrorIllegalType;
+	err = cbor_value_enter_container(it, &item);
+	while (err == CborNoError && !cbor_value_at_end(&item))
+		err = parse_contact(&item, node);
+	if (err != CborNoError)
+		return err;
+	return cbor_value_leave_container(it, &item);
+}
+
+static CborError parse_node(CborValue *it, struct node **result)
+{
+	struct node *node;
+	CborValue field;
+	CborError err;
+
+	if (!cbor_value_is_array(it))
+		return CborErrorIllegalType;
+	node = node_create(NULL);
+	if (node == NULL)
+		return CborErrorOutOfMemory;
+	*result = node;
+
+	err = cbor_value_enter_container(it, &field);
+	if (err == CborNoError)
+		err = parse_string(&field, &node->eid);
+	// The CLA address may be null to keep the one of an existing node.
+	if (err == CborNoError) {
+		if (cbor_value_is_null(&field))
+			err = cbor_value_advance_fixed(&field);
+		else
+			err = parse_string(&field, &node->cla_addr);
+	}
+	if (err == CborNoError)
+		err = parse_eid_list(&field, &node->endpoints);
+	if (err == CborNoError)
+		err = parse_contact_list(&field, node);
+	if (err == CborNoError && !cbor_value_at_end(&field))
+		err = CborErrorTooManyItems;
+	if (err != CborNoError)
+		return err;
+	return cbor_value_leave_container(it, &field);
+}
+
+static void free_command(struct router_command *cmd)
+{
+	size_t i;
+
+	for (i = 0; i < cmd->node_count; i++)
+		free_node(cmd->nodes[i]);
+	free(cmd->nodes);
+	free(cmd);
+}
+
+struct router_command *contact_plan_parse(
+	const uint8_t *buffer, size_t length)
+{
+	struct router_command *cmd;
+	CborParser parser;
+	CborValue it, item;
+	CborError err;
+	size_t count = 0;
+
+	err = cbor_parser_init(buffer, length, 0, &parser, &it);
+	if (err == CborNoError && (!cbor_value_is_array(&it) ||
+				   !cbor_value_is_length_known(&it)))
+		err = CborErrorIllegalType;
+	if (err == CborNoError)
+		err = cbor_value_get_array_length(&it, &count);
+	// Every node takes at least one byte, this limits the allocation.
+	if (err == CborNoError && count > length)
+		err = CborErrorUnexpectedEOF;
+	if (err != CborNoError) {
+		LOGF("ContactPlanParser: Invalid plan header: %s",
+		     cbor_error_string(err));
+		return NULL;
+	}
+
+	cmd = malloc(sizeof(struct router_command));
+	if (cmd == NULL)
+		return NULL;
+	cmd->type = ROUTER_COMMAND_ADD_BULK;
+	cmd->data = NULL;
+	cmd->node_count = 0;
+	cmd->nodes = calloc(count ? count : 1, sizeof(struct node *));
+	if (cmd->nodes == NULL) {
+		free(cmd);
+		return NULL;
+	}
+
+	err = cbor_value_enter_container(&it, &item);
+	while (err == CborNoError && !cbor_value_at_end(&item)) {
+		err = parse_node(&item, &cmd->nodes[cmd->node_count]);
+		// Also count a partially parsed node so that it is freed.
+		if (cmd->nodes[cmd->node_count] != NULL)
+			cmd->node_count++;
+	}
+	if (err == CborNoError)
+		err = cbor_value_leave_container(&it, &item);
+	if (err == CborNoError && cbor_value_get_next_byte(&it) !=
+			buffer + length)
+		err = CborErrorGarbageAtEnd;
+	if (err != CborNoError) {
+		LOGF("ContactPlanParser: Invalid plan at node %zu: %s",
+		     cmd->node_count, cbor_error_string(err));
+		free_command(cmd);
+		return NULL;
+	}
+	return cmd;
+}
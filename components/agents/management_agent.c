@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 struct management_agent_params {
+	QueueIdentifier_t bp_queue;
 	const char *local_eid;
 	bool allow_remote_configuration;
 };
@@ -60,6 +61,15 @@ static void callback(struct bundle_adu data, void *param)
 
 			hal_time_init(t);
 			LOGF("MgmtAgent: Updated time to DTN ts: %llu", t);
+			bundle_processor_inform(
+				ma_param->bp_queue,
+				NULL,
+				BP_SIGNAL_TIME_CHANGED,
+				NULL,
+				NULL,
+				NULL,
+				NULL
+			);
 		} else {
 			LOG("MgmtAgent: Received invalid time command.");
 		}
@@ -76,6 +86,7 @@ int management_agent_setup(QueueIdentifier_t bundle_processor_signaling_queue,
 	struct management_agent_params *const ma_param = malloc(
 		sizeof(struct management_agent_params)
 	);
+	ma_param->bp_queue = bundle_processor_signaling_queue;
 	ma_param->local_eid = local_eid;
 	ma_param->allow_remote_configuration = allow_remote_configuration;
 	const int is_ipn = get_eid_scheme(local_eid) == EID_SCHEME_IPN;
@@ -445,7 +445,7 @@ static int send_bundle(const int socket_fd, struct bundle_adu data)
 		),
 		.eid = data.source,
 		.eid_length = strlen(data.source),
-		.payload = data.payload,
+		.payload = data.payload + data.payload_offset,
 		.payload_length = data.length,
 	};
 	const int send_result = send_message(socket_fd, &bundle_msg);
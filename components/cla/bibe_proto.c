@@ -17,6 +17,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 size_t bibe_parser_parse(const uint8_t *const buffer,
@@ -77,46 +78,30 @@ size_t bibe_parser_parse(const uint8_t *const buffer,
 	if (!cbor_value_is_byte_string(&report))
 		return CborErrorIllegalType;
 
+	// The bundle is parsed in place, thus, it must be stored contiguously.
+	if (!cbor_value_is_length_known(&report))
+		return CborErrorUnknownLength;
+
 	size_t bundle_str_len;
-	enum CborError retval;
 
-	cbor_value_get_string_length(&report, &bundle_str_len);
-	// Allocate memory for the encapsulated bundle
-	bpdu->encapsulated_bundle = malloc(bundle_str_len);
-	bpdu->payload_length = bundle_str_len;
-	// From the cbor docs:
-	//   "The next pointer, if not null, will be updated to point to the next item after
-	//    this string. If value points to the last item, then next will be invalid."
-	// Since we don't have a next element, we need to pass a null pointer to the function here.
-	cbor_value_copy_byte_string(
-		&report,
-		bpdu->encapsulated_bundle,
-		&bundle_str_len,
-		NULL
+	if (cbor_value_get_string_length(&report, &bundle_str_len))
+		return CborErrorInternalError;
+	if (cbor_value_advance(&report))
+		return CborErrorUnexpectedEOF;
+
+	// The encapsulated bundle points into the input buffer. Discard const,
+	// the callers only read from it.
+	bpdu->encapsulated_bundle = (uint8_t *)(
+		cbor_value_get_next_byte(&report) - bundle_str_len
 	);
-	if (cbor_value_advance(&report)) {
-		retval = CborErrorUnexpectedEOF;
-		goto fail;
-	}
+	bpdu->payload_length = bundle_str_len;
 
 	// Leave BPDU container
 	if (!cbor_value_at_end(&report) ||
-	    cbor_value_leave_container(&it, &report)) {
-		retval = CborErrorInternalError;
-		goto fail;
-	}
+	    cbor_value_leave_container(&it, &report))
+		return CborErrorInternalError;
 
 	return 0;
-
-fail:
-	free(bpdu->encapsulated_bundle);
-	return retval;
-}
-
-static void write_to_buffer(
-	uint8_t *buffer, const void *data, size_t position, const size_t length)
-{
-	memcpy(&buffer[position], data, length);
 }
 
 struct bibe_header bibe_encode_header(const char *const dest_eid,
@@ -125,31 +110,23 @@ struct bibe_header bibe_encode_header(const char *const dest_eid,
 	struct bibe_header hdr;
 	const size_t eid_len = strlen(dest_eid);
 
-	/* Encoding length of the bundle byte string */
-	uint8_t *temp_buffer = malloc(sizeof(uint64_t));
+	/* Encoding the BPDU up to the contents of the bundle byte string */
+	uint8_t bpdu_bytes[3 + 9];
 	CborEncoder encoder;
 
-	cbor_encoder_init(&encoder, temp_buffer, sizeof(uint64_t), 0);
+	bpdu_bytes[0] = 0x83; // 83 (100|00011) -> Array of length 3
+	bpdu_bytes[1] = 0x00; // 00             -> Integer 0 (transm. ID)
+	bpdu_bytes[2] = 0x00; // 00             -> Integer 0 (retr. time)
+	// bpdu_bytes[3 to x] contains the length of the bundle byte string
+	// the encapsulated bundle itself will be sent via cla_bibe.c's send_packet_data
+	cbor_encoder_init(&encoder, &bpdu_bytes[3], sizeof(bpdu_bytes) - 3, 0);
 	cbor_encode_uint(&encoder, (uint64_t)payload_len);
+	bpdu_bytes[3] |= 0x40; // see bundle7 serializer.c lines 235-239
+
 	const size_t bpdu_size = cbor_encoder_get_buffer_size(
 		&encoder,
-		temp_buffer
-	) + 3; // buffer size + 3 for the BPDU data
-	temp_buffer[0] |= 0x40; // see bundle7 serializer.c lines 235-239
-
-	/* Encoding the BPDU */
-	char *bibe_bytes = malloc(bpdu_size);
-
-	bibe_bytes[0] = 0x83; // 83 (100|00011) -> Array of length 3
-	bibe_bytes[1] = 0x00; // 00             -> Integer 0 (transm. ID)
-	bibe_bytes[2] = 0x00; // 00             -> Integer 0 (retr. time)
-	// bibe_bytes[3 to x] contains the length of the bundle byte string
-	// the encapsulated bundle itself will be sent via cla_bibe.c's send_packet_data
-
-	for (size_t i = 3; i < bpdu_size; i++)
-		bibe_bytes[i] = temp_buffer[i - 3];
-
-	free(temp_buffer);
+		&bpdu_bytes[3]
+	) + 3;
 
 	/* Building and encoding the AAP message */
 	struct aap_message msg;
@@ -169,14 +146,7 @@ struct bibe_header bibe_encode_header(const char *const dest_eid,
 
 	aap_serialize_into(hdr.data, &msg, false);
 	/* Appending the BPDU to the AAP message */
-	write_to_buffer(
-		hdr.data,
-		bibe_bytes,
-		hdr.hdr_len - bpdu_size,
-		bpdu_size
-	);
-
-	free(bibe_bytes);
+	memcpy(&hdr.data[hdr.hdr_len - bpdu_size], bpdu_bytes, bpdu_size);
 
 	return hdr;
 }
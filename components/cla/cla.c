@@ -3,9 +3,13 @@
 #include "cla/cla_contact_tx_task.h"
 
 #include "cla/posix/cla_mtcp.h"
+#include "cla/posix/cla_shm.h"
 #include "cla/posix/cla_smtcp.h"
 #include "cla/posix/cla_tcpclv3.h"
+#include "cla/posix/cla_tcpclv4.h"
 #include "cla/posix/cla_tcpspp.h"
+#include "cla/posix/cla_udp.h"
+#include "cla/posix/cla_unix.h"
 #include "cla/posix/cla_bibe.h"
 
 #include "platform/hal_io.h"
@@ -39,8 +43,12 @@ const struct available_cla_list_entry AVAILABLE_CLAS[] = {
 	{ "mtcp", &mtcp_create },
 	{ "smtcp", &smtcp_create },
 	{ "tcpclv3", &tcpclv3_create },
+	{ "tcpclv4", &tcpclv4_create },
 	{ "tcpspp", &tcpspp_create },
+	{ "udp", &udp_create },
 	{ "bibe", &bibe_create },
+	{ "shm", &shm_create },
+	{ "unix", &unix_create },
 };
 
 
@@ -166,6 +174,13 @@ enum ud3tn_result cla_link_init(struct cla_link *link,
 
 	link->tx_queue_handle = NULL;
 	link->tx_queue_sem = NULL;
+	link->tx_backlog.queued_bytes = 0;
+	link->tx_backlog.congested = false;
+	link->tx_backlog.wire_size_permille = 1000;
+	link->tx_packet_wire_size = 0;
+	link->tx_packet_failed = false;
+	link->tx_flushed_sent = 0;
+	link->tx_flushed_dropped = 0;
 
 	// Semaphores used for waiting for the tasks to exit
 	// NOTE: They are already locked on creation!
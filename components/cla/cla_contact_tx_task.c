@@ -9,12 +9,17 @@
 #include "platform/hal_io.h"
 #include "platform/hal_semaphore.h"
 #include "platform/hal_task.h"
+#include "platform/hal_time.h"
 
 #include "ud3tn/bundle.h"
 #include "ud3tn/bundle_processor.h"
 #include "ud3tn/common.h"
+#include "ud3tn/config.h"
 #include "ud3tn/task_tags.h"
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 // BPv7 5.4-4 / RFC5050 5.4-5
@@ -43,81 +48,381 @@ static void prepare_bundle_for_forwarding(struct bundle *bundle)
 		LOGF("TX: Bundle %p age block update failed!", bundle);
 }
 
+/*
+ * Bundles handed over to the TX task are queued locally per routing
+ * priority, so that bundles with a higher priority that arrive while the
+ * transmission is paced are sent before the remaining bulk bundles. Which
+ * priority is served next is determined by CONTACT_TX_DISCIPLINE.
+ */
+struct tx_pending_bundles {
+	struct routed_bundle_list *head[BUNDLE_RPRIO_MAX];
+	struct routed_bundle_list **tail[BUNDLE_RPRIO_MAX];
+	// State of the weighted discipline: the bytes each priority may still
+	// send in the current round and the priority currently served
+	int64_t deficit[BUNDLE_RPRIO_MAX];
+	int current;
+	// The CLA address attached to the most recent command
+	char *cla_address;
+};
+
+static const int64_t tx_quantum[BUNDLE_RPRIO_MAX] = {
+	[BUNDLE_RPRIO_LOW] = CONTACT_TX_QUANTUM_LOW,
+	[BUNDLE_RPRIO_NORMAL] = CONTACT_TX_QUANTUM_NORMAL,
+	[BUNDLE_RPRIO_HIGH] = CONTACT_TX_QUANTUM_HIGH,
+};
+
+// Token bucket limiting the sending rate to the bitrate of the contact
+struct tx_pacer {
+	uint64_t bitrate;
+	int64_t tokens;
+	uint64_t last_refill_ms;
+};
+
+static void pending_init(struct tx_pending_bundles *pending)
+{
+	for (int i = 0; i < BUNDLE_RPRIO_MAX; i++) {
+		pending->head[i] = NULL;
+		pending->tail[i] = &pending->head[i];
+		pending->deficit[i] = 0;
+	}
+	pending->current = BUNDLE_RPRIO_MAX - 1;
+	pending->deficit[pending->current] = tx_quantum[pending->current];
+	pending->cla_address = NULL;
+}
+
+static void pending_add(struct tx_pending_bundles *pending,
+			struct cla_contact_tx_task_command *cmd)
+{
+	struct routed_bundle_list *rbl = cmd->bundles;
+
+	while (rbl) {
+		struct routed_bundle_list *const next = rbl->next;
+		const enum bundle_routing_priority prio =
+			bundle_get_routing_priority(rbl->data);
+
+		rbl->next = NULL;
+		*pending->tail[prio] = rbl;
+		pending->tail[prio] = &rbl->next;
+		rbl = next;
+	}
+
+	// Free the previously attached CLA address - a copy is made by the
+	// contact manager because the contact containing the original copy
+	// may be deleted in the meantime.
+	free(pending->cla_address);
+	pending->cla_address = cmd->cla_address;
+}
+
+static bool pending_available(const struct tx_pending_bundles *pending)
+{
+	for (int i = 0; i < BUNDLE_RPRIO_MAX; i++) {
+		if (pending->head[i])
+			return true;
+	}
+	return false;
+}
+
+static struct routed_bundle_list *pending_pop_head(
+	struct tx_pending_bundles *pending, const int prio)
+{
+	struct routed_bundle_list *const rbl = pending->head[prio];
+
+	pending->head[prio] = rbl->next;
+	if (!pending->head[prio])
+		pending->tail[prio] = &pending->head[prio];
+	return rbl;
+}
+
+// Deficit round robin: Every priority may send up to its quantum per round.
+static struct routed_bundle_list *pending_pop_weighted(
+	struct tx_pending_bundles *pending)
+{
+	if (!pending_available(pending))
+		return NULL;
+
+	for (;;) {
+		const int i = pending->current;
+		const struct routed_bundle_list *const rbl = pending->head[i];
+
+		if (!rbl) {
+			// Idle priorities do not accumulate credit.
+			pending->deficit[i] = 0;
+		} else {
+			const int64_t size = bundle_get_serialized_size(
+				rbl->data
+			);
+
+			if (pending->deficit[i] >= size) {
+				pending->deficit[i] -= size;
+				return pending_pop_head(pending, i);
+			}
+		}
+		// Continue with the next lower priority, wrapping around.
+		pending->current = (i + BUNDLE_RPRIO_MAX - 1) % BUNDLE_RPRIO_MAX;
+		pending->deficit[pending->current] +=
+			tx_quantum[pending->current];
+	}
+}
+
+static struct routed_bundle_list *pending_pop(
+	struct tx_pending_bundles *pending)
+{
+	if (CONTACT_TX_DISCIPLINE == CONTACT_TX_DISCIPLINE_WEIGHTED)
+		return pending_pop_weighted(pending);
+
+	for (int i = BUNDLE_RPRIO_MAX - 1; i >= 0; i--) {
+		if (pending->head[i])
+			return pending_pop_head(pending, i);
+	}
+	return NULL;
+}
+
+// Returns the time in ms until the next bundle may be sent.
+static int pacer_get_delay(struct tx_pacer *pacer)
+{
+	if (!CONTACT_TX_PACING_ENABLED || !pacer->bitrate)
+		return 0;
+
+	const uint64_t now = hal_time_get_timestamp_ms();
+	const int64_t max_tokens = (
+		pacer->bitrate * CONTACT_TX_PACING_BURST_MS / 1000
+	);
+	const int64_t refill = (
+		now > pacer->last_refill_ms
+		? (int64_t)((now - pacer->last_refill_ms) * pacer->bitrate /
+			    1000)
+		: 0
+	);
+
+	// Only advance the timestamp if tokens were added, otherwise low
+	// bitrates would never lead to a refill.
+	if (refill > 0) {
+		pacer->tokens = MIN(pacer->tokens + refill, max_tokens);
+		pacer->last_refill_ms = now;
+	}
+
+	if (pacer->tokens >= 0)
+		return 0;
+
+	const uint64_t delay = (
+		((uint64_t)-pacer->tokens * 1000 + pacer->bitrate - 1) /
+		pacer->bitrate
+	);
+
+	// Large debts at low bitrates would exceed the range of the timeout,
+	// it is simply re-checked after waiting for a bounded time.
+	return (int)MIN(delay, (uint64_t)CONTACT_TX_PACING_MAX_DELAY_MS);
+}
+
+static void pacer_set_bitrate(struct tx_pacer *pacer, const uint64_t bitrate)
+{
+	if (pacer->bitrate == bitrate)
+		return;
+	pacer->bitrate = bitrate;
+	pacer->tokens = 0;
+	pacer->last_refill_ms = hal_time_get_timestamp_ms();
+}
+
+// A bundle may always be sent if there is no debt, it is paid off later.
+static void pacer_consume(struct tx_pacer *pacer, const size_t bytes)
+{
+	if (pacer->bitrate)
+		pacer->tokens -= bytes;
+}
+
+/*
+ * Bundles buffered by CLAs implementing cla_flush are only reported as sent
+ * after the CLA handed them over to the lower layer.
+ */
+struct tx_unconfirmed_bundles {
+	struct routed_bundle_list *head;
+	struct routed_bundle_list **tail;
+};
+
+static void tx_signal(struct cla_link *link, QueueIdentifier_t queue,
+		      struct bundle *b, enum bundle_processor_signal_type type)
+{
+	bundle_processor_inform(
+		queue,
+		b,
+		type,
+		cla_get_cla_addr_from_link(link),
+		NULL,
+		NULL,
+		NULL
+	);
+}
+
+// Processes the result of the last flush reported by the CLA.
+static void tx_confirm_flushed(struct cla_link *link, QueueIdentifier_t queue,
+			       struct tx_unconfirmed_bundles *unconfirmed)
+{
+	struct routed_bundle_list *dropped = NULL;
+	struct routed_bundle_list **dropped_tail = &dropped;
+	struct routed_bundle_list *rbl;
+
+	while (unconfirmed->head &&
+	       (link->tx_flushed_sent || link->tx_flushed_dropped)) {
+		rbl = unconfirmed->head;
+		unconfirmed->head = rbl->next;
+		rbl->next = NULL;
+		if (link->tx_flushed_sent) {
+			link->tx_flushed_sent--;
+			tx_signal(link, queue, rbl->data,
+				  BP_SIGNAL_TRANSMISSION_SUCCESS);
+			free(rbl);
+		} else {
+			link->tx_flushed_dropped--;
+			*dropped_tail = rbl;
+			dropped_tail = &rbl->next;
+		}
+	}
+	if (!unconfirmed->head)
+		unconfirmed->tail = &unconfirmed->head;
+	link->tx_flushed_sent = 0;
+	link->tx_flushed_dropped = 0;
+
+	if (dropped)
+		bundle_processor_reschedule_bundles(
+			queue,
+			dropped,
+			cla_get_cla_addr_from_link(link)
+		);
+}
+
 static void cla_contact_tx_task(void *param)
 {
 	struct cla_link *link = param;
 	struct cla_contact_tx_task_command cmd;
+	struct tx_pending_bundles pending;
+	struct tx_pacer pacer = { 0, 0, 0 };
+	struct tx_unconfirmed_bundles unconfirmed;
+	bool unflushed = false;
 
 	enum ud3tn_result s;
 	void const *cla_send_packet_data =
 		link->config->vtable->cla_send_packet_data;
 	QueueIdentifier_t signaling_queue =
 		link->config->bundle_agent_interface->bundle_signaling_queue;
+	const bool buffered = link->config->vtable->cla_flush != NULL;
+
+	pending_init(&pending);
+	unconfirmed.head = NULL;
+	unconfirmed.tail = &unconfirmed.head;
 
 	while (link->active) {
+		const bool has_pending = pending_available(&pending);
+		// Block if there is nothing to send, else check for new
+		// bundles while waiting for the pacer.
+		const int timeout = has_pending ? pacer_get_delay(&pacer) : -1;
+
+		// Allow the CLA to send multiple bundles at once, if supported.
+		if (timeout != 0 && unflushed) {
+			if (buffered) {
+				link->config->vtable->cla_flush(link);
+				tx_confirm_flushed(link, signaling_queue,
+						   &unconfirmed);
+			}
+			unflushed = false;
+		}
+
 		if (hal_queue_receive(link->tx_queue_handle,
-				      &cmd, -1) == UD3TN_FAIL)
+				      &cmd, timeout) == UD3TN_OK) {
+			if (cmd.type == TX_COMMAND_FINALIZE || !cmd.bundles)
+				break;
+			pacer_set_bitrate(&pacer, cmd.bitrate);
+			pending_add(&pending, &cmd);
 			continue;
-		else if (cmd.type == TX_COMMAND_FINALIZE || !cmd.bundles)
-			break;
-
-		struct routed_bundle_list *rbl = cmd.bundles;
+		}
 
-		while (rbl) {
-			struct bundle *b = rbl->data;
+		if (!has_pending || timeout != 0)
+			continue;
 
-			prepare_bundle_for_forwarding(b);
-			LOGF(
-				"TX: Sending bundle %p via CLA %s",
-				b,
-				link->config->vtable->cla_name_get()
-			);
-			link->config->vtable->cla_begin_packet(
-				link,
-				bundle_get_serialized_size(b),
-				cmd.cla_address
-			);
-			s = bundle_serialize(
-				b,
-				cla_send_packet_data,
-				(void *)link
+		struct routed_bundle_list *const rbl = pending_pop(&pending);
+		struct bundle *b = rbl->data;
+		const size_t serialized_size = bundle_get_serialized_size(b);
+
+		prepare_bundle_for_forwarding(b);
+		LOGF(
+			"TX: Sending bundle %p via CLA %s",
+			b,
+			link->config->vtable->cla_name_get()
+		);
+		link->tx_packet_wire_size = 0;
+		link->tx_packet_failed = false;
+		link->config->vtable->cla_begin_packet(
+			link,
+			serialized_size,
+			pending.cla_address
+		);
+		s = bundle_serialize(
+			b,
+			cla_send_packet_data,
+			(void *)link
+		);
+		link->config->vtable->cla_end_packet(link);
+		pacer_consume(&pacer, serialized_size);
+		unflushed = true;
+		cla_tx_backlog_release(
+			link,
+			&link->tx_backlog,
+			link->tx_queue_sem,
+			serialized_size,
+			(
+				link->tx_packet_wire_size
+				? link->tx_packet_wire_size
+				: serialized_size
+			)
+		);
+
+		if (link->tx_packet_failed || (!buffered && !link->active)) {
+			// The bundle was not sent, so it can be sent via another
+			// contact, in contrast to a serialization failure.
+			rbl->next = NULL;
+			bundle_processor_reschedule_bundles(
+				signaling_queue,
+				rbl,
+				cla_get_cla_addr_from_link(link)
 			);
-			link->config->vtable->cla_end_packet(link);
-
-			if (s == UD3TN_OK) {
-				bundle_processor_inform(
-					signaling_queue,
-					b,
-					BP_SIGNAL_TRANSMISSION_SUCCESS,
-					cla_get_cla_addr_from_link(link),
-					NULL,
-					NULL,
-					NULL
-				);
-			} else {
-				bundle_processor_inform(
-					signaling_queue,
-					b,
-					BP_SIGNAL_TRANSMISSION_FAILURE,
-					cla_get_cla_addr_from_link(link),
-					NULL,
-					NULL,
-					NULL
-				);
-			}
+		} else if (s != UD3TN_OK) {
+			free(rbl);
+			tx_signal(link, signaling_queue, b,
+				  BP_SIGNAL_TRANSMISSION_FAILURE);
+		} else if (buffered) {
+			rbl->next = NULL;
+			*unconfirmed.tail = rbl;
+			unconfirmed.tail = &rbl->next;
+		} else {
+			free(rbl);
+			tx_signal(link, signaling_queue, b,
+				  BP_SIGNAL_TRANSMISSION_SUCCESS);
+		}
 
-			struct routed_bundle_list *tmp = rbl;
+		// The CLA may have flushed its buffer in cla_end_packet.
+		if (buffered)
+			tx_confirm_flushed(link, signaling_queue, &unconfirmed);
+	}
 
-			rbl = rbl->next;
-			// Free the bundle list from the command step-by-step.
-			free(tmp);
-		}
+	// Buffered packets are always flushed, even if the link went down,
+	// as they are not rescheduled otherwise.
+	if (buffered) {
+		if (unflushed)
+			link->config->vtable->cla_flush(link);
+		tx_confirm_flushed(link, signaling_queue, &unconfirmed);
+	}
+
+	// Bundles not sent yet are handed back to the BP in a single batch so
+	// that they can be rescheduled without flooding the signaling queue.
+	struct routed_bundle_list *leftover = unconfirmed.head;
+	struct routed_bundle_list **leftover_tail = unconfirmed.tail;
+	struct routed_bundle_list *rbl;
 
-		// Free the attached CLA address - a copy is made by the
-		// contact manager because the contact containing the original
-		// copy may be deleted in the meantime.
-		free(cmd.cla_address);
+	while ((rbl = pending_pop(&pending)) != NULL) {
+		rbl->next = NULL;
+		*leftover_tail = rbl;
+		leftover_tail = &rbl->next;
 	}
+	free(pending.cla_address);
 
 	// Lock the queue before we start to free it
 	hal_semaphore_take_blocking(link->tx_queue_sem);
@@ -125,31 +430,20 @@ static void cla_contact_tx_task(void *param)
 	// Consume the rest of the queue
 	while (hal_queue_receive(link->tx_queue_handle, &cmd, 0) != UD3TN_FAIL) {
 		if (cmd.type == TX_COMMAND_BUNDLES) {
-			struct routed_bundle_list *rbl = cmd.bundles;
-
-			while (rbl) {
-				struct bundle *b = rbl->data;
-
-				bundle_processor_inform(
-					signaling_queue,
-					b,
-					BP_SIGNAL_TRANSMISSION_FAILURE,
-					cla_get_cla_addr_from_link(link),
-					NULL,
-					NULL,
-					NULL
-				);
-
-				struct routed_bundle_list *tmp = rbl;
-
-				rbl = rbl->next;
-				free(tmp);
-			}
-
+			*leftover_tail = cmd.bundles;
+			while (*leftover_tail)
+				leftover_tail = &(*leftover_tail)->next;
 			free(cmd.cla_address);
 		}
 	}
 
+	if (leftover)
+		bundle_processor_reschedule_bundles(
+			signaling_queue,
+			leftover,
+			cla_get_cla_addr_from_link(link)
+		);
+
 	Task_t tx_task_handle = link->tx_task_handle;
 
 	// After releasing the semaphore, link may become invalid.
@@ -179,12 +473,54 @@ enum ud3tn_result cla_launch_contact_tx_task(struct cla_link *link)
 	return link->tx_task_handle ? UD3TN_OK : UD3TN_FAIL;
 }
 
+void cla_tx_backlog_release(struct cla_link *link,
+			    struct cla_tx_backlog *backlog,
+			    Semaphore_t tx_queue_sem, const size_t bytes,
+			    const size_t wire_bytes)
+{
+	bool drained = false;
+
+	hal_semaphore_take_blocking(tx_queue_sem);
+	backlog->queued_bytes -= MIN(backlog->queued_bytes, bytes);
+	if (bytes) {
+		// Moving average over the last ~8 packets
+		const uint64_t permille = MIN(
+			(uint64_t)wire_bytes * 1000 / bytes,
+			(uint64_t)UINT16_MAX
+		);
+		const uint64_t average = (
+			7 * (uint64_t)backlog->wire_size_permille + permille
+		) / 8;
+
+		backlog->wire_size_permille = (uint16_t)MAX(average, 1ULL);
+	}
+	if (backlog->congested &&
+	    backlog->queued_bytes <= CONTACT_TX_QUEUE_LOW_WATERMARK) {
+		backlog->congested = false;
+		drained = true;
+	}
+	hal_semaphore_release(tx_queue_sem);
+
+	if (drained)
+		bundle_processor_inform(
+			link->config->bundle_agent_interface
+				->bundle_signaling_queue,
+			NULL,
+			BP_SIGNAL_TX_BACKLOG_LOW,
+			cla_get_cla_addr_from_link(link),
+			NULL,
+			NULL,
+			NULL
+		);
+}
+
 void cla_contact_tx_task_request_exit(QueueIdentifier_t queue)
 {
 	struct cla_contact_tx_task_command command = {
 		.type = TX_COMMAND_FINALIZE,
 		.bundles = NULL,
 		.cla_address = NULL,
+		.bitrate = 0,
 	};
 
 	ASSERT(queue != NULL);
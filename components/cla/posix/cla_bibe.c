@@ -363,16 +363,17 @@ static struct cla_tx_queue bibe_get_tx_queue(
 
 		// Freed while trying to obtain it
 		if (!cla_link->tx_queue_handle)
-			return (struct cla_tx_queue){ NULL, NULL };
+			return (struct cla_tx_queue){ NULL, NULL, NULL };
 
 		return (struct cla_tx_queue){
 			.tx_queue_handle = cla_link->tx_queue_handle,
 			.tx_queue_sem = cla_link->tx_queue_sem,
+			.tx_backlog = &cla_link->tx_backlog,
 		};
 	}
 
 	hal_semaphore_release(bibe_config->param_htab_sem);
-	return (struct cla_tx_queue){ NULL, NULL };
+	return (struct cla_tx_queue){ NULL, NULL, NULL };
 }
 
 static enum ud3tn_result bibe_start_scheduled_contact(
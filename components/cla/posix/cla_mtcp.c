@@ -14,29 +14,38 @@
 #include "platform/hal_queue.h"
 #include "platform/hal_semaphore.h"
 #include "platform/hal_task.h"
+#include "platform/hal_time.h"
 #include "platform/hal_types.h"
 
 #include "ud3tn/cmdline.h"
+#include "ud3tn/bundle.h"
 #include "ud3tn/bundle_processor.h"
 #include "ud3tn/common.h"
 #include "ud3tn/config.h"
+#include "ud3tn/hashmap.h"
 #include "ud3tn/result.h"
-#include "ud3tn/simplehtab.h"
 #include "ud3tn/task_tags.h"
 
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <errno.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 struct mtcp_config {
 	struct cla_tcp_config base;
 
-	struct htab_entrylist *param_htab_elem[CLA_TCP_PARAM_HTAB_SLOT_COUNT];
-	struct htab param_htab;
+	/* Closes pooled connections after CLA_MTCP_POOL_IDLE_TIMEOUT_MS */
+	Task_t pool_task;
+
+	/* Number of parallel outgoing connections per CLA address */
+	size_t stripe_count;
+
+	struct hashmap param_htab;
 	Semaphore_t param_htab_sem;
 };
 
@@ -56,8 +65,42 @@ struct mtcp_contact_parameters {
 	int connect_attempt;
 
 	int socket;
+
+	// Time the connection was put into the pool at the end of a contact
+	uint64_t idle_since_ms;
+
+	// Set iff the connection is part of a striped contact, see below
+	struct mtcp_stripe_group *group;
+	size_t stripe_index;
 };
 
+/*
+ * Multiple outgoing connections ("stripes") to the same CLA address can be
+ * used in parallel. Only the first stripe is registered in the hash table,
+ * it owns the group and terminates the other stripes before it exits.
+ * Bundles for the contact are queued into the group TX queue, from which the
+ * dispatch task spreads them over the TX queues of all connected stripes.
+ */
+struct mtcp_stripe_group {
+	struct mtcp_contact_parameters *stripes[CLA_MTCP_MAX_STRIPES];
+	// Released by every stripe except the first one on termination
+	Semaphore_t stripe_exit_sem[CLA_MTCP_MAX_STRIPES];
+	size_t stripe_count;
+	size_t next_stripe;
+
+	QueueIdentifier_t tx_queue_handle;
+	Semaphore_t tx_queue_sem;
+	struct cla_tx_backlog tx_backlog;
+
+	Task_t dispatch_task;
+	Semaphore_t dispatch_task_sem;
+	// Held by the dispatch task while it hands over bundles to stripes,
+	// terminating stripes wait for it before they are freed
+	Semaphore_t stripe_pin_sem;
+};
+
+static void stripe_group_destroy(struct mtcp_contact_parameters *const param);
+
 
 static enum ud3tn_result handle_established_connection(
 	struct mtcp_contact_parameters *const param)
@@ -114,26 +157,51 @@ static void mtcp_link_management_task(void *p)
 			}
 			LOGF("MTCP: Connected successfully to \"%s\"",
 			     param->cla_sock_addr);
+			// Detect if the connection breaks while it is pooled.
+			if (!CLA_MTCP_CLOSE_AFTER_CONTACT)
+				tcp_enable_keepalive(
+					param->socket,
+					CLA_TCP_KEEPALIVE_IDLE_S,
+					CLA_TCP_KEEPALIVE_INTERVAL_S,
+					CLA_TCP_KEEPALIVE_COUNT
+				);
 			param->connected = true;
 		}
 	} while (param->in_contact);
 	LOGF("MTCP: Terminating contact link manager for \"%s\"",
 	     param->cla_sock_addr);
 	hal_semaphore_take_blocking(param->config->param_htab_sem);
-	htab_remove(&param->config->param_htab, param->cla_sock_addr);
+	if (param->stripe_index == 0)
+		hashmap_remove(&param->config->param_htab, param->cla_sock_addr);
+	else
+		param->group->stripes[param->stripe_index] = NULL;
 	hal_semaphore_release(param->config->param_htab_sem);
+	if (param->stripe_index != 0) {
+		// The dispatch task may still be using the stripe.
+		hal_semaphore_take_blocking(param->group->stripe_pin_sem);
+		hal_semaphore_release(param->group->stripe_pin_sem);
+	}
+	if (param->group && param->stripe_index == 0)
+		stripe_group_destroy(param);
 	mtcp_parser_reset(&param->link.mtcp_parser);
 	free(param->cla_sock_addr);
 
 	Task_t management_task = param->management_task;
+	Semaphore_t exit_sem = NULL;
 
+	if (param->stripe_index != 0)
+		exit_sem = param->group->stripe_exit_sem[param->stripe_index];
 	free(param);
+	// After releasing the semaphore, the group may become invalid.
+	if (exit_sem)
+		hal_semaphore_release(exit_sem);
 	hal_task_delete(management_task);
 }
 
-static void launch_connection_management_task(
+static struct mtcp_contact_parameters *launch_connection_management_task(
 	struct mtcp_config *const mtcp_config,
-	const int sock, const char *cla_addr)
+	const int sock, const char *cla_addr,
+	struct mtcp_stripe_group *const group, const size_t stripe_index)
 {
 	ASSERT(cla_addr);
 	struct mtcp_contact_parameters *contact_params =
@@ -141,11 +209,14 @@ static void launch_connection_management_task(
 
 	if (!contact_params) {
 		LOG("MTCP: Failed to allocate memory!");
-		return;
+		return NULL;
 	}
 
 	contact_params->config = mtcp_config;
 	contact_params->connect_attempt = 0;
+	contact_params->idle_since_ms = 0;
+	contact_params->group = group;
+	contact_params->stripe_index = stripe_index;
 
 	if (sock < 0) {
 		contact_params->cla_sock_addr = cla_get_connect_addr(
@@ -171,17 +242,22 @@ static void launch_connection_management_task(
 
 	mtcp_parser_reset(&contact_params->link.mtcp_parser);
 
-	struct htab_entrylist *htab_entry = NULL;
-
-	htab_entry = htab_add(
-		&mtcp_config->param_htab,
-		contact_params->cla_sock_addr,
-		contact_params
-	);
-	if (!htab_entry) {
-		LOG("MTCP: Error creating htab entry!");
-		goto fail;
+	bool in_htab = false;
+
+	// Only the first stripe of a group is accessible via the hash table.
+	if (stripe_index == 0) {
+		if (hashmap_add(
+			&mtcp_config->param_htab,
+			contact_params->cla_sock_addr,
+			contact_params
+		) != UD3TN_OK) {
+			LOG("MTCP: Error creating htab entry!");
+			goto fail;
+		}
+		in_htab = true;
 	}
+	if (group)
+		group->stripes[stripe_index] = contact_params;
 
 	contact_params->management_task = hal_task_create(
 		mtcp_link_management_task,
@@ -194,9 +270,11 @@ static void launch_connection_management_task(
 
 	if (!contact_params->management_task) {
 		LOG("MTCP: Error creating management task!");
-		if (htab_entry) {
+		if (group)
+			group->stripes[stripe_index] = NULL;
+		if (in_htab) {
 			ASSERT(contact_params->cla_sock_addr);
-			ASSERT(htab_remove(
+			ASSERT(hashmap_remove(
 				&mtcp_config->param_htab,
 				contact_params->cla_sock_addr
 			) == contact_params);
@@ -204,11 +282,395 @@ static void launch_connection_management_task(
 		goto fail;
 	}
 
-	return;
+	return contact_params;
 
 fail:
 	free(contact_params->cla_sock_addr);
 	free(contact_params);
+	return NULL;
+}
+
+/*
+ * STRIPING
+ */
+
+static void signal_transmission_failure(struct mtcp_config *const mtcp_config,
+					struct routed_bundle_list *rbl,
+					const char *cla_addr)
+{
+	if (!rbl)
+		return;
+
+	bundle_processor_reschedule_bundles(
+		mtcp_config->base.base.bundle_agent_interface
+			->bundle_signaling_queue,
+		rbl,
+		cla_addr ? strdup(cla_addr) : NULL
+	);
+}
+
+// Spreads the bundles over the connected stripes so that every stripe has
+// to send about the same amount of bytes. The order is preserved per stripe.
+// Returns the number of bytes removed from the group queue.
+// Share of the contact bitrate proportional to the load of a stripe
+static uint64_t stripe_bitrate(const uint64_t bitrate, uint64_t load,
+			       uint64_t total_load)
+{
+	if (total_load == 0)
+		return bitrate;
+	// Drop precision of the loads instead of overflowing the product.
+	while (bitrate != 0 && load > UINT64_MAX / bitrate) {
+		load >>= 1;
+		total_load >>= 1;
+	}
+	return bitrate * load / total_load;
+}
+
+static size_t dispatch_bundles(struct mtcp_contact_parameters *const primary,
+			     struct cla_contact_tx_task_command *const cmd)
+{
+	struct mtcp_config *const mtcp_config = primary->config;
+	struct mtcp_stripe_group *const group = primary->group;
+	struct routed_bundle_list *heads[CLA_MTCP_MAX_STRIPES];
+	struct routed_bundle_list **tails[CLA_MTCP_MAX_STRIPES];
+	struct cla_link *links[CLA_MTCP_MAX_STRIPES];
+	uint64_t load[CLA_MTCP_MAX_STRIPES];
+	size_t dispatched = 0;
+	size_t i;
+
+	// Pin the stripes so that param_htab_sem is only held for taking the
+	// snapshot and not while waiting for congested stripes.
+	hal_semaphore_take_blocking(group->stripe_pin_sem);
+	hal_semaphore_take_blocking(mtcp_config->param_htab_sem);
+
+	for (i = 0; i < group->stripe_count; i++) {
+		heads[i] = NULL;
+		tails[i] = &heads[i];
+		load[i] = 0;
+		links[i] = (
+			group->stripes[i] != NULL &&
+			group->stripes[i]->connected
+			? &group->stripes[i]->link.base.base
+			: NULL
+		);
+	}
+
+	hal_semaphore_release(mtcp_config->param_htab_sem);
+
+	struct routed_bundle_list *rbl = cmd->bundles;
+	struct routed_bundle_list *failed = NULL;
+	struct routed_bundle_list **failed_tail = &failed;
+
+	while (rbl) {
+		struct routed_bundle_list *const next = rbl->next;
+		size_t best = SIZE_MAX;
+
+		// Start at a different stripe for every batch so that small
+		// batches do not always end up on the same connection.
+		for (size_t k = 0; k < group->stripe_count; k++) {
+			i = (group->next_stripe + k) % group->stripe_count;
+			if (!links[i])
+				continue;
+			if (best == SIZE_MAX || load[i] < load[best])
+				best = i;
+		}
+
+		const size_t size = bundle_get_serialized_size(rbl->data);
+
+		rbl->next = NULL;
+		dispatched += size;
+		if (best == SIZE_MAX) {
+			*failed_tail = rbl;
+			failed_tail = &rbl->next;
+		} else {
+			*tails[best] = rbl;
+			tails[best] = &rbl->next;
+			load[best] += size;
+		}
+		rbl = next;
+	}
+	group->next_stripe = (group->next_stripe + 1) % group->stripe_count;
+
+	uint64_t total_load = 0;
+
+	for (i = 0; i < group->stripe_count; i++)
+		total_load += load[i];
+
+	for (i = 0; i < group->stripe_count; i++) {
+		if (!heads[i])
+			continue;
+
+		struct cla_link *const link = links[i];
+		struct cla_contact_tx_task_command stripe_cmd = {
+			.type = TX_COMMAND_BUNDLES,
+			.bundles = heads[i],
+			.cla_address = strdup(cmd->cla_address),
+			// Every stripe gets a share of the contact bitrate.
+			.bitrate = stripe_bitrate(
+				cmd->bitrate,
+				load[i],
+				total_load
+			),
+		};
+		enum ud3tn_result result = UD3TN_FAIL;
+
+		// The stripe TX task needs the queue semaphore to report its
+		// progress, thus, it must not be held while waiting for space.
+		for (;;) {
+			hal_semaphore_take_blocking(link->tx_queue_sem);
+			// Freed while trying to obtain it
+			if (link->tx_queue_handle)
+				result = hal_queue_try_push_to_back(
+					link->tx_queue_handle,
+					&stripe_cmd,
+					0
+				);
+			if (result == UD3TN_OK)
+				link->tx_backlog.queued_bytes += load[i];
+			hal_semaphore_release(link->tx_queue_sem);
+			if (result == UD3TN_OK || !link->tx_queue_handle ||
+			    !link->active)
+				break;
+			hal_task_delay(CLA_MTCP_DISPATCH_RETRY_INTERVAL_MS);
+		}
+
+		if (result != UD3TN_OK) {
+			*failed_tail = heads[i];
+			failed_tail = tails[i];
+			free(stripe_cmd.cla_address);
+		}
+	}
+
+	hal_semaphore_release(group->stripe_pin_sem);
+
+	signal_transmission_failure(mtcp_config, failed, cmd->cla_address);
+	free(cmd->cla_address);
+
+	return dispatched;
+}
+
+static void mtcp_stripe_dispatch_task(void *p)
+{
+	struct mtcp_contact_parameters *const primary = p;
+	struct mtcp_stripe_group *const group = primary->group;
+	struct cla_contact_tx_task_command cmd;
+
+	for (;;) {
+		if (hal_queue_receive(group->tx_queue_handle,
+				      &cmd, -1) == UD3TN_FAIL)
+			continue;
+		else if (cmd.type == TX_COMMAND_FINALIZE || !cmd.bundles)
+			break;
+
+		const size_t dispatched = dispatch_bundles(primary, &cmd);
+
+		cla_tx_backlog_release(
+			&primary->link.base.base,
+			&group->tx_backlog,
+			group->tx_queue_sem,
+			dispatched,
+			dispatched
+		);
+	}
+
+	Task_t dispatch_task = group->dispatch_task;
+
+	// After releasing the semaphore, the group may become invalid.
+	hal_semaphore_release(group->dispatch_task_sem);
+	hal_task_delete(dispatch_task);
+}
+
+static bool stripe_group_connected(const struct mtcp_stripe_group *group)
+{
+	for (size_t i = 0; i < group->stripe_count; i++) {
+		if (group->stripes[i] && group->stripes[i]->connected)
+			return true;
+	}
+	return false;
+}
+
+static void launch_striped_contact(struct mtcp_config *const mtcp_config,
+				   const char *cla_addr)
+{
+	struct mtcp_stripe_group *const group = malloc(
+		sizeof(struct mtcp_stripe_group)
+	);
+
+	if (!group) {
+		LOG("MTCP: Failed to allocate memory!");
+		return;
+	}
+
+	memset(group, 0, sizeof(struct mtcp_stripe_group));
+	group->stripe_count = mtcp_config->stripe_count;
+	group->tx_backlog.wire_size_permille = 1000;
+	group->tx_queue_handle = hal_queue_create(
+		CONTACT_TX_TASK_QUEUE_LENGTH,
+		sizeof(struct cla_contact_tx_task_command)
+	);
+	if (!group->tx_queue_handle)
+		goto fail_queue;
+	group->tx_queue_sem = hal_semaphore_init_binary();
+	if (!group->tx_queue_sem)
+		goto fail_queue_sem;
+	hal_semaphore_release(group->tx_queue_sem);
+	// NOTE: Locked on creation, released when the dispatch task exits.
+	group->dispatch_task_sem = hal_semaphore_init_binary();
+	if (!group->dispatch_task_sem)
+		goto fail_dispatch_sem;
+	group->stripe_pin_sem = hal_semaphore_init_binary();
+	if (!group->stripe_pin_sem)
+		goto fail_pin_sem;
+	hal_semaphore_release(group->stripe_pin_sem);
+
+	struct mtcp_contact_parameters *const primary =
+		launch_connection_management_task(
+			mtcp_config,
+			-1,
+			cla_addr,
+			group,
+			0
+		);
+
+	if (!primary)
+		goto fail_primary;
+
+	// From now on, the primary stripe is responsible for the group.
+	group->dispatch_task = hal_task_create(
+		mtcp_stripe_dispatch_task,
+		"mtcp_disp_t",
+		CONTACT_TX_TASK_PRIORITY,
+		primary,
+		CONTACT_TX_TASK_STACK_SIZE,
+		(void *)CLA_SPECIFIC_TASK_TAG
+	);
+	if (!group->dispatch_task) {
+		LOG("MTCP: Error creating stripe dispatch task!");
+		hal_semaphore_release(group->dispatch_task_sem);
+	}
+
+	for (size_t i = 1; i < group->stripe_count; i++) {
+		group->stripe_exit_sem[i] = hal_semaphore_init_binary();
+		if (!group->stripe_exit_sem[i])
+			break;
+		if (!launch_connection_management_task(mtcp_config, -1,
+						       cla_addr, group, i)) {
+			hal_semaphore_delete(group->stripe_exit_sem[i]);
+			group->stripe_exit_sem[i] = NULL;
+			break;
+		}
+	}
+
+	return;
+
+fail_primary:
+	hal_semaphore_delete(group->stripe_pin_sem);
+fail_pin_sem:
+	hal_semaphore_delete(group->dispatch_task_sem);
+fail_dispatch_sem:
+	hal_semaphore_delete(group->tx_queue_sem);
+fail_queue_sem:
+	hal_queue_delete(group->tx_queue_handle);
+fail_queue:
+	LOG("MTCP: Failed to create stripe group!");
+	free(group);
+}
+
+// Called by the primary stripe after it was removed from the hash table.
+static void stripe_group_destroy(struct mtcp_contact_parameters *const param)
+{
+	struct mtcp_config *const mtcp_config = param->config;
+	struct mtcp_stripe_group *const group = param->group;
+	size_t i;
+
+	// Stop the dispatch task - nobody can obtain the queue anymore, but
+	// the contact manager may still hold the semaphore.
+	hal_semaphore_take_blocking(group->tx_queue_sem);
+	if (group->dispatch_task)
+		cla_contact_tx_task_request_exit(group->tx_queue_handle);
+	hal_semaphore_release(group->tx_queue_sem);
+	hal_semaphore_take_blocking(group->dispatch_task_sem);
+
+	// Bundles which have not been dispatched are handed back to the BP.
+	struct cla_contact_tx_task_command cmd;
+
+	while (hal_queue_receive(group->tx_queue_handle, &cmd, 0) == UD3TN_OK) {
+		if (cmd.type == TX_COMMAND_BUNDLES) {
+			signal_transmission_failure(mtcp_config, cmd.bundles,
+						    cmd.cla_address);
+			free(cmd.cla_address);
+		}
+	}
+
+	// Terminate the other stripes and wait for their management tasks.
+	hal_semaphore_take_blocking(mtcp_config->param_htab_sem);
+	for (i = 1; i < group->stripe_count; i++) {
+		struct mtcp_contact_parameters *const stripe =
+			group->stripes[i];
+
+		if (!stripe)
+			continue;
+		stripe->in_contact = false;
+		if (stripe->socket >= 0) {
+			struct cla_link *const link = &stripe->link.base.base;
+
+			link->config->vtable->cla_disconnect_handler(link);
+		}
+	}
+	hal_semaphore_release(mtcp_config->param_htab_sem);
+
+	for (i = 1; i < group->stripe_count; i++) {
+		if (!group->stripe_exit_sem[i])
+			continue;
+		hal_semaphore_take_blocking(group->stripe_exit_sem[i]);
+		hal_semaphore_delete(group->stripe_exit_sem[i]);
+	}
+
+	hal_semaphore_delete(group->stripe_pin_sem);
+	hal_semaphore_delete(group->dispatch_task_sem);
+	hal_semaphore_delete(group->tx_queue_sem);
+	hal_queue_delete(group->tx_queue_handle);
+	free(group);
+	param->group = NULL;
+}
+
+/*
+ * POOL
+ */
+
+static void mtcp_pool_task(void *p)
+{
+	struct mtcp_config *const mtcp_config = p;
+
+	for (;;) {
+		hal_task_delay(CLA_MTCP_POOL_CHECK_INTERVAL_MS);
+
+		const uint64_t now = hal_time_get_timestamp_ms();
+
+		hal_semaphore_take_blocking(mtcp_config->param_htab_sem);
+
+		size_t iter = 0;
+		void *value;
+
+		while (hashmap_iterate(&mtcp_config->param_htab, &iter,
+				       NULL, &value)) {
+			struct mtcp_contact_parameters *const param = value;
+			struct cla_link *const link = &param->link.base.base;
+
+			// Incoming connections are managed by the peer.
+			if (!param->is_outgoing || param->in_contact ||
+					!param->connected || !link->active)
+				continue;
+			if (now - param->idle_since_ms <
+					CLA_MTCP_POOL_IDLE_TIMEOUT_MS)
+				continue;
+
+			LOGF("MTCP: Closing idle pooled connection with \"%s\"",
+			     param->cla_sock_addr);
+			link->config->vtable->cla_disconnect_handler(link);
+		}
+		hal_semaphore_release(mtcp_config->param_htab_sem);
+	}
 }
 
 static void mtcp_listener_task(void *param)
@@ -230,7 +692,9 @@ static void mtcp_listener_task(void *param)
 		launch_connection_management_task(
 			mtcp_config,
 			sock,
-			cla_addr
+			cla_addr,
+			NULL,
+			0
 		);
 		hal_semaphore_release(mtcp_config->param_htab_sem);
 		free(cla_addr);
@@ -255,6 +719,21 @@ static enum ud3tn_result mtcp_launch(struct cla_config *const config)
 	if (!mtcp_config->base.listen_task)
 		return UD3TN_FAIL;
 
+	if (CLA_MTCP_CLOSE_AFTER_CONTACT || !CLA_MTCP_POOL_IDLE_TIMEOUT_MS)
+		return UD3TN_OK;
+
+	mtcp_config->pool_task = hal_task_create(
+		mtcp_pool_task,
+		"mtcp_pool_t",
+		CONTACT_LISTEN_TASK_PRIORITY,
+		config,
+		CONTACT_LISTEN_TASK_STACK_SIZE,
+		(void *)CLA_SPECIFIC_TASK_TAG
+	);
+
+	if (!mtcp_config->pool_task)
+		return UD3TN_FAIL;
+
 	return UD3TN_OK;
 }
 
@@ -343,7 +822,7 @@ static struct mtcp_contact_parameters *get_contact_parameters(
 		(struct mtcp_config *)config;
 	char *const cla_sock_addr = cla_get_connect_addr(cla_addr, "mtcp");
 
-	struct mtcp_contact_parameters *param = htab_get(
+	struct mtcp_contact_parameters *param = hashmap_get(
 		&mtcp_config->param_htab,
 		cla_sock_addr
 	);
@@ -363,6 +842,21 @@ static struct cla_tx_queue mtcp_get_tx_queue(
 		cla_addr
 	);
 
+	// The dispatch task spreads the bundles over all stripes.
+	if (param && param->group && param->group->dispatch_task &&
+			stripe_group_connected(param->group)) {
+		struct mtcp_stripe_group *const group = param->group;
+
+		hal_semaphore_take_blocking(group->tx_queue_sem);
+		hal_semaphore_release(mtcp_config->param_htab_sem);
+
+		return (struct cla_tx_queue){
+			.tx_queue_handle = group->tx_queue_handle,
+			.tx_queue_sem = group->tx_queue_sem,
+			.tx_backlog = &group->tx_backlog,
+		};
+	}
+
 	if (param && param->connected) {
 		struct cla_link *const cla_link = &param->link.base.base;
 
@@ -371,16 +865,17 @@ static struct cla_tx_queue mtcp_get_tx_queue(
 
 		// Freed while trying to obtain it
 		if (!cla_link->tx_queue_handle)
-			return (struct cla_tx_queue){ NULL, NULL };
+			return (struct cla_tx_queue){ NULL, NULL, NULL };
 
 		return (struct cla_tx_queue){
 			.tx_queue_handle = cla_link->tx_queue_handle,
 			.tx_queue_sem = cla_link->tx_queue_sem,
+			.tx_backlog = &cla_link->tx_backlog,
 		};
 	}
 
 	hal_semaphore_release(mtcp_config->param_htab_sem);
-	return (struct cla_tx_queue){ NULL, NULL };
+	return (struct cla_tx_queue){ NULL, NULL, NULL };
 }
 
 static enum ud3tn_result mtcp_start_scheduled_contact(
@@ -396,14 +891,21 @@ static enum ud3tn_result mtcp_start_scheduled_contact(
 	);
 
 	if (param) {
-		LOGF("MTCP: Associating open connection with \"%s\" to new contact",
+		LOGF("MTCP: Associating pooled connection with \"%s\" to new contact",
 		     cla_addr);
 		param->in_contact = true;
+		for (size_t i = 1; param->group &&
+				i < param->group->stripe_count; i++) {
+			if (param->group->stripes[i])
+				param->group->stripes[i]->in_contact = true;
+		}
 
 		const struct bundle_agent_interface *bai =
 			config->bundle_agent_interface;
 
-		if (param->connected) {
+		if (param->connected ||
+				(param->group &&
+				 stripe_group_connected(param->group))) {
 			bundle_processor_inform(
 				bai->bundle_signaling_queue,
 				NULL,
@@ -421,7 +923,11 @@ static enum ud3tn_result mtcp_start_scheduled_contact(
 		return UD3TN_OK;
 	}
 
-	launch_connection_management_task(mtcp_config, -1, cla_addr);
+	if (mtcp_config->stripe_count > 1)
+		launch_striped_contact(mtcp_config, cla_addr);
+	else
+		launch_connection_management_task(mtcp_config, -1, cla_addr,
+						  NULL, 0);
 	hal_semaphore_release(mtcp_config->param_htab_sem);
 
 	return UD3TN_OK;
@@ -440,16 +946,34 @@ static enum ud3tn_result mtcp_end_scheduled_contact(
 	);
 
 	if (param && param->in_contact) {
-		struct cla_link *const link = &param->link.base.base;
+		const size_t stripe_count = (
+			param->group ? param->group->stripe_count : 1
+		);
 
-		param->in_contact = false;
-		if (CLA_MTCP_CLOSE_AFTER_CONTACT && param->socket >= 0) {
-			LOGF("MTCP: Terminating connection with \"%s\"",
-			     cla_addr);
-			link->config->vtable->cla_disconnect_handler(link);
-		} else {
-			LOGF("MTCP: Marking open connection with \"%s\" as opportunistic",
-			     cla_addr);
+		for (size_t i = 0; i < stripe_count; i++) {
+			struct mtcp_contact_parameters *const stripe = (
+				param->group ? param->group->stripes[i] : param
+			);
+
+			if (!stripe)
+				continue;
+
+			struct cla_link *const link = &stripe->link.base.base;
+
+			stripe->in_contact = false;
+			if (CLA_MTCP_CLOSE_AFTER_CONTACT &&
+					stripe->socket >= 0) {
+				LOGF("MTCP: Terminating connection with \"%s\"",
+				     cla_addr);
+				link->config->vtable->cla_disconnect_handler(
+					link
+				);
+			} else {
+				LOGF("MTCP: Keeping open connection with \"%s\" in pool",
+				     cla_addr);
+				stripe->idle_since_ms =
+					hal_time_get_timestamp_ms();
+			}
 		}
 	}
 
@@ -522,7 +1046,7 @@ const struct cla_vtable mtcp_vtable = {
 
 static enum ud3tn_result mtcp_init(
 	struct mtcp_config *config,
-	const char *node, const char *service,
+	const char *node, const char *service, const size_t stripe_count,
 	const struct bundle_agent_interface *bundle_agent_interface)
 {
 	/* Initialize base_config */
@@ -532,9 +1056,12 @@ static enum ud3tn_result mtcp_init(
 
 	/* set base_config vtable */
 	config->base.base.vtable = &mtcp_vtable;
+	config->pool_task = NULL;
+	config->stripe_count = stripe_count;
 
-	htab_init(&config->param_htab, CLA_TCP_PARAM_HTAB_SLOT_COUNT,
-		  config->param_htab_elem);
+	if (hashmap_init(&config->param_htab, CLA_TCP_PARAM_HTAB_SLOT_COUNT,
+			 true) != UD3TN_OK)
+		return UD3TN_FAIL;
 
 	config->param_htab_sem = hal_semaphore_init_binary();
 	hal_semaphore_release(config->param_htab_sem);
@@ -551,11 +1078,27 @@ struct cla_config *mtcp_create(
 	const char *const options[], const size_t option_count,
 	const struct bundle_agent_interface *bundle_agent_interface)
 {
-	if (option_count != 2) {
-		LOG("MTCP: Options format has to be: <IP>,<PORT>");
+	unsigned long stripe_count = 1;
+
+	if (option_count < 2 || option_count > 3) {
+		LOG("MTCP: Options format has to be: <IP>,<PORT>[,<STRIPES>]");
 		return NULL;
 	}
 
+	if (option_count > 2) {
+		char *end;
+
+		errno = 0;
+		stripe_count = strtoul(options[2], &end, 10);
+		if (errno == ERANGE || end == options[2] || *end != 0 ||
+				stripe_count == 0 ||
+				stripe_count > CLA_MTCP_MAX_STRIPES) {
+			LOGF("MTCP: Invalid stripe count \"%s\", must be 1-%d",
+			     options[2], CLA_MTCP_MAX_STRIPES);
+			return NULL;
+		}
+	}
+
 	struct mtcp_config *config = malloc(sizeof(struct mtcp_config));
 
 	if (!config) {
@@ -563,7 +1106,7 @@ struct cla_config *mtcp_create(
 		return NULL;
 	}
 
-	if (mtcp_init(config, options[0], options[1],
+	if (mtcp_init(config, options[0], options[1], stripe_count,
 		      bundle_agent_interface) != UD3TN_OK) {
 		free(config);
 		LOG("MTCP: Initialization failed!");
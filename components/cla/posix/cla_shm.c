@@ -0,0 +1,864 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#define _GNU_SOURCE // for syscall()
+
+/*
+ * Shared-memory CLA for uD3TN instances running on the same host.
+ *
+ * Every instance creates a POSIX shared memory segment ("/ud3tn-shm-<NAME>")
+ * for the bundles it receives. The segment contains CLA_SHM_MAX_PEERS
+ * single-producer/single-consumer byte rings. A sending instance claims a
+ * free ring in the segment of the peer and writes the serialized bundles into
+ * it, framed like in MTCP, so the RX side can reuse the MTCP parser. Waiting
+ * for data or free space is done via futexes on the shared sequence counters.
+ */
+
+#include "cla/cla.h"
+#include "cla/cla_contact_tx_task.h"
+#include "cla/mtcp_proto.h"
+#include "cla/posix/cla_mtcp.h"
+#include "cla/posix/cla_shm.h"
+
+#include "platform/hal_config.h"
+#include "platform/hal_io.h"
+#include "platform/hal_queue.h"
+#include "platform/hal_semaphore.h"
+#include "platform/hal_task.h"
+
+#include "ud3tn/bundle_processor.h"
+#include "ud3tn/common.h"
+#include "ud3tn/config.h"
+#include "ud3tn/result.h"
+#include "ud3tn/simplehtab.h"
+#include "ud3tn/task_tags.h"
+
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SHM_SEGMENT_MAGIC 0x75443354 // "uD3T"
+#define SHM_SEGMENT_PREFIX "/ud3tn-shm-"
+
+enum shm_ring_state {
+	SHM_RING_FREE,
+	SHM_RING_RESERVED, // being set up by the producer
+	SHM_RING_CLAIMED,  // waiting for the consumer to pick it up
+	SHM_RING_ACTIVE,
+	SHM_RING_CLOSED,   // no more data will be written by the producer
+	// No more data will be read by the consumer, the producer frees the
+	// ring as soon as it has stopped writing.
+	SHM_RING_CONSUMER_CLOSED,
+};
+
+struct shm_ring {
+	_Atomic uint32_t state;
+	_Atomic int32_t producer_pid;
+	char producer_name[CLA_SHM_MAX_NAME_LENGTH + 1];
+
+	// Written by the producer
+	_Alignas(64) _Atomic uint64_t head;
+	_Atomic uint32_t data_seq;
+	_Atomic uint32_t producer_waiting;
+
+	// Written by the consumer
+	_Alignas(64) _Atomic uint64_t tail;
+	_Atomic uint32_t space_seq;
+	_Atomic uint32_t consumer_waiting;
+
+	_Alignas(64) uint8_t data[CLA_SHM_RING_SIZE];
+};
+
+struct shm_segment {
+	uint32_t magic;
+	// Set to zero if the segment was replaced by that of a new instance
+	_Atomic int32_t consumer_pid;
+	// Incremented whenever a ring has been claimed by a producer
+	_Atomic uint32_t doorbell;
+
+	struct shm_ring rings[CLA_SHM_MAX_PEERS];
+};
+
+struct shm_config {
+	struct cla_config base;
+
+	char *segment_name;
+	struct shm_segment *segment;
+
+	Task_t listen_task;
+
+	// Outgoing links, keyed by the name of the peer
+	struct htab_entrylist *param_htab_elem[CLA_SHM_PARAM_HTAB_SLOT_COUNT];
+	struct htab param_htab;
+	Semaphore_t param_htab_sem;
+};
+
+struct shm_link {
+	// Allows to reuse the MTCP parser and framing.
+	// IMPORTANT: The link is only initialized iff established == true
+	struct mtcp_link base;
+
+	struct shm_config *config;
+
+	Task_t management_task;
+
+	char *peer_name;
+	struct shm_ring *ring;
+	bool is_producer;
+	bool established;
+
+	// Only used by producers: the mapped segment of the peer and the PID
+	// of its consumer at the time of mapping it
+	struct shm_segment *peer_segment;
+	int32_t consumer_pid;
+};
+
+/*
+ * RING
+ */
+
+static void futex_wait(_Atomic uint32_t *addr, const uint32_t expected)
+{
+	const struct timespec timeout = {
+		.tv_sec = CLA_SHM_WAIT_TIMEOUT_MS / 1000,
+		.tv_nsec = (CLA_SHM_WAIT_TIMEOUT_MS % 1000) * 1000000L,
+	};
+
+	syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAIT, expected,
+		&timeout, NULL, 0);
+}
+
+static void futex_wake(_Atomic uint32_t *addr)
+{
+	syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAKE, INT_MAX,
+		NULL, NULL, 0);
+}
+
+static bool process_alive(const int32_t pid)
+{
+	return pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+// Publishes a new counter value and wakes the other side only if it waits.
+static void ring_publish(_Atomic uint64_t *counter, const uint64_t value,
+			 _Atomic uint32_t *seq, _Atomic uint32_t *waiting)
+{
+	atomic_store(counter, value);
+	atomic_fetch_add(seq, 1);
+	if (atomic_load(waiting))
+		futex_wake(seq);
+}
+
+// Waits until the counter changes or the timeout expires.
+static void ring_wait(_Atomic uint64_t *counter, const uint64_t value,
+		      _Atomic uint32_t *seq, _Atomic uint32_t *waiting)
+{
+	const uint32_t cur_seq = atomic_load(seq);
+
+	atomic_store(waiting, 1);
+	if (atomic_load(counter) == value)
+		futex_wait(seq, cur_seq);
+	atomic_store(waiting, 0);
+}
+
+// Resets a ring nobody uses anymore and hands it out to new producers.
+static void ring_release(struct shm_ring *const ring)
+{
+	atomic_store(&ring->head, 0);
+	atomic_store(&ring->tail, 0);
+	atomic_store(&ring->producer_waiting, 0);
+	atomic_store(&ring->consumer_waiting, 0);
+	atomic_store(&ring->state, SHM_RING_FREE);
+}
+
+// Checked before every write, so no data is written to a ring the consumer
+// has left or that belongs to the segment of a terminated instance.
+static bool ring_consumer_present(const struct shm_link *const link)
+{
+	return (
+		atomic_load(&link->ring->state) != SHM_RING_CONSUMER_CLOSED &&
+		atomic_load(&link->peer_segment->consumer_pid) ==
+			link->consumer_pid
+	);
+}
+
+static enum ud3tn_result ring_write(struct shm_link *const link,
+				    const uint8_t *data, size_t length)
+{
+	struct shm_ring *const ring = link->ring;
+	uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+	while (length) {
+		if (!ring_consumer_present(link))
+			return UD3TN_FAIL;
+
+		const uint64_t tail = atomic_load(&ring->tail);
+		const size_t space = CLA_SHM_RING_SIZE - (head - tail);
+
+		if (!space) {
+			if (!link->base.base.base.active ||
+					!process_alive(link->consumer_pid))
+				return UD3TN_FAIL;
+			ring_wait(&ring->tail, tail, &ring->space_seq,
+				  &ring->producer_waiting);
+			continue;
+		}
+
+		const size_t chunk = MIN(space, length);
+		const size_t offset = head % CLA_SHM_RING_SIZE;
+		const size_t first = MIN(chunk, CLA_SHM_RING_SIZE - offset);
+
+		memcpy(&ring->data[offset], data, first);
+		memcpy(&ring->data[0], data + first, chunk - first);
+		head += chunk;
+		data += chunk;
+		length -= chunk;
+		ring_publish(&ring->head, head, &ring->data_seq,
+			     &ring->consumer_waiting);
+	}
+
+	return UD3TN_OK;
+}
+
+// Called by the producer after it has stopped writing.
+static void ring_close_producer(struct shm_ring *const ring)
+{
+	uint32_t state = SHM_RING_ACTIVE;
+
+	// The consumer reads all remaining data before releasing the ring.
+	if (atomic_compare_exchange_strong(&ring->state, &state,
+					   SHM_RING_CLOSED)) {
+		ring_publish(&ring->head, atomic_load(&ring->head),
+			     &ring->data_seq, &ring->consumer_waiting);
+		return;
+	}
+
+	// The consumer has left the ring, or never picked it up.
+	if (state == SHM_RING_CONSUMER_CLOSED ||
+	    (state == SHM_RING_CLAIMED &&
+	     atomic_compare_exchange_strong(&ring->state, &state,
+					    SHM_RING_RESERVED)))
+		ring_release(ring);
+	else if (state == SHM_RING_CLAIMED)
+		ring_close_producer(ring); // picked up meanwhile
+}
+
+// Called by the consumer after it has stopped reading.
+static void ring_close_consumer(struct shm_ring *const ring)
+{
+	uint32_t state = SHM_RING_ACTIVE;
+
+	if (!atomic_compare_exchange_strong(&ring->state, &state,
+					    SHM_RING_CONSUMER_CLOSED)) {
+		// The producer is done with the ring.
+		ring_release(ring);
+		return;
+	}
+
+	// Let a waiting producer notice it, it releases the ring then. If it
+	// has terminated, nobody else is left to do so.
+	ring_publish(&ring->tail, atomic_load(&ring->tail), &ring->space_seq,
+		     &ring->producer_waiting);
+	state = SHM_RING_CONSUMER_CLOSED;
+	if (!process_alive(atomic_load(&ring->producer_pid)) &&
+	    atomic_compare_exchange_strong(&ring->state, &state,
+					   SHM_RING_RESERVED))
+		ring_release(ring);
+}
+
+/*
+ * MGMT
+ */
+
+static char *get_segment_name(const char *name)
+{
+	const size_t len = strlen(SHM_SEGMENT_PREFIX) + strlen(name) + 1;
+	char *const segment_name = malloc(len);
+
+	if (segment_name)
+		snprintf(segment_name, len, SHM_SEGMENT_PREFIX "%s", name);
+	return segment_name;
+}
+
+static struct shm_segment *map_segment(const char *segment_name,
+				       const bool create)
+{
+	const int fd = shm_open(
+		segment_name,
+		create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR,
+		0600
+	);
+
+	if (fd < 0) {
+		LOGF("SHM: shm_open(\"%s\") failed: %s",
+		     segment_name, strerror(errno));
+		return NULL;
+	}
+
+	if (create && ftruncate(fd, sizeof(struct shm_segment)) < 0) {
+		LOGF("SHM: ftruncate() failed: %s", strerror(errno));
+		close(fd);
+		return NULL;
+	}
+
+	struct stat st;
+
+	if (!create && (fstat(fd, &st) < 0 ||
+			(size_t)st.st_size != sizeof(struct shm_segment))) {
+		LOGF("SHM: Segment \"%s\" has an unexpected size",
+		     segment_name);
+		close(fd);
+		return NULL;
+	}
+
+	struct shm_segment *const segment = mmap(
+		NULL,
+		sizeof(struct shm_segment),
+		PROT_READ | PROT_WRITE,
+		MAP_SHARED,
+		fd,
+		0
+	);
+
+	// The mapping stays valid after closing the descriptor.
+	close(fd);
+	if (segment == MAP_FAILED) {
+		LOGF("SHM: mmap() failed: %s", strerror(errno));
+		return NULL;
+	}
+
+	if (!create && segment->magic != SHM_SEGMENT_MAGIC) {
+		LOGF("SHM: Segment \"%s\" is not valid", segment_name);
+		munmap(segment, sizeof(struct shm_segment));
+		return NULL;
+	}
+
+	return segment;
+}
+
+// Lets producers still writing to the segment of a previous instance notice
+// that nobody will read their data.
+static void orphan_segment(const char *segment_name)
+{
+	const int fd = shm_open(segment_name, O_RDWR, 0600);
+	struct stat st;
+
+	if (fd < 0)
+		return;
+	if (fstat(fd, &st) < 0 ||
+			(size_t)st.st_size != sizeof(struct shm_segment)) {
+		close(fd);
+		return;
+	}
+
+	struct shm_segment *const segment = mmap(
+		NULL,
+		sizeof(struct shm_segment),
+		PROT_READ | PROT_WRITE,
+		MAP_SHARED,
+		fd,
+		0
+	);
+
+	close(fd);
+	if (segment == MAP_FAILED)
+		return;
+	if (segment->magic == SHM_SEGMENT_MAGIC)
+		atomic_store(&segment->consumer_pid, 0);
+	munmap(segment, sizeof(struct shm_segment));
+}
+
+static struct shm_ring *claim_ring(struct shm_segment *const segment,
+				   const char *const own_name)
+{
+	for (size_t i = 0; i < CLA_SHM_MAX_PEERS; i++) {
+		struct shm_ring *const ring = &segment->rings[i];
+		uint32_t expected = SHM_RING_FREE;
+
+		if (!atomic_compare_exchange_strong(&ring->state, &expected,
+						    SHM_RING_RESERVED))
+			continue;
+
+		atomic_store(&ring->producer_pid, getpid());
+		strncpy(ring->producer_name, own_name, CLA_SHM_MAX_NAME_LENGTH);
+		ring->producer_name[CLA_SHM_MAX_NAME_LENGTH] = '\0';
+		atomic_store(&ring->state, SHM_RING_CLAIMED);
+
+		atomic_fetch_add(&segment->doorbell, 1);
+		futex_wake(&segment->doorbell);
+		return ring;
+	}
+
+	return NULL;
+}
+
+static void shm_link_management_task(void *p)
+{
+	struct shm_link *const link = p;
+	struct shm_config *const shm_config = link->config;
+
+	if (link->is_producer) {
+		char *const segment_name = get_segment_name(link->peer_name);
+
+		if (segment_name)
+			link->peer_segment = map_segment(segment_name, false);
+		free(segment_name);
+		if (link->peer_segment) {
+			link->consumer_pid = atomic_load(
+				&link->peer_segment->consumer_pid
+			);
+			if (process_alive(link->consumer_pid))
+				link->ring = claim_ring(
+					link->peer_segment,
+					// Own name, derived from the segment
+					&shm_config->segment_name[
+						strlen(SHM_SEGMENT_PREFIX)
+					]
+				);
+			else
+				LOGF("SHM: Instance \"%s\" is not running",
+				     link->peer_name);
+		}
+		if (process_alive(link->consumer_pid) && !link->ring)
+			LOGF("SHM: No free ring available at \"%s\"",
+			     link->peer_name);
+	}
+
+	if (link->ring && cla_link_init(&link->base.base.base,
+					&shm_config->base, link->peer_name,
+					!link->is_producer,
+					link->is_producer) == UD3TN_OK) {
+		link->established = true;
+		cla_link_wait_cleanup(&link->base.base.base);
+	} else if (link->ring) {
+		LOG("SHM: Error initializing CLA link!");
+	}
+
+	LOGF("SHM: Terminating link %s \"%s\"",
+	     link->is_producer ? "to" : "from", link->peer_name);
+
+	if (link->is_producer) {
+		hal_semaphore_take_blocking(shm_config->param_htab_sem);
+		htab_remove(&shm_config->param_htab, link->peer_name);
+		hal_semaphore_release(shm_config->param_htab_sem);
+		if (link->ring)
+			ring_close_producer(link->ring);
+		if (link->peer_segment)
+			munmap(link->peer_segment, sizeof(struct shm_segment));
+	} else {
+		ring_close_consumer(link->ring);
+	}
+
+	mtcp_parser_reset(&link->base.mtcp_parser);
+	free(link->peer_name);
+
+	Task_t management_task = link->management_task;
+
+	free(link);
+	hal_task_delete(management_task);
+}
+
+static struct shm_link *launch_link_management_task(
+	struct shm_config *const shm_config, const char *peer_name,
+	struct shm_ring *const ring)
+{
+	struct shm_link *const link = malloc(sizeof(struct shm_link));
+
+	if (!link) {
+		LOG("SHM: Failed to allocate memory!");
+		return NULL;
+	}
+
+	link->config = shm_config;
+	link->ring = ring;
+	link->is_producer = (ring == NULL);
+	link->established = false;
+	link->peer_segment = NULL;
+	link->consumer_pid = 0;
+	link->peer_name = strdup(peer_name);
+	if (!link->peer_name) {
+		LOG("SHM: Failed to copy peer name!");
+		free(link);
+		return NULL;
+	}
+	mtcp_parser_reset(&link->base.mtcp_parser);
+	// The link has no socket, but the MTCP code expects the TCP link.
+	link->base.base.connection_socket = -1;
+
+	if (link->is_producer && !htab_add(&shm_config->param_htab,
+					   link->peer_name, link)) {
+		LOG("SHM: Error creating htab entry!");
+		goto fail;
+	}
+
+	link->management_task = hal_task_create(
+		shm_link_management_task,
+		"shm_mgmt_t",
+		CONTACT_MANAGEMENT_TASK_PRIORITY,
+		link,
+		CONTACT_MANAGEMENT_TASK_STACK_SIZE,
+		(void *)CLA_SPECIFIC_TASK_TAG
+	);
+
+	if (!link->management_task) {
+		LOG("SHM: Error creating management task!");
+		if (link->is_producer)
+			htab_remove(&shm_config->param_htab, link->peer_name);
+		goto fail;
+	}
+
+	return link;
+
+fail:
+	free(link->peer_name);
+	free(link);
+	return NULL;
+}
+
+static void shm_listener_task(void *param)
+{
+	struct shm_config *const shm_config = param;
+	struct shm_segment *const segment = shm_config->segment;
+
+	for (;;) {
+		const uint32_t doorbell = atomic_load(&segment->doorbell);
+
+		for (size_t i = 0; i < CLA_SHM_MAX_PEERS; i++) {
+			struct shm_ring *const ring = &segment->rings[i];
+			uint32_t expected = SHM_RING_CLAIMED;
+
+			if (!atomic_compare_exchange_strong(&ring->state,
+							    &expected,
+							    SHM_RING_ACTIVE))
+				continue;
+
+			ring->producer_name[CLA_SHM_MAX_NAME_LENGTH] = '\0';
+			LOGF("SHM: New link from \"%s\" (pid %d)",
+			     ring->producer_name,
+			     atomic_load(&ring->producer_pid));
+			if (!launch_link_management_task(shm_config,
+							 ring->producer_name,
+							 ring))
+				ring_close_consumer(ring);
+		}
+
+		futex_wait(&segment->doorbell, doorbell);
+	}
+}
+
+/*
+ * RX
+ */
+
+static enum ud3tn_result shm_read(struct cla_link *cla_link,
+				  uint8_t *buffer, size_t length,
+				  size_t *bytes_read)
+{
+	struct shm_link *const link = (struct shm_link *)cla_link;
+	struct shm_ring *const ring = link->ring;
+	const uint64_t tail = atomic_load_explicit(&ring->tail,
+						   memory_order_relaxed);
+	uint64_t head;
+
+	while ((head = atomic_load(&ring->head)) == tail) {
+		if (!cla_link->active)
+			return UD3TN_FAIL;
+		if (atomic_load(&ring->state) == SHM_RING_CLOSED ||
+				!process_alive(atomic_load(&ring->producer_pid))) {
+			LOGF("SHM: Link from \"%s\" was closed",
+			     link->peer_name);
+			cla_link->config->vtable->cla_disconnect_handler(
+				cla_link
+			);
+			return UD3TN_FAIL;
+		}
+		ring_wait(&ring->head, head, &ring->data_seq,
+			  &ring->consumer_waiting);
+	}
+
+	const size_t chunk = MIN(head - tail, length);
+	const size_t offset = tail % CLA_SHM_RING_SIZE;
+	const size_t first = MIN(chunk, CLA_SHM_RING_SIZE - offset);
+
+	memcpy(buffer, &ring->data[offset], first);
+	memcpy(buffer + first, &ring->data[0], chunk - first);
+	ring_publish(&ring->tail, tail + chunk, &ring->space_seq,
+		     &ring->producer_waiting);
+
+	if (bytes_read)
+		*bytes_read = chunk;
+	return UD3TN_OK;
+}
+
+/*
+ * API
+ */
+
+static enum ud3tn_result shm_launch(struct cla_config *const config)
+{
+	struct shm_config *const shm_config = (struct shm_config *)config;
+
+	shm_config->listen_task = hal_task_create(
+		shm_listener_task,
+		"shm_listen_t",
+		CONTACT_LISTEN_TASK_PRIORITY,
+		config,
+		CONTACT_LISTEN_TASK_STACK_SIZE,
+		(void *)CLA_SPECIFIC_TASK_TAG
+	);
+
+	if (!shm_config->listen_task)
+		return UD3TN_FAIL;
+
+	return UD3TN_OK;
+}
+
+static const char *shm_name_get(void)
+{
+	return "shm";
+}
+
+static struct shm_link *get_link(struct cla_config *config,
+				 const char *cla_addr)
+{
+	struct shm_config *const shm_config = (struct shm_config *)config;
+	char *const peer_name = cla_get_connect_addr(cla_addr, "shm");
+
+	if (!peer_name)
+		return NULL;
+
+	struct shm_link *const link = htab_get(
+		&shm_config->param_htab,
+		peer_name
+	);
+
+	free(peer_name);
+	return link;
+}
+
+static struct cla_tx_queue shm_get_tx_queue(
+	struct cla_config *config, const char *eid, const char *cla_addr)
+{
+	(void)eid;
+	struct shm_config *const shm_config = (struct shm_config *)config;
+
+	hal_semaphore_take_blocking(shm_config->param_htab_sem);
+	struct shm_link *const link = get_link(config, cla_addr);
+
+	if (link && link->established) {
+		struct cla_link *const cla_link = &link->base.base.base;
+
+		hal_semaphore_take_blocking(cla_link->tx_queue_sem);
+		hal_semaphore_release(shm_config->param_htab_sem);
+
+		// Freed while trying to obtain it
+		if (!cla_link->tx_queue_handle)
+			return (struct cla_tx_queue){ NULL, NULL, NULL };
+
+		return (struct cla_tx_queue){
+			.tx_queue_handle = cla_link->tx_queue_handle,
+			.tx_queue_sem = cla_link->tx_queue_sem,
+			.tx_backlog = &cla_link->tx_backlog,
+		};
+	}
+
+	hal_semaphore_release(shm_config->param_htab_sem);
+	return (struct cla_tx_queue){ NULL, NULL, NULL };
+}
+
+static enum ud3tn_result shm_start_scheduled_contact(
+	struct cla_config *config, const char *eid, const char *cla_addr)
+{
+	(void)eid;
+	struct shm_config *const shm_config = (struct shm_config *)config;
+
+	hal_semaphore_take_blocking(shm_config->param_htab_sem);
+	if (get_link(config, cla_addr)) {
+		LOGF("SHM: Link to \"%s\" already exists", cla_addr);
+		hal_semaphore_release(shm_config->param_htab_sem);
+		return UD3TN_OK;
+	}
+
+	char *const peer_name = cla_get_connect_addr(cla_addr, "shm");
+
+	if (peer_name && peer_name[0] != '\0')
+		launch_link_management_task(shm_config, peer_name, NULL);
+	else
+		LOGF("SHM: Invalid CLA address \"%s\"", cla_addr);
+	free(peer_name);
+	hal_semaphore_release(shm_config->param_htab_sem);
+
+	return UD3TN_OK;
+}
+
+static enum ud3tn_result shm_end_scheduled_contact(
+	struct cla_config *config, const char *eid, const char *cla_addr)
+{
+	(void)eid;
+	struct shm_config *const shm_config = (struct shm_config *)config;
+
+	hal_semaphore_take_blocking(shm_config->param_htab_sem);
+	struct shm_link *const link = get_link(config, cla_addr);
+
+	if (link && link->established && link->base.base.base.active) {
+		struct cla_link *const cla_link = &link->base.base.base;
+
+		LOGF("SHM: Closing link to \"%s\"", cla_addr);
+		cla_link->config->vtable->cla_disconnect_handler(cla_link);
+	}
+
+	hal_semaphore_release(shm_config->param_htab_sem);
+
+	return UD3TN_OK;
+}
+
+/*
+ * TX
+ */
+
+static void shm_begin_packet(struct cla_link *cla_link, size_t length,
+			     char *cla_addr)
+{
+	struct shm_link *const link = (struct shm_link *)cla_link;
+	(void)cla_addr;
+
+	// A previous operation may have canceled the sending process.
+	if (!cla_link->active)
+		return;
+
+	const size_t BUFFER_SIZE = 9; // max. for uint64_t
+	uint8_t buffer[BUFFER_SIZE];
+
+	const size_t hdr_len = mtcp_encode_header(buffer, BUFFER_SIZE, length);
+
+	// A crashed consumer does not close the ring, check it per bundle.
+	if (!process_alive(link->consumer_pid) ||
+			ring_write(link, buffer, hdr_len) != UD3TN_OK) {
+		LOG("SHM: Error during sending. Data discarded.");
+		cla_link->config->vtable->cla_disconnect_handler(cla_link);
+	}
+}
+
+static void shm_end_packet(struct cla_link *cla_link)
+{
+	// STUB
+	(void)cla_link;
+}
+
+static void shm_send_packet_data(
+	struct cla_link *cla_link, const void *data, const size_t length)
+{
+	struct shm_link *const link = (struct shm_link *)cla_link;
+
+	// A previous operation may have canceled the sending process.
+	if (!cla_link->active)
+		return;
+
+	if (ring_write(link, data, length) != UD3TN_OK) {
+		LOG("SHM: Error during sending. Data discarded.");
+		cla_link->config->vtable->cla_disconnect_handler(cla_link);
+	}
+}
+
+/*
+ * INIT
+ */
+
+const struct cla_vtable shm_vtable = {
+	.cla_name_get = shm_name_get,
+	.cla_launch = shm_launch,
+	.cla_mbs_get = mtcp_mbs_get,
+
+	.cla_get_tx_queue = shm_get_tx_queue,
+	.cla_start_scheduled_contact = shm_start_scheduled_contact,
+	.cla_end_scheduled_contact = shm_end_scheduled_contact,
+
+	.cla_begin_packet = shm_begin_packet,
+	.cla_end_packet = shm_end_packet,
+	.cla_send_packet_data = shm_send_packet_data,
+
+	.cla_rx_task_reset_parsers = mtcp_reset_parsers,
+	.cla_rx_task_forward_to_specific_parser =
+		mtcp_forward_to_specific_parser,
+
+	.cla_read = shm_read,
+
+	.cla_disconnect_handler = cla_generic_disconnect_handler,
+};
+
+static enum ud3tn_result shm_init(
+	struct shm_config *config, const char *name,
+	const struct bundle_agent_interface *bundle_agent_interface)
+{
+	if (cla_config_init(&config->base, bundle_agent_interface) != UD3TN_OK)
+		return UD3TN_FAIL;
+
+	config->base.vtable = &shm_vtable;
+	config->listen_task = NULL;
+
+	htab_init(&config->param_htab, CLA_SHM_PARAM_HTAB_SLOT_COUNT,
+		  config->param_htab_elem);
+
+	config->param_htab_sem = hal_semaphore_init_binary();
+	hal_semaphore_release(config->param_htab_sem);
+
+	config->segment_name = get_segment_name(name);
+	if (!config->segment_name)
+		return UD3TN_FAIL;
+
+	// Remove a segment left behind by a previous instance.
+	orphan_segment(config->segment_name);
+	shm_unlink(config->segment_name);
+	config->segment = map_segment(config->segment_name, true);
+	if (!config->segment) {
+		free(config->segment_name);
+		return UD3TN_FAIL;
+	}
+
+	config->segment->magic = SHM_SEGMENT_MAGIC;
+	atomic_store(&config->segment->consumer_pid, getpid());
+
+	LOGF("SHM: CLA shm is now available as \"%s\"", name);
+
+	return UD3TN_OK;
+}
+
+struct cla_config *shm_create(
+	const char *const options[], const size_t option_count,
+	const struct bundle_agent_interface *bundle_agent_interface)
+{
+	if (option_count != 1 || options[0][0] == '\0' ||
+			strlen(options[0]) > CLA_SHM_MAX_NAME_LENGTH ||
+			strchr(options[0], '/')) {
+		LOG("SHM: Options format has to be: <NAME>");
+		return NULL;
+	}
+
+	struct shm_config *config = malloc(sizeof(struct shm_config));
+
+	if (!config) {
+		LOG("SHM: Memory allocation failed!");
+		return NULL;
+	}
+
+	if (shm_init(config, options[0], bundle_agent_interface) != UD3TN_OK) {
+		free(config);
+		LOG("SHM: Initialization failed!");
+		return NULL;
+	}
+
+	return &config->base;
+}
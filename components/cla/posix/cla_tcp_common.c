@@ -354,17 +354,18 @@ struct cla_tx_queue cla_tcp_single_get_tx_queue(
 
 	// No active link!
 	if (!link)
-		return (struct cla_tx_queue){ NULL, NULL };
+		return (struct cla_tx_queue){ NULL, NULL, NULL };
 
 	hal_semaphore_take_blocking(link->base.tx_queue_sem);
 
 	// Freed while trying to obtain it
 	if (!link->base.tx_queue_handle)
-		return (struct cla_tx_queue){ NULL, NULL };
+		return (struct cla_tx_queue){ NULL, NULL, NULL };
 
 	return (struct cla_tx_queue){
 		.tx_queue_handle = link->base.tx_queue_handle,
 		.tx_queue_sem = link->base.tx_queue_sem,
+		.tx_backlog = &link->base.tx_backlog,
 	};
 }
 
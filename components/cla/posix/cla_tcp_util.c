@@ -11,11 +11,13 @@
 #include <netinet/tcp.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <errno.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -281,7 +283,7 @@ ssize_t tcp_send_all(const int socket, const void *const buffer,
 	while (sent < length) {
 		const ssize_t r = send(
 			socket,
-			buffer,
+			(const uint8_t *)buffer + sent,
 			length - sent,
 			0
 		);
@@ -301,6 +303,53 @@ ssize_t tcp_send_all(const int socket, const void *const buffer,
 	return sent;
 }
 
+ssize_t tcp_send_all_iov(const int socket, struct iovec *iov, int iovcnt)
+{
+	size_t sent = 0;
+	struct msghdr msg = {
+		.msg_iov = iov,
+		.msg_iovlen = iovcnt,
+	};
+
+	while (msg.msg_iovlen) {
+		// Skip all fully-sent (or empty) elements
+		if (msg.msg_iov->iov_len == 0) {
+			msg.msg_iov++;
+			msg.msg_iovlen--;
+			continue;
+		}
+
+		ssize_t r = sendmsg(socket, &msg, 0);
+
+		if (r == 0)
+			return r;
+		if (r < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK ||
+					errno == EINTR)
+				continue;
+			return r;
+		}
+
+		sent += r;
+		// Advance the I/O vector by the amount of sent bytes
+		while (r > 0) {
+			const size_t cur = MIN((size_t)r,
+					       msg.msg_iov->iov_len);
+
+			msg.msg_iov->iov_base =
+				(uint8_t *)msg.msg_iov->iov_base + cur;
+			msg.msg_iov->iov_len -= cur;
+			r -= cur;
+			if (msg.msg_iov->iov_len == 0) {
+				msg.msg_iov++;
+				msg.msg_iovlen--;
+			}
+		}
+	}
+
+	return sent;
+}
+
 ssize_t tcp_recv_all(const int socket, void *const buffer, const size_t length)
 {
 	size_t recvd = 0;
@@ -327,3 +376,32 @@ ssize_t tcp_recv_all(const int socket, void *const buffer, const size_t length)
 
 	return recvd;
 }
+
+int tcp_enable_keepalive(const int socket, const int idle_s,
+			 const int interval_s, const int count)
+{
+	const int enable = 1;
+
+	if (setsockopt(socket, SOL_SOCKET, SO_KEEPALIVE,
+		       &enable, sizeof(int)) < 0)
+		goto fail;
+#ifdef TCP_KEEPIDLE
+	if (setsockopt(socket, IPPROTO_TCP, TCP_KEEPIDLE,
+		       &idle_s, sizeof(int)) < 0)
+		goto fail;
+#else // TCP_KEEPIDLE
+	(void)idle_s;
+#endif // TCP_KEEPIDLE
+	if (setsockopt(socket, IPPROTO_TCP, TCP_KEEPINTVL,
+		       &interval_s, sizeof(int)) < 0)
+		goto fail;
+	if (setsockopt(socket, IPPROTO_TCP, TCP_KEEPCNT,
+		       &count, sizeof(int)) < 0)
+		goto fail;
+
+	return 0;
+
+fail:
+	LOGF("TCP: setsockopt() for keepalive failed: %s", strerror(errno));
+	return -1;
+}
@@ -8,6 +8,7 @@
 #include "cla/posix/cla_tcp_util.h"
 #include "cla/posix/cla_tcpclv3.h"
 #include "cla/posix/cla_tcpclv3_proto.h"
+#include "cla/posix/cla_zlib.h"
 
 #include "bundle6/parser.h"
 #include "bundle6/sdnv.h"
@@ -24,8 +25,8 @@
 #include "ud3tn/common.h"
 #include "ud3tn/config.h"
 #include "ud3tn/eid.h"
+#include "ud3tn/hashmap.h"
 #include "ud3tn/result.h"
-#include "ud3tn/simplehtab.h"
 #include "ud3tn/task_tags.h"
 
 #include <errno.h>
@@ -34,6 +35,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <netdb.h>
 #include <unistd.h>
@@ -43,9 +45,11 @@
 struct tcpclv3_config {
 	struct cla_tcp_config base;
 
-	struct htab_entrylist *param_htab_elem[CLA_TCP_PARAM_HTAB_SLOT_COUNT];
-	struct htab param_htab;
+	struct hashmap param_htab;
 	Semaphore_t param_htab_sem;
+
+	// Request compression of all sessions in the contact header
+	bool compression;
 };
 
 enum TCPCLV3_STATE {
@@ -86,8 +90,95 @@ struct tcpclv3_contact_parameters {
 	bool opportunistic;
 
 	struct tcpclv3_parser tcpclv3_parser;
+
+	// Both peers set TCPCLV3_CONTACT_FLAG_COMPRESSION in the contact header
+	bool compression;
+	struct cla_zlib_stream *tx_zstream;
+	struct cla_zlib_stream *rx_zstream;
+	// Compressed stream position at the start of the current TX packet
+	uint64_t tx_packet_start;
+	// Received compressed data which has not been decompressed yet
+	const uint8_t *rx_zbuf_pos;
+	size_t rx_zbuf_fill;
+	uint8_t tx_zbuf[CLA_TCPCLV3_COMPRESSION_BUFFER_SIZE];
+	uint8_t rx_zbuf[CLA_TCPCLV3_COMPRESSION_BUFFER_SIZE];
 };
 
+/*
+ * COMPRESSION
+ */
+
+static enum ud3tn_result tcpclv3_compression_init(
+	struct tcpclv3_contact_parameters *const param)
+{
+	param->tx_zstream = NULL;
+	param->rx_zstream = NULL;
+	param->rx_zbuf_pos = param->rx_zbuf;
+	param->rx_zbuf_fill = 0;
+	if (!param->compression)
+		return UD3TN_OK;
+
+	param->tx_zstream = cla_zlib_create(
+		true,
+		CLA_TCPCLV3_COMPRESSION_LEVEL
+	);
+	param->rx_zstream = cla_zlib_create(false, 0);
+	if (!param->tx_zstream || !param->rx_zstream) {
+		cla_zlib_free(param->tx_zstream);
+		cla_zlib_free(param->rx_zstream);
+		return UD3TN_FAIL;
+	}
+
+	return UD3TN_OK;
+}
+
+static void tcpclv3_compression_free(
+	struct tcpclv3_contact_parameters *const param)
+{
+	cla_zlib_free(param->tx_zstream);
+	cla_zlib_free(param->rx_zstream);
+	param->tx_zstream = NULL;
+	param->rx_zstream = NULL;
+}
+
+static enum ud3tn_result tcpclv3_deflate(
+	struct tcpclv3_contact_parameters *const param,
+	const void *data, size_t length, const bool flush)
+{
+	const uint8_t *in = data;
+
+	// Send the output as long as zlib fills the whole buffer.
+	for (;;) {
+		uint8_t *out = param->tx_zbuf;
+		size_t out_length = sizeof(param->tx_zbuf);
+
+		if (cla_zlib_process(param->tx_zstream, &in, &length,
+				     &out, &out_length, flush) != UD3TN_OK)
+			return UD3TN_FAIL;
+
+		const size_t produced = sizeof(param->tx_zbuf) - out_length;
+
+		if (produced &&
+		    tcp_send_all(param->link.connection_socket,
+				 param->tx_zbuf, produced) == -1)
+			return UD3TN_FAIL;
+		if (out_length != 0 && length == 0)
+			return UD3TN_OK;
+	}
+}
+
+static enum ud3tn_result tcpclv3_send(
+	struct tcpclv3_contact_parameters *const param,
+	const void *data, const size_t length)
+{
+	if (param->compression)
+		return tcpclv3_deflate(param, data, length, false);
+
+	if (tcp_send_all(param->link.connection_socket, data, length) == -1)
+		return UD3TN_FAIL;
+	return UD3TN_OK;
+}
+
 /*
  * MGMT
  */
@@ -102,6 +193,11 @@ static enum ud3tn_result cla_tcpclv3_perform_handshake(
 	size_t header_len;
 	char *const header = cla_tcpclv3_generate_contact_header(
 		local_eid,
+		(
+			param->config->compression
+			? TCPCLV3_CONTACT_FLAG_COMPRESSION
+			: TCPCLV3_CONTACT_FLAG_NONE
+		),
 		&header_len
 	);
 
@@ -120,9 +216,9 @@ static enum ud3tn_result cla_tcpclv3_perform_handshake(
 
 	char header_buf[8];
 
-	// NOTE: Currently we do not use the negotiated parameters as we
-	// disable all optional features and thus do not have to check against
-	// them.
+	// NOTE: Apart from compression, we do not use the negotiated
+	// parameters as we disable all optional features and thus do not have
+	// to check against them.
 	if (tcp_recv_all(param->socket, header_buf, 8) <= 0 ||
 			memcmp(header_buf, "dtn!", 4) != 0 ||
 			header_buf[4] < 0x03) {
@@ -130,6 +226,11 @@ static enum ud3tn_result cla_tcpclv3_perform_handshake(
 		return UD3TN_FAIL;
 	}
 
+	param->compression = (
+		param->config->compression &&
+		(header_buf[5] & TCPCLV3_CONTACT_FLAG_COMPRESSION) != 0
+	);
+
 	uint8_t cur_byte;
 	struct sdnv_state sdnv_state;
 	uint32_t peer_eid_len = 0;
@@ -167,8 +268,9 @@ static enum ud3tn_result cla_tcpclv3_perform_handshake(
 		return UD3TN_FAIL;
 	}
 
-	LOGF("TCPCLv3: Handshake performed with \"%s\", has EID \"%s\"",
-	     param->cla_addr ? param->cla_addr : "<incoming>", eid_buf);
+	LOGF("TCPCLv3: Handshake performed with \"%s\", has EID \"%s\"%s",
+	     param->cla_addr ? param->cla_addr : "<incoming>", eid_buf,
+	     param->compression ? ", compression enabled" : "");
 	param->eid = eid_buf;
 
 	return UD3TN_OK;
@@ -179,13 +281,18 @@ static enum ud3tn_result handle_established_connection(
 {
 	struct tcpclv3_config *const tcpclv3_config = param->config;
 
+	if (tcpclv3_compression_init(param) != UD3TN_OK) {
+		LOG("TCPCLv3: Error initializing compression!");
+		return UD3TN_FAIL;
+	}
+
 	hal_semaphore_take_blocking(tcpclv3_config->param_htab_sem);
 
 	// Check if there is another connection which is
 	// a) trying to connect / establish (non-opportunistic)
 	// b) already established
 	struct tcpclv3_contact_parameters *const other =
-		htab_get(&tcpclv3_config->param_htab, param->eid);
+		hashmap_get(&tcpclv3_config->param_htab, param->eid);
 
 	if (other) {
 		// Another connection exists. If it currently has not
@@ -198,7 +305,7 @@ static enum ud3tn_result handle_established_connection(
 				!other->link.base.active) {
 			LOGF("TCPCLv3: Taking over management of connection with \"%s\"",
 			     param->eid);
-			htab_remove(&tcpclv3_config->param_htab, param->eid);
+			hashmap_remove(&tcpclv3_config->param_htab, param->eid);
 			if (!other->opportunistic) {
 				// Take over the "planned" status
 				other->opportunistic = true;
@@ -224,7 +331,7 @@ static enum ud3tn_result handle_established_connection(
 	}
 
 	// Will do nothing if element exists - this is expected
-	htab_add(&tcpclv3_config->param_htab, param->eid, param);
+	hashmap_add(&tcpclv3_config->param_htab, param->eid, param);
 
 	param->state = TCPCLV3_ESTABLISHED;
 	hal_semaphore_release(tcpclv3_config->param_htab_sem);
@@ -234,11 +341,13 @@ static enum ud3tn_result handle_established_connection(
 			      true)
 			!= UD3TN_OK) {
 		LOG("TCPCLv3: Error initializing CLA link!");
+		tcpclv3_compression_free(param);
 		param->state = TCPCLV3_CONNECTING;
 		return UD3TN_FAIL;
 	}
 
 	cla_link_wait_cleanup(&param->link.base);
+	tcpclv3_compression_free(param);
 
 	param->state = TCPCLV3_CONNECTING;
 	return UD3TN_OK;
@@ -300,8 +409,8 @@ static void tcpclv3_link_management_task(void *p)
 	if (param->eid) {
 		hal_semaphore_take_blocking(param->config->param_htab_sem);
 		// Only delete in case it is our own entry...
-		if (htab_get(&param->config->param_htab, param->eid) == param)
-			htab_remove(&param->config->param_htab, param->eid);
+		if (hashmap_get(&param->config->param_htab, param->eid) == param)
+			hashmap_remove(&param->config->param_htab, param->eid);
 		hal_semaphore_release(param->config->param_htab_sem);
 	}
 	tcpclv3_parser_reset(&param->tcpclv3_parser);
@@ -328,6 +437,7 @@ static void launch_connection_management_task(
 
 	contact_params->config = tcpclv3_config;
 	contact_params->connect_attempt = 0;
+	contact_params->compression = false;
 
 	if (sock < 0) {
 		ASSERT(eid && cla_addr);
@@ -357,18 +467,18 @@ static void launch_connection_management_task(
 		goto fail;
 	}
 
-	struct htab_entrylist *htab_entry = NULL;
+	bool in_htab = false;
 
 	if (contact_params->eid) {
-		htab_entry = htab_add(
+		if (hashmap_add(
 			&tcpclv3_config->param_htab,
 			contact_params->eid,
 			contact_params
-		);
-		if (!htab_entry) {
+		) != UD3TN_OK) {
 			LOG("TCPCLv3: Error creating htab entry!");
 			goto fail;
 		}
+		in_htab = true;
 	}
 
 	contact_params->management_task = hal_task_create(
@@ -382,9 +492,9 @@ static void launch_connection_management_task(
 
 	if (!contact_params->management_task) {
 		LOG("TCPCLv3: Error creating management task!");
-		if (htab_entry) {
+		if (in_htab) {
 			ASSERT(contact_params->eid);
-			ASSERT(htab_remove(
+			ASSERT(hashmap_remove(
 				&tcpclv3_config->param_htab,
 				contact_params->eid
 			) == contact_params);
@@ -406,7 +516,7 @@ static struct tcpclv3_contact_parameters *get_contact_parameters(
 	struct tcpclv3_config *const tcpclv3_config =
 		(struct tcpclv3_config *)config;
 
-	return htab_get(&tcpclv3_config->param_htab, eid);
+	return hashmap_get(&tcpclv3_config->param_htab, eid);
 }
 
 static void tcpclv3_listener_task(void *p)
@@ -489,16 +599,17 @@ static struct cla_tx_queue tcpclv3_get_tx_queue(
 
 		// Freed while trying to obtain it
 		if (!param->link.base.tx_queue_handle)
-			return (struct cla_tx_queue){ NULL, NULL };
+			return (struct cla_tx_queue){ NULL, NULL, NULL };
 
 		return (struct cla_tx_queue){
 			.tx_queue_handle = param->link.base.tx_queue_handle,
 			.tx_queue_sem = param->link.base.tx_queue_sem,
+			.tx_backlog = &param->link.base.tx_backlog,
 		};
 	}
 
 	hal_semaphore_release(tcpclv3_config->param_htab_sem);
-	return (struct cla_tx_queue){ NULL, NULL };
+	return (struct cla_tx_queue){ NULL, NULL, NULL };
 }
 
 static enum ud3tn_result tcpclv3_start_scheduled_contact(
@@ -646,6 +757,50 @@ static size_t tcpclv3_forward_to_specific_parser(struct cla_link *link,
 	return result;
 }
 
+static enum ud3tn_result tcpclv3_read(struct cla_link *link,
+				      uint8_t *buffer, size_t length,
+				      size_t *bytes_read)
+{
+	struct tcpclv3_contact_parameters *const param =
+		(struct tcpclv3_contact_parameters *)link;
+
+	if (!param->compression)
+		return cla_tcp_read(link, buffer, length, bytes_read);
+
+	uint8_t *out = buffer;
+	size_t out_length = length;
+
+	// Block until at least one decompressed byte is available. If the
+	// previous call filled the buffer, zlib may still hold output even
+	// though all input was consumed, thus, the socket is only read if
+	// nothing could be produced from the data received so far.
+	for (;;) {
+		if (cla_zlib_process(param->rx_zstream,
+				     &param->rx_zbuf_pos, &param->rx_zbuf_fill,
+				     &out, &out_length, false) != UD3TN_OK) {
+			LOGF("TCPCLv3: Error decompressing stream: %s",
+			     cla_zlib_error(param->rx_zstream));
+			link->config->vtable->cla_disconnect_handler(link);
+			return UD3TN_FAIL;
+		}
+
+		if (out_length != length || length == 0)
+			break;
+
+		if (!param->rx_zbuf_fill) {
+			if (cla_tcp_read(link, param->rx_zbuf,
+					 sizeof(param->rx_zbuf),
+					 &param->rx_zbuf_fill) != UD3TN_OK)
+				return UD3TN_FAIL;
+			param->rx_zbuf_pos = param->rx_zbuf;
+		}
+	}
+
+	if (bytes_read)
+		*bytes_read = length - out_length;
+	return UD3TN_OK;
+}
+
 /*
  * TX
  */
@@ -672,8 +827,10 @@ static void tcpclv3_begin_packet(struct cla_link *link, size_t length, char *cla
 	// Calculate and set SDNV size of packet length.
 	int sdnv_len = sdnv_write_u32(&header_buffer[1], length);
 
-	if (tcp_send_all(param->link.connection_socket,
-			 header_buffer, sdnv_len + 1) == -1) {
+	if (param->compression)
+		param->tx_packet_start = cla_zlib_total_out(param->tx_zstream);
+
+	if (tcpclv3_send(param, header_buffer, sdnv_len + 1) != UD3TN_OK) {
 		LOGF("TCPCLv3: Error sending segment header: %s",
 		     strerror(errno));
 		link->config->vtable->cla_disconnect_handler(link);
@@ -686,8 +843,19 @@ static void tcpclv3_end_packet(struct cla_link *link)
 		(struct tcpclv3_contact_parameters *)link;
 
 	ASSERT(param->state == TCPCLV3_ESTABLISHED);
-	// STUB
-	(void)param;
+	// A previous operation may have canceled the sending process.
+	if (!param->compression || !link->active)
+		return;
+
+	// Flush the compressor so the peer is able to decode the whole bundle.
+	if (tcpclv3_deflate(param, NULL, 0, true) != UD3TN_OK) {
+		LOGF("TCPCLv3: Error during sending: %s", strerror(errno));
+		link->config->vtable->cla_disconnect_handler(link);
+		return;
+	}
+	link->tx_packet_wire_size = (
+		cla_zlib_total_out(param->tx_zstream) - param->tx_packet_start
+	);
 }
 
 static void tcpclv3_send_packet_data(
@@ -701,7 +869,7 @@ static void tcpclv3_send_packet_data(
 	if (!link->active)
 		return;
 
-	if (tcp_send_all(param->link.connection_socket, data, length) == -1) {
+	if (tcpclv3_send(param, data, length) != UD3TN_OK) {
 		LOGF("TCPCLv3: Error during sending: %s", strerror(errno));
 		link->config->vtable->cla_disconnect_handler(link);
 	}
@@ -728,14 +896,14 @@ const struct cla_vtable tcpclv3_vtable = {
 	.cla_rx_task_forward_to_specific_parser =
 			&tcpclv3_forward_to_specific_parser,
 
-	.cla_read = cla_tcp_read,
+	.cla_read = tcpclv3_read,
 
 	.cla_disconnect_handler = cla_tcp_disconnect_handler,
 };
 
 static enum ud3tn_result tcpclv3_init(
 	struct tcpclv3_config *config,
-	const char *node, const char *service,
+	const char *node, const char *service, const bool compression,
 	const struct bundle_agent_interface *bundle_agent_interface)
 {
 	/* Initialize base_config */
@@ -745,9 +913,11 @@ static enum ud3tn_result tcpclv3_init(
 
 	/* set base_config vtable */
 	config->base.base.vtable = &tcpclv3_vtable;
+	config->compression = compression;
 
-	htab_init(&config->param_htab, CLA_TCP_PARAM_HTAB_SLOT_COUNT,
-		  config->param_htab_elem);
+	if (hashmap_init(&config->param_htab, CLA_TCP_PARAM_HTAB_SLOT_COUNT,
+			 false) != UD3TN_OK)
+		return UD3TN_FAIL;
 
 	config->param_htab_sem = hal_semaphore_init_binary();
 	hal_semaphore_release(config->param_htab_sem);
@@ -765,8 +935,25 @@ struct cla_config *tcpclv3_create(
 	const char *const options[], const size_t option_count,
 	const struct bundle_agent_interface *bundle_agent_interface)
 {
-	if (option_count != 2) {
-		LOG("TCPCLv3: Options format has to be: <IP>,<PORT>");
+	if (option_count < 2 || option_count > 3) {
+		LOG("TCPCLv3: Options format has to be: <IP>,<PORT>[,<COMPRESS>]");
+		return NULL;
+	}
+
+	bool compression = false;
+
+	if (option_count > 2) {
+		if (!strcmp(options[2], "true")) {
+			compression = true;
+		} else if (strcmp(options[2], "false")) {
+			LOGF("TCPCLv3: Could not parse compression flag: %s",
+			     options[2]);
+			return NULL;
+		}
+	}
+
+	if (compression && !cla_zlib_available()) {
+		LOG("TCPCLv3: Compression requires building with zlib=yes");
 		return NULL;
 	}
 
@@ -777,7 +964,7 @@ struct cla_config *tcpclv3_create(
 		return NULL;
 	}
 
-	if (tcpclv3_init(config, options[0], options[1],
+	if (tcpclv3_init(config, options[0], options[1], compression,
 			 bundle_agent_interface) != UD3TN_OK) {
 		free(config);
 		LOG("TCPCLv3: Initialization failed!");
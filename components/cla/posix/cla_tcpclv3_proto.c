@@ -15,7 +15,8 @@
 // HANDSHAKING
 
 char *cla_tcpclv3_generate_contact_header(
-	const char *const local_eid, size_t *len)
+	const char *const local_eid, const enum tcpclv3_contact_flags flags,
+	size_t *len)
 {
 	const size_t local_eid_len = strlen(local_eid);
 
@@ -41,7 +42,8 @@ char *cla_tcpclv3_generate_contact_header(
 
 	// Set flags (currently we don't support any additional tcpcl features)
 	// 0x00 == NO ACK, NO FRAG, NO REFUSAL, NO LENGTH MESSAGES
-	header_packet[5] = 0x00;
+	// Only our own compression extension may be requested.
+	header_packet[5] = (char)flags;
 
 	// Set keep_alive interval (currently not supported -> 0 == disable).
 	header_packet[6] = 0x00;
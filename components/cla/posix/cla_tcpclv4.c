@@ -0,0 +1,1469 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include "cla/cla.h"
+#include "cla/cla_contact_tx_task.h"
+#include "cla/posix/cla_tcp_common.h"
+#include "cla/posix/cla_tcp_util.h"
+#include "cla/posix/cla_tcpclv4.h"
+#include "cla/posix/cla_tcpclv4_proto.h"
+
+#include "bundle6/parser.h"
+#include "bundle7/parser.h"
+
+#include "platform/hal_config.h"
+#include "platform/hal_io.h"
+#include "platform/hal_queue.h"
+#include "platform/hal_semaphore.h"
+#include "platform/hal_task.h"
+
+#include "ud3tn/bundle_processor.h"
+#include "ud3tn/common.h"
+#include "ud3tn/config.h"
+#include "ud3tn/eid.h"
+#include "ud3tn/hashmap.h"
+#include "ud3tn/result.h"
+#include "ud3tn/task_tags.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+
+struct tcpclv4_config {
+	struct cla_tcp_config base;
+
+	struct hashmap param_htab;
+	Semaphore_t param_htab_sem;
+};
+
+enum TCPCLV4_STATE {
+	// No socket created. Initial state. Delete without contact.
+	TCPCLV4_INACTIVE,
+	// Socket was created, now trying to connect. Delete after contact end.
+	TCPCLV4_CONNECTING,
+	// TCP connection is open and active. Handshake is being performed.
+	// Starting point for incoming opportunistic connections.
+	TCPCLV4_CONNECTED,
+	// TCPCL session was initialized. CLA Link and RX/TX tasks exist.
+	TCPCLV4_ESTABLISHED,
+};
+
+struct tcpclv4_contact_parameters {
+	// IMPORTANT: As for TCPCLv3, the link is only initialized iff
+	// state == TCPCLV4_ESTABLISHED, i.e., the RX/TX tasks are always and
+	// only associated to a single TCPCL session.
+	struct cla_tcp_link link;
+
+	struct tcpclv4_config *config;
+
+	Task_t management_task;
+
+	char *eid;
+	char *cla_addr;
+
+	int connect_attempt;
+
+	int socket;
+
+	enum TCPCLV4_STATE state;
+	// CONNECTED or ESTABLISHED, but NOT associated to a planned contact.
+	bool opportunistic;
+
+	// Negotiated session parameters (RFC 9174, section 4.7)
+	uint64_t peer_segment_mru;
+	uint64_t peer_transfer_mru;
+
+	// Serializes messages sent by the TX task (XFER_SEGMENT) and the RX
+	// task (XFER_ACK, XFER_REFUSE, SESS_TERM) via the same socket. The TX
+	// task holds it while blocking in send(), thus, the RX task never
+	// waits for it but queues its messages, see tcpclv4_send_control().
+	Semaphore_t send_sem;
+
+	// Protects the control queue and tx_refused*, never held while sending
+	Semaphore_t ctrl_sem;
+	uint8_t ctrl_queue[CLA_TCPCLV4_CONTROL_QUEUE_SIZE];
+	size_t ctrl_fill;
+
+	// TX state, only accessed by the TX task
+	uint8_t *tx_buffer;
+	size_t tx_segment_size;
+	size_t tx_fill;
+	uint64_t tx_next_transfer_id;
+	uint64_t tx_transfer_id;
+	uint64_t tx_transfer_length;
+	uint64_t tx_transfer_sent;
+	bool tx_transfer_aborted;
+	bool tx_end_sent;
+
+	// Refusal state, written by the RX task under ctrl_sem. Segments are
+	// pipelined, i.e., the TX task never waits for an XFER_ACK.
+	bool tx_refused;
+	uint64_t tx_refused_transfer_id;
+
+	// RX state, only accessed by the RX task
+	uint64_t rx_segment_remaining;
+	uint8_t rx_segment_flags;
+	bool rx_in_transfer;
+	bool rx_discard;
+	uint64_t rx_transfer_id;
+	uint64_t rx_transfer_length;
+	uint64_t rx_transfer_received;
+	// Set if the bundle parsers may hold data of a transfer which has been
+	// refused or aborted, see tcpclv4_read().
+	bool rx_reset_parsers;
+
+	// Placeholder parser used while no bundle parser has been selected
+	struct parser transfer_parser;
+};
+
+/*
+ * MGMT
+ */
+
+static bool tcpclv4_control_pending(
+	struct tcpclv4_contact_parameters *const param)
+{
+	hal_semaphore_take_blocking(param->ctrl_sem);
+
+	const bool pending = param->ctrl_fill != 0;
+
+	hal_semaphore_release(param->ctrl_sem);
+	return pending;
+}
+
+// Sends queued control messages, the caller has to hold send_sem. With
+// MSG_DONTWAIT, the rest is left queued as soon as the socket buffer is full.
+static enum ud3tn_result tcpclv4_flush_control(
+	struct tcpclv4_contact_parameters *const param, const int flags)
+{
+	uint8_t buf[TCPCLV4_XFER_ACK_SIZE * 8];
+
+	for (;;) {
+		// Only the holder of send_sem dequeues, the RX task appends.
+		hal_semaphore_take_blocking(param->ctrl_sem);
+
+		const size_t length = MIN(param->ctrl_fill, sizeof(buf));
+
+		memcpy(buf, param->ctrl_queue, length);
+		hal_semaphore_release(param->ctrl_sem);
+
+		if (!length)
+			return UD3TN_OK;
+
+		const ssize_t sent = send(param->socket, buf, length, flags);
+
+		if (sent < 0 && errno == EINTR)
+			continue;
+		if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return UD3TN_OK;
+		if (sent <= 0) {
+			LOGF("TCPCLv4: Error sending message: %s",
+			     strerror(errno));
+			return UD3TN_FAIL;
+		}
+
+		hal_semaphore_take_blocking(param->ctrl_sem);
+		param->ctrl_fill -= sent;
+		memmove(param->ctrl_queue, &param->ctrl_queue[sent],
+			param->ctrl_fill);
+		hal_semaphore_release(param->ctrl_sem);
+	}
+}
+
+// Sends queued control messages without blocking. If the TX task holds
+// send_sem, it sends them after its current segment.
+static enum ud3tn_result tcpclv4_try_flush_control(
+	struct tcpclv4_contact_parameters *const param)
+{
+	if (hal_semaphore_try_take(param->send_sem, 0) != UD3TN_OK)
+		return UD3TN_OK;
+
+	const enum ud3tn_result result = tcpclv4_flush_control(
+		param,
+		MSG_DONTWAIT
+	);
+
+	hal_semaphore_release(param->send_sem);
+	return result;
+}
+
+// Called by the RX task. If both peers send bulk data, the socket buffers
+// are full and waiting for send_sem would stop draining the socket.
+static enum ud3tn_result tcpclv4_send_control(
+	struct tcpclv4_contact_parameters *const param,
+	const void *const data, const size_t length)
+{
+	hal_semaphore_take_blocking(param->ctrl_sem);
+
+	const bool overflow = (
+		param->ctrl_fill + length > sizeof(param->ctrl_queue)
+	);
+
+	if (!overflow) {
+		memcpy(&param->ctrl_queue[param->ctrl_fill], data, length);
+		param->ctrl_fill += length;
+	}
+	hal_semaphore_release(param->ctrl_sem);
+
+	if (overflow) {
+		LOG("TCPCLv4: Control message queue full, peer does not receive");
+		return UD3TN_FAIL;
+	}
+
+	return tcpclv4_try_flush_control(param);
+}
+
+// Waits until data can be received. Meanwhile, control messages left queued
+// are sent as soon as the socket becomes writable, as the TX task may be
+// idle and would not send them.
+static enum ud3tn_result tcpclv4_wait_readable(
+	struct tcpclv4_contact_parameters *const param)
+{
+	struct pollfd pfd = {
+		.fd = param->socket,
+		.events = POLLIN | POLLOUT,
+	};
+
+	while (tcpclv4_control_pending(param)) {
+		if (poll(&pfd, 1, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			return UD3TN_FAIL;
+		}
+		if (HAS_FLAG(pfd.revents, POLLOUT)) {
+			if (hal_semaphore_try_take(param->send_sem,
+						   0) != UD3TN_OK)
+				break;
+
+			const enum ud3tn_result result = tcpclv4_flush_control(
+				param,
+				MSG_DONTWAIT
+			);
+
+			hal_semaphore_release(param->send_sem);
+			if (result != UD3TN_OK)
+				return UD3TN_FAIL;
+		}
+		// Errors are reported by the following read.
+		if (pfd.revents & ~POLLOUT)
+			break;
+	}
+
+	return UD3TN_OK;
+}
+
+static enum ud3tn_result tcpclv4_skip_extension_items(
+	struct tcpclv4_contact_parameters *const param, const uint32_t length,
+	uint64_t *const transfer_length)
+{
+	if (!length)
+		return UD3TN_OK;
+
+	if (length > CLA_TCPCLV4_MAX_EXTENSION_SIZE) {
+		LOGF("TCPCLv4: Extension items too long (%u byte(s))", length);
+		return UD3TN_FAIL;
+	}
+
+	uint8_t *const items = malloc(length);
+
+	if (!items)
+		return UD3TN_FAIL;
+
+	if (tcp_recv_all(param->socket, items, length) != (ssize_t)length) {
+		free(items);
+		return UD3TN_FAIL;
+	}
+
+	const int result = tcpclv4_parse_transfer_extensions(
+		items,
+		length,
+		transfer_length
+	);
+
+	free(items);
+
+	if (result != 0) {
+		LOG("TCPCLv4: Invalid or unsupported critical extension item");
+		return UD3TN_FAIL;
+	}
+
+	return UD3TN_OK;
+}
+
+static enum ud3tn_result tcpclv4_perform_handshake(
+	struct tcpclv4_contact_parameters *const param)
+{
+	// Exchange contact headers (RFC 9174, section 4.2)
+
+	uint8_t header[TCPCLV4_CONTACT_HEADER_SIZE];
+
+	tcpclv4_generate_contact_header(header);
+	if (tcp_send_all(param->socket, header, sizeof(header)) == -1) {
+		LOGF("TCPCLv4: Error sending header: %s", strerror(errno));
+		return UD3TN_FAIL;
+	}
+
+	if (tcp_recv_all(param->socket, header, sizeof(header)) <= 0 ||
+			memcmp(header, "dtn!", 4) != 0) {
+		LOG("TCPCLv4: Did not receive proper \"dtn!\" magic!");
+		return UD3TN_FAIL;
+	}
+
+	if (header[4] != TCPCLV4_VERSION) {
+		uint8_t term[TCPCLV4_SESS_TERM_SIZE];
+
+		LOGF("TCPCLv4: Peer uses unsupported version %hhu",
+		     header[4]);
+		tcpclv4_generate_sess_term(term, 0,
+					   TCPCLV4_TERM_VERSION_MISMATCH);
+		tcp_send_all(param->socket, term, sizeof(term));
+		return UD3TN_FAIL;
+	}
+
+	// Exchange SESS_INIT messages (RFC 9174, section 4.6)
+
+	const char *const local_eid =
+		param->config->base.base.bundle_agent_interface->local_eid;
+	size_t sess_init_len;
+	uint8_t *const sess_init = tcpclv4_generate_sess_init(
+		local_eid,
+		0,
+		CLA_TCPCLV4_SEGMENT_MRU,
+		CLA_TCPCLV4_TRANSFER_MRU,
+		&sess_init_len
+	);
+
+	if (!sess_init)
+		return UD3TN_FAIL;
+
+	if (tcp_send_all(param->socket, sess_init, sess_init_len) == -1) {
+		free(sess_init);
+		LOGF("TCPCLv4: Error sending SESS_INIT: %s", strerror(errno));
+		return UD3TN_FAIL;
+	}
+
+	free(sess_init);
+
+	uint8_t fixed[TCPCLV4_SESS_INIT_FIXED_SIZE];
+
+	if (tcp_recv_all(param->socket, fixed, sizeof(fixed)) <= 0 ||
+			fixed[0] != TCPCLV4_TYPE_SESS_INIT) {
+		LOG("TCPCLv4: Did not receive SESS_INIT!");
+		return UD3TN_FAIL;
+	}
+
+	// NOTE: We announce a keepalive interval of zero, which disables
+	// keepalives for the session regardless of the peer's value.
+	const uint64_t peer_segment_mru = tcpclv4_read_u64(&fixed[3]);
+	const uint64_t peer_transfer_mru = tcpclv4_read_u64(&fixed[11]);
+	const uint16_t peer_eid_len = tcpclv4_read_u16(&fixed[19]);
+
+	if (peer_segment_mru == 0 || peer_transfer_mru == 0) {
+		LOG("TCPCLv4: Peer announced an MRU of zero!");
+		return UD3TN_FAIL;
+	}
+
+	char *eid_buf = malloc(peer_eid_len + 1);
+
+	if (!eid_buf) {
+		LOGF("TCPCLv4: Error allocating memory (%hu byte(s)) for EID!",
+		     peer_eid_len);
+		return UD3TN_FAIL;
+	}
+
+	uint8_t ext_len_buf[4];
+
+	if (tcp_recv_all(param->socket, eid_buf,
+			 peer_eid_len) != (ssize_t)peer_eid_len ||
+			tcp_recv_all(param->socket, ext_len_buf, 4) != 4) {
+		free(eid_buf);
+		LOGF("TCPCLv4: Error receiving peer EID of len %hu byte(s)",
+		     peer_eid_len);
+		return UD3TN_FAIL;
+	}
+
+	eid_buf[peer_eid_len] = 0;
+	if (validate_eid(eid_buf) != UD3TN_OK) {
+		LOGF("TCPCLv4: Received invalid peer EID of len %hu: \"%s\"",
+		     peer_eid_len, eid_buf);
+		free(eid_buf);
+		return UD3TN_FAIL;
+	}
+
+	// Session extension items use the same encoding as transfer
+	// extension items; unknown non-critical items are ignored.
+	if (tcpclv4_skip_extension_items(param,
+					 tcpclv4_read_u32(ext_len_buf),
+					 NULL) != UD3TN_OK) {
+		free(eid_buf);
+		return UD3TN_FAIL;
+	}
+
+	param->peer_segment_mru = peer_segment_mru;
+	param->peer_transfer_mru = peer_transfer_mru;
+
+	LOGF("TCPCLv4: Session initialized with \"%s\", has EID \"%s\", segment MRU = %llu, transfer MRU = %llu",
+	     param->cla_addr ? param->cla_addr : "<incoming>", eid_buf,
+	     (unsigned long long)peer_segment_mru,
+	     (unsigned long long)peer_transfer_mru);
+	param->eid = eid_buf;
+
+	return UD3TN_OK;
+}
+
+static void tcpclv4_reset_session_state(
+	struct tcpclv4_contact_parameters *const param)
+{
+	param->tx_fill = 0;
+	param->tx_next_transfer_id = 0;
+	param->tx_transfer_id = 0;
+	param->tx_transfer_length = 0;
+	param->tx_transfer_sent = 0;
+	param->tx_transfer_aborted = true;
+	param->tx_end_sent = true;
+	param->tx_refused = false;
+	param->tx_refused_transfer_id = 0;
+	param->ctrl_fill = 0;
+
+	param->rx_segment_remaining = 0;
+	param->rx_segment_flags = 0;
+	param->rx_in_transfer = false;
+	param->rx_discard = false;
+	param->rx_transfer_id = 0;
+	param->rx_transfer_length = 0;
+	param->rx_transfer_received = 0;
+	param->rx_reset_parsers = false;
+}
+
+static enum ud3tn_result handle_established_connection(
+	struct tcpclv4_contact_parameters *const param)
+{
+	struct tcpclv4_config *const tcpclv4_config = param->config;
+
+	// Segments are limited by our TX buffer and the peer's segment MRU.
+	param->tx_segment_size = MIN(
+		(uint64_t)CLA_TCPCLV4_TX_SEGMENT_SIZE,
+		param->peer_segment_mru
+	);
+	param->tx_buffer = malloc(param->tx_segment_size);
+	if (!param->tx_buffer) {
+		LOG("TCPCLv4: Failed to allocate TX buffer!");
+		shutdown(param->socket, SHUT_RDWR);
+		close(param->socket);
+		return UD3TN_FAIL;
+	}
+	tcpclv4_reset_session_state(param);
+
+	hal_semaphore_take_blocking(tcpclv4_config->param_htab_sem);
+
+	// See handle_established_connection() in the TCPCLv3 CLA.
+	struct tcpclv4_contact_parameters *const other =
+		hashmap_get(&tcpclv4_config->param_htab, param->eid);
+
+	if (other) {
+		if (other->state != TCPCLV4_ESTABLISHED ||
+				!other->link.base.active) {
+			LOGF("TCPCLv4: Taking over management of connection with \"%s\"",
+			     param->eid);
+			hashmap_remove(&tcpclv4_config->param_htab, param->eid);
+			if (!other->opportunistic) {
+				other->opportunistic = true;
+				param->opportunistic = false;
+				if (!param->cla_addr) {
+					param->cla_addr = other->cla_addr;
+					other->cla_addr = NULL;
+				}
+			}
+		} else {
+			LOGF("TCPCLv4: Leaving open primary connection with \"%s\" as-is",
+			     param->eid);
+			if (!param->opportunistic) {
+				other->opportunistic = false;
+				param->opportunistic = true;
+				if (!other->cla_addr) {
+					other->cla_addr = param->cla_addr;
+					param->cla_addr = NULL;
+				}
+			}
+		}
+	}
+
+	// Will do nothing if element exists - this is expected
+	hashmap_add(&tcpclv4_config->param_htab, param->eid, param);
+
+	param->state = TCPCLV4_ESTABLISHED;
+	hal_semaphore_release(tcpclv4_config->param_htab_sem);
+
+	enum ud3tn_result result = UD3TN_OK;
+
+	if (cla_tcp_link_init(&param->link, param->socket,
+			      &tcpclv4_config->base, param->cla_addr,
+			      true)
+			!= UD3TN_OK) {
+		LOG("TCPCLv4: Error initializing CLA link!");
+		shutdown(param->socket, SHUT_RDWR);
+		close(param->socket);
+		result = UD3TN_FAIL;
+	} else {
+		cla_link_wait_cleanup(&param->link.base);
+	}
+
+	param->state = TCPCLV4_CONNECTING;
+	free(param->tx_buffer);
+	param->tx_buffer = NULL;
+	return result;
+}
+
+static void tcpclv4_link_management_task(void *p)
+{
+	struct tcpclv4_contact_parameters *const param = p;
+
+	for (;;) {
+		if (param->state == TCPCLV4_CONNECTING) {
+			if (param->opportunistic || !param->cla_addr ||
+			    param->cla_addr[0] == '\0') {
+				LOG("TCPCLv4: No CLA address present, not initiating connection attempt");
+				break;
+			}
+			param->socket = cla_tcp_connect_to_cla_addr(
+				param->cla_addr,
+				"4556"
+			);
+			if (param->socket < 0) {
+				if (++param->connect_attempt >
+						CLA_TCP_MAX_RETRY_ATTEMPTS) {
+					LOG("TCPCLv4: Final retry failed.");
+					break;
+				}
+				LOGF("TCPCLv4: Delayed retry %d of %d in %d ms",
+				     param->connect_attempt,
+				     CLA_TCP_MAX_RETRY_ATTEMPTS,
+				     CLA_TCP_RETRY_INTERVAL_MS);
+				hal_task_delay(CLA_TCP_RETRY_INTERVAL_MS);
+				continue;
+			}
+			LOGF("TCPCLv4: Connected successfully to \"%s\"",
+			     param->cla_addr);
+			param->state = TCPCLV4_CONNECTED;
+		} else if (param->state == TCPCLV4_CONNECTED) {
+			ASSERT(param->socket > 0);
+			if (tcpclv4_perform_handshake(param) == UD3TN_OK) {
+				handle_established_connection(param);
+			} else {
+				shutdown(param->socket, SHUT_RDWR);
+				close(param->socket);
+			}
+			if (param->opportunistic || !param->cla_addr ||
+			    param->cla_addr[0] == '\0') {
+				LOG("TCPCLv4: No CLA address present, not initiating reconnection attempt");
+				break;
+			}
+			param->state = TCPCLV4_CONNECTING;
+			param->connect_attempt = 0;
+		} else {
+			// TCPCLV4_INACTIVE, TCPCLV4_ESTABLISHED
+			// should never happen as we are not created or wait
+			ASSERT(0);
+		}
+	}
+	LOGF("TCPCLv4: Terminating contact link manager%s%s%s",
+	     param->eid ? " for \"" : "",
+	     param->eid ? param->eid : "",
+	     param->eid ? "\"" : "");
+	// Remove from htab if there is an existing entry
+	if (param->eid) {
+		hal_semaphore_take_blocking(param->config->param_htab_sem);
+		// Only delete in case it is our own entry...
+		if (hashmap_get(&param->config->param_htab, param->eid) == param)
+			hashmap_remove(&param->config->param_htab, param->eid);
+		hal_semaphore_release(param->config->param_htab_sem);
+	}
+	hal_semaphore_delete(param->send_sem);
+	hal_semaphore_delete(param->ctrl_sem);
+	free(param->eid);
+	free(param->cla_addr);
+
+	Task_t management_task = param->management_task;
+
+	free(param);
+	hal_task_delete(management_task);
+}
+
+static void launch_connection_management_task(
+	struct tcpclv4_config *const tcpclv4_config, const int sock,
+	const char *eid, const char *cla_addr)
+{
+	struct tcpclv4_contact_parameters *contact_params =
+		malloc(sizeof(struct tcpclv4_contact_parameters));
+
+	if (!contact_params) {
+		LOG("TCPCLv4: Failed to allocate memory!");
+		return;
+	}
+
+	contact_params->config = tcpclv4_config;
+	contact_params->connect_attempt = 0;
+	contact_params->tx_buffer = NULL;
+	contact_params->transfer_parser.status = PARSER_STATUS_GOOD;
+	contact_params->transfer_parser.flags = PARSER_FLAG_NONE;
+	contact_params->transfer_parser.next_buffer = NULL;
+	contact_params->transfer_parser.next_bytes = 0;
+	tcpclv4_reset_session_state(contact_params);
+
+	if (sock < 0) {
+		ASSERT(eid && cla_addr);
+		contact_params->eid = strdup(eid);
+		contact_params->cla_addr = cla_get_connect_addr(
+			cla_addr,
+			"tcpclv4"
+		);
+		if (!contact_params->eid || !contact_params->cla_addr) {
+			LOG("TCPCLv4: Failed to copy addresses!");
+			goto fail;
+		}
+		contact_params->socket = -1;
+		contact_params->state = TCPCLV4_CONNECTING;
+		contact_params->opportunistic = false;
+	} else {
+		ASSERT(!eid && !cla_addr);
+		contact_params->eid = NULL;
+		contact_params->cla_addr = NULL;
+		contact_params->socket = sock;
+		contact_params->state = TCPCLV4_CONNECTED;
+		contact_params->opportunistic = true;
+	}
+
+	contact_params->send_sem = hal_semaphore_init_binary();
+	if (!contact_params->send_sem) {
+		LOG("TCPCLv4: Failed to create send semaphore!");
+		goto fail;
+	}
+	hal_semaphore_release(contact_params->send_sem);
+	contact_params->ctrl_sem = hal_semaphore_init_binary();
+	if (!contact_params->ctrl_sem) {
+		LOG("TCPCLv4: Failed to create control semaphore!");
+		goto fail_sem;
+	}
+	hal_semaphore_release(contact_params->ctrl_sem);
+
+	bool in_htab = false;
+
+	if (contact_params->eid) {
+		if (hashmap_add(
+			&tcpclv4_config->param_htab,
+			contact_params->eid,
+			contact_params
+		) != UD3TN_OK) {
+			LOG("TCPCLv4: Error creating htab entry!");
+			goto fail_ctrl_sem;
+		}
+		in_htab = true;
+	}
+
+	contact_params->management_task = hal_task_create(
+		tcpclv4_link_management_task,
+		"tcpclv4_mgmt_t",
+		CONTACT_MANAGEMENT_TASK_PRIORITY,
+		contact_params,
+		CONTACT_MANAGEMENT_TASK_STACK_SIZE,
+		(void *)CLA_SPECIFIC_TASK_TAG
+	);
+
+	if (!contact_params->management_task) {
+		LOG("TCPCLv4: Error creating management task!");
+		if (in_htab) {
+			ASSERT(contact_params->eid);
+			ASSERT(hashmap_remove(
+				&tcpclv4_config->param_htab,
+				contact_params->eid
+			) == contact_params);
+		}
+		goto fail_ctrl_sem;
+	}
+
+	return;
+
+fail_ctrl_sem:
+	hal_semaphore_delete(contact_params->ctrl_sem);
+fail_sem:
+	hal_semaphore_delete(contact_params->send_sem);
+fail:
+	free(contact_params->eid);
+	free(contact_params->cla_addr);
+	free(contact_params);
+}
+
+static struct tcpclv4_contact_parameters *get_contact_parameters(
+	struct cla_config *config, const char *eid)
+{
+	struct tcpclv4_config *const tcpclv4_config =
+		(struct tcpclv4_config *)config;
+
+	return hashmap_get(&tcpclv4_config->param_htab, eid);
+}
+
+static void tcpclv4_listener_task(void *p)
+{
+	struct tcpclv4_config *const tcpclv4_config = p;
+	int sock;
+
+	for (;;) {
+		sock = cla_tcp_accept_from_socket(
+			&tcpclv4_config->base,
+			tcpclv4_config->base.socket,
+			NULL
+		);
+		if (sock == -1)
+			break;
+
+		launch_connection_management_task(
+			tcpclv4_config,
+			sock,
+			NULL,
+			NULL
+		);
+	}
+	// unexpected failure to accept() - exit thread in release mode
+	ASSERT(0);
+}
+
+/*
+ * API
+ */
+
+static enum ud3tn_result tcpclv4_launch(struct cla_config *const config)
+{
+	struct cla_tcp_config *const tcp_config = (
+		(struct cla_tcp_config *)config
+	);
+
+	tcp_config->listen_task = hal_task_create(
+		tcpclv4_listener_task,
+		"tcpclv4_listen_t",
+		CONTACT_LISTEN_TASK_PRIORITY,
+		config,
+		CONTACT_LISTEN_TASK_STACK_SIZE,
+		(void *)CLA_SPECIFIC_TASK_TAG
+	);
+
+	if (!tcp_config->listen_task)
+		return UD3TN_FAIL;
+
+	return UD3TN_OK;
+}
+
+static const char *tcpclv4_name_get(void)
+{
+	return "tcpclv4";
+}
+
+static size_t tcpclv4_mbs_get(struct cla_config *const config)
+{
+	(void)config;
+	// The peer's transfer MRU is only known per session, thus, assume it
+	// matches ours. Larger bundles are fragmented proactively by the
+	// router, bundles exceeding the MRU of a session are rescheduled.
+	return MIN((uint64_t)CLA_TCPCLV4_TRANSFER_MRU, (uint64_t)SIZE_MAX);
+}
+
+static struct cla_tx_queue tcpclv4_get_tx_queue(
+	struct cla_config *config, const char *eid, const char *cla_addr)
+{
+	(void)cla_addr;
+	struct tcpclv4_config *const tcpclv4_config =
+		(struct tcpclv4_config *)config;
+
+	hal_semaphore_take_blocking(tcpclv4_config->param_htab_sem);
+	struct tcpclv4_contact_parameters *const param = get_contact_parameters(
+		config,
+		eid
+	);
+
+	if (param && param->state == TCPCLV4_ESTABLISHED) {
+		hal_semaphore_take_blocking(param->link.base.tx_queue_sem);
+		hal_semaphore_release(tcpclv4_config->param_htab_sem);
+
+		// Freed while trying to obtain it
+		if (!param->link.base.tx_queue_handle)
+			return (struct cla_tx_queue){ NULL, NULL, NULL };
+
+		return (struct cla_tx_queue){
+			.tx_queue_handle = param->link.base.tx_queue_handle,
+			.tx_queue_sem = param->link.base.tx_queue_sem,
+			.tx_backlog = &param->link.base.tx_backlog,
+		};
+	}
+
+	hal_semaphore_release(tcpclv4_config->param_htab_sem);
+	return (struct cla_tx_queue){ NULL, NULL, NULL };
+}
+
+static enum ud3tn_result tcpclv4_start_scheduled_contact(
+	struct cla_config *config, const char *eid, const char *cla_addr)
+{
+	struct tcpclv4_config *const tcpclv4_config =
+		(struct tcpclv4_config *)config;
+
+	hal_semaphore_take_blocking(tcpclv4_config->param_htab_sem);
+	struct tcpclv4_contact_parameters *const param = get_contact_parameters(
+		config,
+		eid
+	);
+
+	if (param) {
+		LOGF("TCPCLv4: Associating open connection with \"%s\" to new contact",
+		     eid);
+		param->opportunistic = false;
+		free(param->cla_addr);
+		param->cla_addr = cla_get_connect_addr(cla_addr, "tcpclv4");
+
+		// Even if it is no _new_ connection, we notify the BP task
+		// (as long as the connection is already UP)
+		if (param->state == TCPCLV4_ESTABLISHED) {
+			const struct bundle_agent_interface *bai =
+				config->bundle_agent_interface;
+			ASSERT(param->link.base.config != NULL);
+			bundle_processor_inform(
+				bai->bundle_signaling_queue,
+				NULL,
+				BP_SIGNAL_NEW_LINK_ESTABLISHED,
+				cla_get_cla_addr_from_link(&param->link.base),
+				NULL,
+				NULL,
+				NULL
+			);
+		}
+
+		hal_semaphore_release(tcpclv4_config->param_htab_sem);
+		return UD3TN_OK;
+	}
+
+	launch_connection_management_task(tcpclv4_config, -1, eid, cla_addr);
+	hal_semaphore_release(tcpclv4_config->param_htab_sem);
+
+	return UD3TN_OK;
+}
+
+static enum ud3tn_result tcpclv4_end_scheduled_contact(
+	struct cla_config *config, const char *eid, const char *cla_addr)
+{
+	(void)cla_addr;
+	struct tcpclv4_config *const tcpclv4_config =
+		(struct tcpclv4_config *)config;
+
+	hal_semaphore_take_blocking(tcpclv4_config->param_htab_sem);
+	struct tcpclv4_contact_parameters *const param = get_contact_parameters(
+		config,
+		eid
+	);
+
+	if (param && !param->opportunistic) {
+		LOGF("TCPCLv4: Marking active contact with \"%s\" as opportunistic",
+		     eid);
+		param->opportunistic = true;
+	}
+
+	hal_semaphore_release(tcpclv4_config->param_htab_sem);
+
+	return UD3TN_OK;
+}
+
+/*
+ * RX
+ */
+
+static enum ud3tn_result tcpclv4_refuse_transfer(
+	struct tcpclv4_contact_parameters *const param, const uint8_t reason)
+{
+	uint8_t msg[TCPCLV4_XFER_REFUSE_SIZE];
+
+	LOGF("TCPCLv4: Refusing transfer %llu from \"%s\" (reason %hhu)",
+	     (unsigned long long)param->rx_transfer_id, param->eid, reason);
+	tcpclv4_generate_xfer_refuse(msg, reason, param->rx_transfer_id);
+	// Drop all remaining data of this transfer, without delivering it.
+	param->rx_discard = true;
+	param->rx_reset_parsers = true;
+
+	return tcpclv4_send_control(param, msg, sizeof(msg));
+}
+
+static enum ud3tn_result tcpclv4_handle_segment_received(
+	struct tcpclv4_contact_parameters *const param)
+{
+	const uint8_t flags = param->rx_segment_flags;
+	const bool refused = param->rx_discard;
+
+	if (HAS_FLAG(flags, TCPCLV4_SEGMENT_FLAG_END)) {
+		param->rx_in_transfer = false;
+		param->rx_discard = false;
+	}
+
+	// Refused transfers are not acknowledged anymore.
+	if (refused)
+		return UD3TN_OK;
+
+	uint8_t msg[TCPCLV4_XFER_ACK_SIZE];
+
+	tcpclv4_generate_xfer_ack(msg, flags, param->rx_transfer_id,
+				  param->rx_transfer_received);
+
+	return tcpclv4_send_control(param, msg, sizeof(msg));
+}
+
+static enum ud3tn_result tcpclv4_handle_xfer_segment(
+	struct tcpclv4_contact_parameters *const param)
+{
+	uint8_t buf[1 + 8];
+
+	if (tcp_recv_all(param->socket, buf, sizeof(buf)) != sizeof(buf))
+		return UD3TN_FAIL;
+
+	const uint8_t flags = buf[0];
+	const uint64_t transfer_id = tcpclv4_read_u64(&buf[1]);
+	uint64_t transfer_length = 0;
+
+	if (HAS_FLAG(flags, TCPCLV4_SEGMENT_FLAG_START)) {
+		uint8_t ext_len_buf[4];
+
+		if (tcp_recv_all(param->socket, ext_len_buf, 4) != 4)
+			return UD3TN_FAIL;
+		if (tcpclv4_skip_extension_items(
+				param,
+				tcpclv4_read_u32(ext_len_buf),
+				&transfer_length) != UD3TN_OK)
+			return UD3TN_FAIL;
+
+		if (param->rx_in_transfer && !param->rx_discard) {
+			// The peer aborted its previous transfer.
+			LOGF("TCPCLv4: Transfer %llu was not completed by peer",
+			     (unsigned long long)param->rx_transfer_id);
+			param->rx_reset_parsers = true;
+		}
+		param->rx_in_transfer = true;
+		param->rx_discard = false;
+		param->rx_transfer_id = transfer_id;
+		param->rx_transfer_length = transfer_length;
+		param->rx_transfer_received = 0;
+	} else if (!param->rx_in_transfer ||
+			transfer_id != param->rx_transfer_id) {
+		LOGF("TCPCLv4: Received segment of unknown transfer %llu",
+		     (unsigned long long)transfer_id);
+		if (param->rx_in_transfer && !param->rx_discard)
+			param->rx_reset_parsers = true;
+		param->rx_transfer_id = transfer_id;
+		param->rx_in_transfer = true;
+		param->rx_discard = true;
+	}
+
+	if (tcp_recv_all(param->socket, buf, 8) != 8)
+		return UD3TN_FAIL;
+
+	const uint64_t data_length = tcpclv4_read_u64(buf);
+
+	if (data_length > CLA_TCPCLV4_SEGMENT_MRU) {
+		uint8_t term[TCPCLV4_SESS_TERM_SIZE];
+
+		LOGF("TCPCLv4: Segment exceeds MRU (%llu byte(s))",
+		     (unsigned long long)data_length);
+		tcpclv4_generate_sess_term(term, 0,
+					   TCPCLV4_TERM_RESOURCE_EXHAUST);
+		tcpclv4_send_control(param, term, sizeof(term));
+		return UD3TN_FAIL;
+	}
+
+	param->rx_segment_flags = flags;
+	param->rx_segment_remaining = data_length;
+
+	// Refuse early if we already know the transfer does not fit, instead
+	// of absorbing all of it.
+	if (!param->rx_discard &&
+	    (param->rx_transfer_length > CLA_TCPCLV4_TRANSFER_MRU ||
+	     param->rx_transfer_received + data_length >
+			CLA_TCPCLV4_TRANSFER_MRU)) {
+		if (tcpclv4_refuse_transfer(
+				param,
+				TCPCLV4_REFUSE_NO_RESOURCES) != UD3TN_OK)
+			return UD3TN_FAIL;
+	}
+
+	// Empty segments are acknowledged right away.
+	if (!data_length)
+		return tcpclv4_handle_segment_received(param);
+
+	return UD3TN_OK;
+}
+
+static enum ud3tn_result tcpclv4_handle_xfer_ack(
+	struct tcpclv4_contact_parameters *const param)
+{
+	uint8_t buf[TCPCLV4_XFER_ACK_SIZE - 1];
+
+	if (tcp_recv_all(param->socket, buf, sizeof(buf)) != sizeof(buf))
+		return UD3TN_FAIL;
+
+	// Segments are pipelined, thus, acknowledgments are not awaited.
+	return UD3TN_OK;
+}
+
+static enum ud3tn_result tcpclv4_handle_xfer_refuse(
+	struct tcpclv4_contact_parameters *const param)
+{
+	uint8_t buf[TCPCLV4_XFER_REFUSE_SIZE - 1];
+
+	if (tcp_recv_all(param->socket, buf, sizeof(buf)) != sizeof(buf))
+		return UD3TN_FAIL;
+
+	const uint64_t transfer_id = tcpclv4_read_u64(&buf[1]);
+
+	LOGF("TCPCLv4: Peer \"%s\" refused transfer %llu (reason %hhu)",
+	     param->eid, (unsigned long long)transfer_id, buf[0]);
+
+	// The TX task checks this before sending the next segment.
+	hal_semaphore_take_blocking(param->ctrl_sem);
+	param->tx_refused = true;
+	param->tx_refused_transfer_id = transfer_id;
+	hal_semaphore_release(param->ctrl_sem);
+
+	return UD3TN_OK;
+}
+
+static enum ud3tn_result tcpclv4_handle_sess_term(
+	struct tcpclv4_contact_parameters *const param)
+{
+	uint8_t buf[TCPCLV4_SESS_TERM_SIZE - 1];
+
+	if (tcp_recv_all(param->socket, buf, sizeof(buf)) != sizeof(buf))
+		return UD3TN_FAIL;
+
+	LOGF("TCPCLv4: Peer \"%s\" terminated the session (reason %hhu)",
+	     param->eid, buf[1]);
+
+	if (!HAS_FLAG(buf[0], TCPCLV4_SESS_TERM_FLAG_REPLY)) {
+		uint8_t reply[TCPCLV4_SESS_TERM_SIZE];
+
+		tcpclv4_generate_sess_term(reply, TCPCLV4_SESS_TERM_FLAG_REPLY,
+					   buf[1]);
+		tcpclv4_send_control(param, reply, sizeof(reply));
+	}
+
+	// Leads to the link being torn down.
+	return UD3TN_FAIL;
+}
+
+static enum ud3tn_result tcpclv4_receive_message(
+	struct tcpclv4_contact_parameters *const param)
+{
+	uint8_t buf[2];
+
+	if (tcp_recv_all(param->socket, buf, 1) != 1)
+		return UD3TN_FAIL;
+
+	switch (buf[0]) {
+	case TCPCLV4_TYPE_XFER_SEGMENT:
+		return tcpclv4_handle_xfer_segment(param);
+	case TCPCLV4_TYPE_XFER_ACK:
+		return tcpclv4_handle_xfer_ack(param);
+	case TCPCLV4_TYPE_XFER_REFUSE:
+		return tcpclv4_handle_xfer_refuse(param);
+	case TCPCLV4_TYPE_KEEPALIVE:
+		return UD3TN_OK;
+	case TCPCLV4_TYPE_SESS_TERM:
+		return tcpclv4_handle_sess_term(param);
+	case TCPCLV4_TYPE_MSG_REJECT:
+		if (tcp_recv_all(param->socket, buf, 2) != 2)
+			return UD3TN_FAIL;
+		LOGF("TCPCLv4: Peer rejected message of type %hhu (reason %hhu)",
+		     buf[1], buf[0]);
+		return UD3TN_OK;
+	default:
+		break;
+	}
+
+	// We cannot determine the length of unknown messages.
+	uint8_t msg[TCPCLV4_MSG_REJECT_SIZE];
+
+	LOGF("TCPCLv4: Received unexpected message of type %hhu", buf[0]);
+	tcpclv4_generate_msg_reject(
+		msg,
+		buf[0] == TCPCLV4_TYPE_SESS_INIT
+			? TCPCLV4_REJECT_UNEXPECTED
+			: TCPCLV4_REJECT_TYPE_UNKNOWN,
+		buf[0]
+	);
+	tcpclv4_send_control(param, msg, sizeof(msg));
+	return UD3TN_FAIL;
+}
+
+// Returns only XFER_SEGMENT data to the RX task. All other messages are
+// handled here, which allows bulk reads of the bundle parsers to span
+// multiple segments.
+static enum ud3tn_result tcpclv4_read(struct cla_link *link,
+				      uint8_t *buffer, size_t length,
+				      size_t *bytes_read)
+{
+	struct tcpclv4_contact_parameters *const param =
+		(struct tcpclv4_contact_parameters *)link;
+	size_t read = 0;
+
+	while (!param->rx_segment_remaining || param->rx_discard) {
+		if (tcpclv4_wait_readable(param) != UD3TN_OK)
+			goto fail;
+		if (!param->rx_segment_remaining) {
+			if (tcpclv4_receive_message(param) != UD3TN_OK)
+				goto fail;
+			// Let the RX task reset the parsers, so the data of the
+			// next transfer is not appended to a stale bundle.
+			if (param->rx_reset_parsers) {
+				param->rx_reset_parsers = false;
+				return UD3TN_FAIL;
+			}
+			continue;
+		}
+
+		// Discard the data of a refused transfer
+		uint8_t drop[CLA_RX_BUFFER_SIZE];
+
+		if (cla_tcp_read(link, drop,
+				 MIN(param->rx_segment_remaining,
+				     (uint64_t)sizeof(drop)),
+				 &read) != UD3TN_OK)
+			return UD3TN_FAIL;
+		param->rx_segment_remaining -= read;
+		if (!param->rx_segment_remaining &&
+				tcpclv4_handle_segment_received(
+					param) != UD3TN_OK)
+			goto fail;
+	}
+
+	if (tcpclv4_wait_readable(param) != UD3TN_OK)
+		goto fail;
+	if (cla_tcp_read(link, buffer,
+			 MIN(param->rx_segment_remaining, (uint64_t)length),
+			 &read) != UD3TN_OK)
+		return UD3TN_FAIL;
+
+	param->rx_segment_remaining -= read;
+	param->rx_transfer_received += read;
+	if (!param->rx_segment_remaining &&
+			tcpclv4_handle_segment_received(param) != UD3TN_OK)
+		goto fail;
+
+	if (bytes_read)
+		*bytes_read = read;
+	return UD3TN_OK;
+
+fail:
+	link->config->vtable->cla_disconnect_handler(link);
+	return UD3TN_FAIL;
+}
+
+static void tcpclv4_reset_parsers(struct cla_link *link)
+{
+	struct tcpclv4_contact_parameters *const param =
+		(struct tcpclv4_contact_parameters *)link;
+
+	rx_task_reset_parsers(&link->rx_task_data);
+	link->rx_task_data.cur_parser = &param->transfer_parser;
+}
+
+static size_t tcpclv4_forward_to_specific_parser(struct cla_link *link,
+						 const uint8_t *buffer,
+						 size_t length)
+{
+	struct tcpclv4_contact_parameters *const param =
+		(struct tcpclv4_contact_parameters *)link;
+	struct rx_task_data *const rx_data = &link->rx_task_data;
+	size_t result = 0;
+
+	ASSERT(param->state == TCPCLV4_ESTABLISHED);
+
+	switch (rx_data->payload_type) {
+	case PAYLOAD_UNKNOWN:
+		result = select_bundle_parser_version(rx_data, buffer, length);
+		if (result == 0 && length != 0) {
+			// Not a bundle, reject the rest of the transfer.
+			if (param->rx_in_transfer && !param->rx_discard)
+				tcpclv4_refuse_transfer(
+					param,
+					TCPCLV4_REFUSE_NOT_ACCEPTABLE
+				);
+			tcpclv4_reset_parsers(link);
+			return length;
+		}
+		break;
+	case PAYLOAD_BUNDLE6:
+		rx_data->cur_parser = rx_data->bundle6_parser.basedata;
+		result = bundle6_parser_read(
+			&rx_data->bundle6_parser,
+			buffer,
+			length
+		);
+		break;
+	case PAYLOAD_BUNDLE7:
+		rx_data->cur_parser = rx_data->bundle7_parser.basedata;
+		result = bundle7_parser_read(
+			&rx_data->bundle7_parser,
+			buffer,
+			length
+		);
+		break;
+	default:
+		tcpclv4_reset_parsers(link);
+		return 0;
+	}
+
+	// If the bundle cannot be parsed, e.g. because it exceeds the quota,
+	// refuse the transfer early instead of absorbing all of it.
+	if (rx_data->cur_parser->status == PARSER_STATUS_ERROR &&
+			param->rx_in_transfer && !param->rx_discard)
+		tcpclv4_refuse_transfer(param, TCPCLV4_REFUSE_NOT_ACCEPTABLE);
+
+	return result;
+}
+
+/*
+ * TX
+ */
+
+static void tcpclv4_send_segment(
+	struct tcpclv4_contact_parameters *const param,
+	const void *const data, const size_t data_length, const bool end)
+{
+	struct cla_link *const link = &param->link.base;
+	const size_t length = param->tx_fill + data_length;
+	uint8_t flags = 0;
+
+	if (param->tx_transfer_sent == 0)
+		flags |= TCPCLV4_SEGMENT_FLAG_START;
+	if (end || param->tx_transfer_sent + length >=
+			param->tx_transfer_length)
+		flags |= TCPCLV4_SEGMENT_FLAG_END;
+
+	uint8_t header[TCPCLV4_MAX_SEGMENT_HEADER_SIZE +
+		       TCPCLV4_TRANSFER_LENGTH_ITEM_SIZE];
+	const size_t header_length = tcpclv4_prepend_segment_header(
+		&header[sizeof(header)],
+		flags,
+		param->tx_transfer_id,
+		param->tx_transfer_length,
+		length
+	);
+	struct iovec iov[3] = {
+		{
+			.iov_base = &header[sizeof(header) - header_length],
+			.iov_len = header_length,
+		},
+		{ .iov_base = param->tx_buffer, .iov_len = param->tx_fill },
+		{ .iov_base = (void *)data, .iov_len = data_length },
+	};
+
+	// Stop sending as soon as the peer has refused the transfer.
+	hal_semaphore_take_blocking(param->ctrl_sem);
+
+	const bool refused = (
+		param->tx_refused &&
+		param->tx_refused_transfer_id == param->tx_transfer_id
+	);
+
+	hal_semaphore_release(param->ctrl_sem);
+	if (refused) {
+		param->tx_transfer_aborted = true;
+		param->tx_fill = 0;
+		return;
+	}
+
+	hal_semaphore_take_blocking(param->send_sem);
+
+	ssize_t result = tcp_send_all_iov(param->socket, iov, 3);
+
+	// Messages queued by the RX task meanwhile are sent by us, until the
+	// queue is found empty after releasing the semaphore.
+	for (;;) {
+		if (result > 0 && tcpclv4_flush_control(param, 0) != UD3TN_OK)
+			result = -1;
+		hal_semaphore_release(param->send_sem);
+		if (result <= 0 || !tcpclv4_control_pending(param))
+			break;
+		hal_semaphore_take_blocking(param->send_sem);
+	}
+
+	param->tx_transfer_sent += length;
+	param->tx_fill = 0;
+	if (HAS_FLAG(flags, TCPCLV4_SEGMENT_FLAG_END))
+		param->tx_end_sent = true;
+
+	if (result <= 0) {
+		LOGF("TCPCLv4: Error sending segment: %s", strerror(errno));
+		param->tx_transfer_aborted = true;
+		link->tx_packet_failed = true;
+		link->config->vtable->cla_disconnect_handler(link);
+	}
+}
+
+static void tcpclv4_begin_packet(struct cla_link *link, size_t length,
+				 char *cla_addr)
+{
+	struct tcpclv4_contact_parameters *const param =
+		(struct tcpclv4_contact_parameters *)link;
+
+	(void)cla_addr;
+	ASSERT(param->state == TCPCLV4_ESTABLISHED);
+
+	param->tx_transfer_id = param->tx_next_transfer_id++;
+	param->tx_transfer_length = length;
+	param->tx_transfer_sent = 0;
+	param->tx_fill = 0;
+	param->tx_end_sent = false;
+	param->tx_transfer_aborted = !link->active;
+
+	if (length > param->peer_transfer_mru) {
+		LOGF("TCPCLv4: Bundle of %zu byte(s) exceeds transfer MRU of \"%s\"",
+		     length, param->eid);
+		param->tx_transfer_aborted = true;
+	}
+	// Transfers refused by the peer later on count as handed over.
+	link->tx_packet_failed = param->tx_transfer_aborted;
+}
+
+static void tcpclv4_end_packet(struct cla_link *link)
+{
+	struct tcpclv4_contact_parameters *const param =
+		(struct tcpclv4_contact_parameters *)link;
+
+	ASSERT(param->state == TCPCLV4_ESTABLISHED);
+	if (!link->active || param->tx_transfer_aborted)
+		return;
+
+	// Flush the remainder - does not wait for any XFER_ACK.
+	if (param->tx_fill || !param->tx_end_sent)
+		tcpclv4_send_segment(param, NULL, 0, true);
+}
+
+static void tcpclv4_send_packet_data(
+	struct cla_link *link, const void *data, const size_t length)
+{
+	struct tcpclv4_contact_parameters *const param =
+		(struct tcpclv4_contact_parameters *)link;
+	const uint8_t *cur = data;
+	size_t remaining = length;
+
+	ASSERT(param->state == TCPCLV4_ESTABLISHED);
+
+	while (remaining && link->active && !param->tx_transfer_aborted) {
+		const size_t segment_size = param->tx_segment_size;
+
+		// Large chunks are sent directly, without copying.
+		if (param->tx_fill == 0 && remaining >= segment_size) {
+			tcpclv4_send_segment(param, cur, segment_size, false);
+			cur += segment_size;
+			remaining -= segment_size;
+			continue;
+		}
+
+		const size_t to_copy = MIN(
+			remaining,
+			segment_size - param->tx_fill
+		);
+
+		memcpy(&param->tx_buffer[param->tx_fill], cur, to_copy);
+		param->tx_fill += to_copy;
+		cur += to_copy;
+		remaining -= to_copy;
+
+		if (param->tx_fill == segment_size ||
+				param->tx_transfer_sent + param->tx_fill >=
+					param->tx_transfer_length)
+			tcpclv4_send_segment(param, NULL, 0, false);
+	}
+}
+
+/*
+ * INIT
+ */
+
+const struct cla_vtable tcpclv4_vtable = {
+	.cla_name_get = tcpclv4_name_get,
+	.cla_launch = tcpclv4_launch,
+	.cla_mbs_get = tcpclv4_mbs_get,
+
+	.cla_get_tx_queue = tcpclv4_get_tx_queue,
+	.cla_start_scheduled_contact = tcpclv4_start_scheduled_contact,
+	.cla_end_scheduled_contact = tcpclv4_end_scheduled_contact,
+
+	.cla_begin_packet = tcpclv4_begin_packet,
+	.cla_end_packet = tcpclv4_end_packet,
+	.cla_send_packet_data = tcpclv4_send_packet_data,
+
+	.cla_rx_task_reset_parsers = tcpclv4_reset_parsers,
+	.cla_rx_task_forward_to_specific_parser =
+			&tcpclv4_forward_to_specific_parser,
+
+	.cla_read = tcpclv4_read,
+
+	.cla_disconnect_handler = cla_tcp_disconnect_handler,
+};
+
+static enum ud3tn_result tcpclv4_init(
+	struct tcpclv4_config *config,
+	const char *node, const char *service,
+	const struct bundle_agent_interface *bundle_agent_interface)
+{
+	/* Initialize base_config */
+	if (cla_tcp_config_init(&config->base,
+				bundle_agent_interface) != UD3TN_OK)
+		return UD3TN_FAIL;
+
+	/* set base_config vtable */
+	config->base.base.vtable = &tcpclv4_vtable;
+
+	if (hashmap_init(&config->param_htab, CLA_TCP_PARAM_HTAB_SLOT_COUNT,
+			 false) != UD3TN_OK)
+		return UD3TN_FAIL;
+
+	config->param_htab_sem = hal_semaphore_init_binary();
+	hal_semaphore_release(config->param_htab_sem);
+
+	/* Start listening */
+	if (cla_tcp_listen(&config->base, node, service,
+			   CLA_TCP_MULTI_BACKLOG)
+			!= UD3TN_OK)
+		return UD3TN_FAIL;
+
+	return UD3TN_OK;
+}
+
+struct cla_config *tcpclv4_create(
+	const char *const options[], const size_t option_count,
+	const struct bundle_agent_interface *bundle_agent_interface)
+{
+	if (option_count != 2) {
+		LOG("TCPCLv4: Options format has to be: <IP>,<PORT>");
+		return NULL;
+	}
+
+	struct tcpclv4_config *config = malloc(sizeof(struct tcpclv4_config));
+
+	if (!config) {
+		LOG("TCPCLv4: Memory allocation failed!");
+		return NULL;
+	}
+
+	if (tcpclv4_init(config, options[0], options[1],
+			 bundle_agent_interface) != UD3TN_OK) {
+		free(config);
+		LOG("TCPCLv4: Initialization failed!");
+		return NULL;
+	}
+
+	return &config->base.base;
+}
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#include "cla/posix/cla_tcpclv4_proto.h"
+
+#include "ud3tn/common.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// INTEGER CODING (network byte order)
+
+void tcpclv4_write_u16(uint8_t *buffer, const uint16_t value)
+{
+	buffer[0] = (value >> 8) & 0xFF;
+	buffer[1] = value & 0xFF;
+}
+
+void tcpclv4_write_u32(uint8_t *buffer, const uint32_t value)
+{
+	tcpclv4_write_u16(buffer, value >> 16);
+	tcpclv4_write_u16(buffer + 2, value & 0xFFFF);
+}
+
+void tcpclv4_write_u64(uint8_t *buffer, const uint64_t value)
+{
+	tcpclv4_write_u32(buffer, value >> 32);
+	tcpclv4_write_u32(buffer + 4, value & 0xFFFFFFFF);
+}
+
+uint16_t tcpclv4_read_u16(const uint8_t *buffer)
+{
+	return ((uint16_t)buffer[0] << 8) | buffer[1];
+}
+
+uint32_t tcpclv4_read_u32(const uint8_t *buffer)
+{
+	return ((uint32_t)tcpclv4_read_u16(buffer) << 16) |
+		tcpclv4_read_u16(buffer + 2);
+}
+
+uint64_t tcpclv4_read_u64(const uint8_t *buffer)
+{
+	return ((uint64_t)tcpclv4_read_u32(buffer) << 32) |
+		tcpclv4_read_u32(buffer + 4);
+}
+
+// HANDSHAKE
+
+void tcpclv4_generate_contact_header(uint8_t *buffer)
+{
+	// Write magic into packet (string "dtn!").
+	buffer[0] = 'd';
+	buffer[1] = 't';
+	buffer[2] = 'n';
+	buffer[3] = '!';
+
+	// Put version number into packet (RFC 9174 -> 4).
+	buffer[4] = TCPCLV4_VERSION;
+
+	// TLS is not supported, thus, CAN_TLS is not set.
+	buffer[5] = 0x00;
+}
+
+uint8_t *tcpclv4_generate_sess_init(
+	const char *const local_node_id, const uint16_t keepalive_interval,
+	const uint64_t segment_mru, const uint64_t transfer_mru, size_t *len)
+{
+	const size_t node_id_len = strlen(local_node_id);
+
+	if (node_id_len > UINT16_MAX)
+		return NULL;
+
+	// Fixed part, Node ID, and the (empty) session extension items length
+	const size_t msg_len = TCPCLV4_SESS_INIT_FIXED_SIZE + node_id_len + 4;
+	uint8_t *const msg = malloc(msg_len);
+
+	if (!msg)
+		return NULL;
+
+	msg[0] = TCPCLV4_TYPE_SESS_INIT;
+	tcpclv4_write_u16(&msg[1], keepalive_interval);
+	tcpclv4_write_u64(&msg[3], segment_mru);
+	tcpclv4_write_u64(&msg[11], transfer_mru);
+	tcpclv4_write_u16(&msg[19], (uint16_t)node_id_len);
+	memcpy(&msg[21], local_node_id, node_id_len);
+	// We do not send any session extension items.
+	tcpclv4_write_u32(&msg[21 + node_id_len], 0);
+
+	*len = msg_len;
+	return msg;
+}
+
+// SERIALIZER
+
+size_t tcpclv4_prepend_segment_header(
+	uint8_t *data_start, const uint8_t flags, const uint64_t transfer_id,
+	const uint64_t transfer_length, const uint64_t data_length)
+{
+	const bool is_start = HAS_FLAG(flags, TCPCLV4_SEGMENT_FLAG_START);
+	const size_t ext_len = is_start ? TCPCLV4_TRANSFER_LENGTH_ITEM_SIZE : 0;
+	const size_t header_len = (
+		1 + 1 + 8 + (is_start ? 4 : 0) + ext_len + 8
+	);
+	uint8_t *const header = data_start - header_len;
+	uint8_t *cur = header;
+
+	cur[0] = TCPCLV4_TYPE_XFER_SEGMENT;
+	cur[1] = flags;
+	tcpclv4_write_u64(&cur[2], transfer_id);
+	cur += 10;
+
+	if (is_start) {
+		tcpclv4_write_u32(cur, (uint32_t)ext_len);
+		// Transfer Length extension item, not critical
+		cur[4] = 0x00;
+		tcpclv4_write_u16(&cur[5], TCPCLV4_TRANSFER_EXTENSION_LENGTH);
+		tcpclv4_write_u16(&cur[7], 8);
+		tcpclv4_write_u64(&cur[9], transfer_length);
+		cur += 4 + ext_len;
+	}
+
+	tcpclv4_write_u64(cur, data_length);
+	ASSERT(cur + 8 == data_start);
+
+	return header_len;
+}
+
+void tcpclv4_generate_xfer_ack(uint8_t *buffer, const uint8_t flags,
+			       const uint64_t transfer_id,
+			       const uint64_t ack_length)
+{
+	buffer[0] = TCPCLV4_TYPE_XFER_ACK;
+	buffer[1] = flags;
+	tcpclv4_write_u64(&buffer[2], transfer_id);
+	tcpclv4_write_u64(&buffer[10], ack_length);
+}
+
+void tcpclv4_generate_xfer_refuse(uint8_t *buffer, const uint8_t reason,
+				  const uint64_t transfer_id)
+{
+	buffer[0] = TCPCLV4_TYPE_XFER_REFUSE;
+	buffer[1] = reason;
+	tcpclv4_write_u64(&buffer[2], transfer_id);
+}
+
+void tcpclv4_generate_sess_term(uint8_t *buffer, const uint8_t flags,
+				const uint8_t reason)
+{
+	buffer[0] = TCPCLV4_TYPE_SESS_TERM;
+	buffer[1] = flags;
+	buffer[2] = reason;
+}
+
+void tcpclv4_generate_msg_reject(uint8_t *buffer, const uint8_t reason,
+				 const uint8_t rejected_header)
+{
+	buffer[0] = TCPCLV4_TYPE_MSG_REJECT;
+	buffer[1] = reason;
+	buffer[2] = rejected_header;
+}
+
+// EXTENSION ITEMS
+
+int tcpclv4_parse_transfer_extensions(
+	const uint8_t *items, size_t length, uint64_t *transfer_length)
+{
+	while (length) {
+		// Item flags, item type, item length
+		if (length < 5)
+			return -1;
+
+		const uint8_t item_flags = items[0];
+		const uint16_t item_type = tcpclv4_read_u16(&items[1]);
+		const uint16_t item_length = tcpclv4_read_u16(&items[3]);
+
+		items += 5;
+		length -= 5;
+		if (item_length > length)
+			return -1;
+
+		if (item_type == TCPCLV4_TRANSFER_EXTENSION_LENGTH &&
+				item_length == 8) {
+			if (transfer_length)
+				*transfer_length = tcpclv4_read_u64(items);
+		} else if (HAS_FLAG(item_flags,
+				    TCPCLV4_EXTENSION_FLAG_CRITICAL)) {
+			return -1;
+		}
+
+		items += item_length;
+		length -= item_length;
+	}
+
+	return 0;
+}
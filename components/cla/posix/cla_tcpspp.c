@@ -30,6 +30,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 // Buffer size for serialization
@@ -64,6 +65,11 @@ struct tcpspp_config {
 	enum cla_tcpspp_payload_type tcpspp_payload_type;
 	struct spp_parser spp_parser;
 	struct crc16_parser crc_parser;
+
+	// The complete SPP is assembled here to send it with a single call.
+	uint8_t *tx_buffer;
+	size_t tx_buffer_fill;
+	size_t tx_packet_size;
 };
 
 static void tcpspp_link_creation_task(void *param)
@@ -130,16 +136,9 @@ static size_t crc16_parser_read(struct crc16_parser *parser,
 				const uint8_t *buffer,
 				size_t length)
 {
-	const size_t remaining = 2 - parser->ctr;
-	size_t consumed = 0;
-
-	if (length <= remaining)
-		consumed = length;
-	else
-		consumed = remaining;
+	const size_t consumed = MIN(length, 2 - parser->ctr);
 
-	for (size_t i = 0; i < consumed; i++)
-		parser->crc[parser->ctr + i] = buffer[i];
+	memcpy(&parser->crc[parser->ctr], buffer, consumed);
 
 	parser->ctr += consumed;
 	if (parser->ctr >= 2)
@@ -319,7 +318,6 @@ size_t tcpspp_forward_to_specific_parser(struct cla_link *link,
 
 static void tcpspp_begin_packet(struct cla_link *link, size_t length, char *cla_addr)
 {
-	struct cla_tcp_link *const tcp_link = (struct cla_tcp_link *)link;
 	struct tcpspp_config *const tcpspp_config_ =
 		(struct tcpspp_config *)link->config;
 
@@ -331,8 +329,7 @@ static void tcpspp_begin_packet(struct cla_link *link, size_t length, char *cla_
 		length += 2;
 
 	size_t spp_length = spp_get_size(tcpspp_config_->spp_ctx, length);
-	uint8_t header_buf[MAX_SPP_HEADER_SIZE];
-	uint8_t *header_end = &header_buf[0];
+	uint8_t *header_end = tcpspp_config_->tx_buffer;
 
 	ASSERT(spp_length - length <= MAX_SPP_HEADER_SIZE);
 	ASSERT(spp_length <= CLA_TCPSPP_SPP_MAX_SIZE);
@@ -353,20 +350,8 @@ static void tcpspp_begin_packet(struct cla_link *link, size_t length, char *cla_
 		&header_end
 	);
 
-	if (CLA_TCPSPP_USE_CRC) {
-		crc_init(&tcpspp_config_->crc16, CRC16_CCITT_FALSE);
-		crc_feed_bytes(
-			&tcpspp_config_->crc16,
-			&header_buf[0],
-			header_end - &header_buf[0]
-		);
-	}
-
-	if (tcp_send_all(tcp_link->connection_socket, header_buf,
-			 header_end - &header_buf[0]) == -1) {
-		LOG("tcpspp: Error during sending. Data discarded.");
-		link->config->vtable->cla_disconnect_handler(link);
-	}
+	tcpspp_config_->tx_buffer_fill = header_end - tcpspp_config_->tx_buffer;
+	tcpspp_config_->tx_packet_size = spp_length;
 }
 
 static void tcpspp_end_packet(struct cla_link *link)
@@ -374,29 +359,44 @@ static void tcpspp_end_packet(struct cla_link *link)
 	struct cla_tcp_link *tcp_link = (struct cla_tcp_link *)link;
 	struct tcpspp_config *tcpspp_config_ =
 		(struct tcpspp_config *)link->config;
+	uint8_t *const tx_buffer = tcpspp_config_->tx_buffer;
 
 	// A previous operation may have canceled the sending process.
 	if (!link->active)
 		return;
 
 	if (CLA_TCPSPP_USE_CRC) {
+		crc_init(&tcpspp_config_->crc16, CRC16_CCITT_FALSE);
+		crc_feed_bytes(
+			&tcpspp_config_->crc16,
+			tx_buffer,
+			tcpspp_config_->tx_buffer_fill
+		);
 		tcpspp_config_->crc16.feed_eof(&tcpspp_config_->crc16);
+
 		const uint8_t *crc16 = tcpspp_config_->crc16.bytes;
+
 		// Big Endian (Network Byte Order) is necessary
-		const uint8_t crc16_be[2] = { crc16[1], crc16[0] };
+		tx_buffer[tcpspp_config_->tx_buffer_fill++] = crc16[1];
+		tx_buffer[tcpspp_config_->tx_buffer_fill++] = crc16[0];
+	}
 
-		if (tcp_send_all(tcp_link->connection_socket, crc16_be, 2)
-				== -1) {
-			LOG("tcpspp: Error during sending. Data discarded.");
-			link->config->vtable->cla_disconnect_handler(link);
-		}
+	if (tcpspp_config_->tx_buffer_fill != tcpspp_config_->tx_packet_size) {
+		LOG("tcpspp: Serialized bundle does not match announced size!");
+		link->config->vtable->cla_disconnect_handler(link);
+		return;
+	}
+
+	if (tcp_send_all(tcp_link->connection_socket, tx_buffer,
+			 tcpspp_config_->tx_buffer_fill) == -1) {
+		LOG("tcpspp: Error during sending. Data discarded.");
+		link->config->vtable->cla_disconnect_handler(link);
 	}
 }
 
 static void tcpspp_send_packet_data(
 	struct cla_link *link, const void *data, const size_t length)
 {
-	struct cla_tcp_link *const tcp_link = (struct cla_tcp_link *)link;
 	struct tcpspp_config *tcpspp_config_
 		= (struct tcpspp_config *)link->config;
 
@@ -404,13 +404,17 @@ static void tcpspp_send_packet_data(
 	if (!link->active)
 		return;
 
-	if (tcp_send_all(tcp_link->connection_socket, data, length) == -1) {
-		LOG("tcpspp: Error during sending. Data discarded.");
+	// Space for the CRC is included in the announced packet size.
+	if (tcpspp_config_->tx_buffer_fill + length >
+			tcpspp_config_->tx_packet_size) {
+		LOG("tcpspp: Serialized bundle exceeds announced size!");
 		link->config->vtable->cla_disconnect_handler(link);
+		return;
 	}
 
-	if (CLA_TCPSPP_USE_CRC)
-		crc_feed_bytes(&tcpspp_config_->crc16, data, length);
+	memcpy(&tcpspp_config_->tx_buffer[tcpspp_config_->tx_buffer_fill],
+	       data, length);
+	tcpspp_config_->tx_buffer_fill += length;
 }
 
 // Public API for Initialization
@@ -453,6 +457,12 @@ static enum ud3tn_result tcpspp_init(
 	config->base.node = strdup(node);
 	config->base.service = strdup(service);
 
+	config->tx_buffer = malloc(CLA_TCPSPP_SPP_MAX_SIZE);
+	if (!config->tx_buffer)
+		return UD3TN_FAIL;
+	config->tx_buffer_fill = 0;
+	config->tx_packet_size = 0;
+
 	/* Set cla_config vtable */
 	config->base.base.base.vtable = &tcpspp_vtable;
 
@@ -0,0 +1,826 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#define _GNU_SOURCE // for recvmmsg() and sendmmsg()
+
+#include "cla/cla.h"
+#include "cla/cla_contact_rx_task.h"
+#include "cla/cla_contact_tx_task.h"
+#include "cla/posix/cla_udp.h"
+
+#include "bundle6/parser.h"
+#include "bundle7/parser.h"
+
+#include "platform/hal_config.h"
+#include "platform/hal_io.h"
+#include "platform/hal_queue.h"
+#include "platform/hal_semaphore.h"
+#include "platform/hal_task.h"
+#include "platform/hal_time.h"
+
+#include "ud3tn/bundle_processor.h"
+#include "ud3tn/common.h"
+#include "ud3tn/config.h"
+#include "ud3tn/result.h"
+#include "ud3tn/simplehtab.h"
+#include "ud3tn/task_tags.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct udp_config {
+	struct cla_config base;
+
+	/* The bound socket, used for RX and TX */
+	int socket;
+
+	Task_t rx_task;
+
+	/* Max. bundle size, as every bundle is sent as a single datagram */
+	size_t max_datagram_size;
+
+	/* Max. sending rate per peer in bytes per second, 0 = unlimited */
+	uint64_t pacing_rate;
+
+	/* Link instance holding the RX parser state - has no tasks. */
+	struct cla_link rx_link;
+
+	struct htab_entrylist *param_htab_elem[CLA_UDP_PARAM_HTAB_SLOT_COUNT];
+	struct htab param_htab;
+	Semaphore_t param_htab_sem;
+};
+
+struct udp_link {
+	// IMPORTANT: The link is only initialized iff established == true
+	struct cla_link base;
+
+	struct udp_config *config;
+
+	Task_t management_task;
+
+	char *cla_sock_addr;
+	struct sockaddr_storage peer_addr;
+	socklen_t peer_addr_len;
+
+	bool established;
+
+	/* Datagrams collected by the TX task until they are flushed */
+	uint8_t *tx_buffers;
+	struct mmsghdr tx_msgs[CLA_UDP_TX_BATCH_SIZE];
+	struct iovec tx_iov[CLA_UDP_TX_BATCH_SIZE];
+	size_t tx_count;
+	size_t tx_fill;
+	bool tx_discard;
+
+	/* Token bucket for pacing the datagrams sent to the peer */
+	int64_t pacing_tokens;
+	uint64_t pacing_last_ms;
+};
+
+/*
+ * MGMT
+ */
+
+static enum ud3tn_result udp_resolve_addr(const char *cla_sock_addr,
+					  struct sockaddr_storage *addr,
+					  socklen_t *addr_len)
+{
+	char *const tmp = strdup(cla_sock_addr);
+	char *node, *service;
+
+	if (!tmp)
+		return UD3TN_FAIL;
+
+	// Split the address into node and service, see also
+	// cla_tcp_connect_to_cla_addr() - the port is mandatory here.
+	if (tmp[0] == '[') {
+		service = strrchr(tmp, ']');
+		if (!service || service[1] != ':' || service[2] == 0)
+			goto fail;
+		service[0] = 0;
+		service = &service[2];
+		node = &tmp[1];
+	} else {
+		service = strrchr(tmp, ':');
+		if (!service || service[1] == 0)
+			goto fail;
+		service[0] = 0;
+		service = &service[1];
+		node = tmp;
+	}
+
+	struct addrinfo hints;
+	struct addrinfo *result;
+
+	memset(&hints, 0, sizeof(struct addrinfo));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_DGRAM;
+	hints.ai_flags = AI_V4MAPPED;
+
+	const int status = getaddrinfo(node, service, &hints, &result);
+
+	if (status != 0) {
+		LOGF("UDP: getaddrinfo() failed for %s: %s",
+		     cla_sock_addr, gai_strerror(status));
+		free(tmp);
+		return UD3TN_FAIL;
+	}
+
+	ASSERT(result->ai_addrlen <= sizeof(struct sockaddr_storage));
+	memcpy(addr, result->ai_addr, result->ai_addrlen);
+	*addr_len = result->ai_addrlen;
+	freeaddrinfo(result);
+	free(tmp);
+	return UD3TN_OK;
+
+fail:
+	LOGF("UDP: Invalid CLA address \"%s\", format is <HOST>:<PORT>",
+	     cla_sock_addr);
+	free(tmp);
+	return UD3TN_FAIL;
+}
+
+static int udp_create_socket(const char *node, const char *service)
+{
+	const int disable = 0;
+	struct addrinfo hints;
+	struct addrinfo *result, *e;
+	int sock = -1;
+
+	// As for TCP, "*" means binding to all interfaces.
+	if (strcmp(node, "*") == 0)
+		node = NULL;
+
+	memset(&hints, 0, sizeof(struct addrinfo));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_DGRAM;
+	hints.ai_flags = AI_V4MAPPED | AI_PASSIVE;
+
+	const int status = getaddrinfo(node, service, &hints, &result);
+
+	if (status != 0) {
+		LOGF("UDP: getaddrinfo() failed for %s:%s: %s",
+		     node ? node : "*", service, gai_strerror(status));
+		return -1;
+	}
+
+	for (e = result; e != NULL; e = e->ai_next) {
+		sock = socket(e->ai_family, e->ai_socktype, e->ai_protocol);
+		if (sock == -1)
+			continue;
+
+		// Allow to send to IPv4 peers from an IPv6 socket.
+		if (e->ai_family == AF_INET6 &&
+				setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY,
+					   &disable, sizeof(int)) < 0) {
+			LOGF("UDP: setsockopt(IPV6_V6ONLY, 0): %s",
+			     strerror(errno));
+			close(sock);
+			sock = -1;
+			continue;
+		}
+
+		if (bind(sock, e->ai_addr, e->ai_addrlen) == 0)
+			break;
+
+		LOGF("UDP: bind(): %s", strerror(errno));
+		close(sock);
+		sock = -1;
+	}
+
+	freeaddrinfo(result);
+	return sock;
+}
+
+static void udp_link_management_task(void *p)
+{
+	struct udp_link *const link = p;
+	struct udp_config *const udp_config = link->config;
+
+	if (cla_link_init(&link->base, &udp_config->base,
+			  link->cla_sock_addr, false, true) != UD3TN_OK) {
+		LOG("UDP: Error initializing CLA link!");
+	} else {
+		link->established = true;
+		cla_link_wait_cleanup(&link->base);
+	}
+
+	LOGF("UDP: Terminating contact link manager for \"%s\"",
+	     link->cla_sock_addr);
+	hal_semaphore_take_blocking(udp_config->param_htab_sem);
+	htab_remove(&udp_config->param_htab, link->cla_sock_addr);
+	hal_semaphore_release(udp_config->param_htab_sem);
+	free(link->cla_sock_addr);
+	free(link->tx_buffers);
+
+	Task_t management_task = link->management_task;
+
+	free(link);
+	hal_task_delete(management_task);
+}
+
+static void launch_link_management_task(struct udp_config *const udp_config,
+					const char *cla_addr)
+{
+	struct udp_link *const link = malloc(sizeof(struct udp_link));
+
+	if (!link) {
+		LOG("UDP: Failed to allocate memory!");
+		return;
+	}
+
+	link->config = udp_config;
+	link->established = false;
+	link->tx_count = 0;
+	link->tx_fill = 0;
+	link->tx_discard = false;
+	link->pacing_tokens = 0;
+	link->pacing_last_ms = hal_time_get_timestamp_ms();
+	link->cla_sock_addr = cla_get_connect_addr(cla_addr, "udp");
+	link->tx_buffers = malloc(
+		udp_config->max_datagram_size * CLA_UDP_TX_BATCH_SIZE
+	);
+	if (!link->cla_sock_addr || !link->tx_buffers) {
+		LOG("UDP: Failed to allocate memory!");
+		goto fail;
+	}
+
+	if (udp_resolve_addr(link->cla_sock_addr, &link->peer_addr,
+			     &link->peer_addr_len) != UD3TN_OK)
+		goto fail;
+
+	// The message headers always point to the same buffers.
+	memset(link->tx_msgs, 0, sizeof(link->tx_msgs));
+	for (size_t i = 0; i < CLA_UDP_TX_BATCH_SIZE; i++) {
+		link->tx_iov[i].iov_base = (
+			&link->tx_buffers[i * udp_config->max_datagram_size]
+		);
+		link->tx_msgs[i].msg_hdr.msg_iov = &link->tx_iov[i];
+		link->tx_msgs[i].msg_hdr.msg_iovlen = 1;
+		link->tx_msgs[i].msg_hdr.msg_name = &link->peer_addr;
+		link->tx_msgs[i].msg_hdr.msg_namelen = link->peer_addr_len;
+	}
+
+	if (!htab_add(&udp_config->param_htab, link->cla_sock_addr, link)) {
+		LOG("UDP: Error creating htab entry!");
+		goto fail;
+	}
+
+	link->management_task = hal_task_create(
+		udp_link_management_task,
+		"udp_mgmt_t",
+		CONTACT_MANAGEMENT_TASK_PRIORITY,
+		link,
+		CONTACT_MANAGEMENT_TASK_STACK_SIZE,
+		(void *)CLA_SPECIFIC_TASK_TAG
+	);
+
+	if (!link->management_task) {
+		LOG("UDP: Error creating management task!");
+		ASSERT(htab_remove(
+			&udp_config->param_htab,
+			link->cla_sock_addr
+		) == link);
+		goto fail;
+	}
+
+	return;
+
+fail:
+	free(link->cla_sock_addr);
+	free(link->tx_buffers);
+	free(link);
+}
+
+/*
+ * RX
+ */
+
+static void udp_reset_parsers(struct cla_link *link)
+{
+	rx_task_reset_parsers(&link->rx_task_data);
+	link->rx_task_data.cur_parser = link->rx_task_data.bundle7_parser
+		.basedata;
+}
+
+static size_t udp_forward_to_specific_parser(struct cla_link *link,
+					     const uint8_t *buffer,
+					     size_t length)
+{
+	struct rx_task_data *const rx_data = &link->rx_task_data;
+
+	switch (rx_data->payload_type) {
+	case PAYLOAD_UNKNOWN:
+		return select_bundle_parser_version(rx_data, buffer, length);
+	case PAYLOAD_BUNDLE6:
+		rx_data->cur_parser = rx_data->bundle6_parser.basedata;
+		return bundle6_parser_read(
+			&rx_data->bundle6_parser,
+			buffer,
+			length
+		);
+	case PAYLOAD_BUNDLE7:
+		rx_data->cur_parser = rx_data->bundle7_parser.basedata;
+		return bundle7_parser_read(
+			&rx_data->bundle7_parser,
+			buffer,
+			length
+		);
+	default:
+		udp_reset_parsers(link);
+		return 0;
+	}
+}
+
+// Every datagram contains exactly one bundle, thus, it can be parsed in one
+// shot. Bulk reads requested by the parsers are served from the datagram.
+static void udp_parse_datagram(struct cla_link *link,
+			       const uint8_t *data, size_t length)
+{
+	struct rx_task_data *const rx_data = &link->rx_task_data;
+
+	udp_reset_parsers(link);
+	while (length) {
+		const size_t parsed = udp_forward_to_specific_parser(
+			link,
+			data,
+			length
+		);
+
+		data += parsed;
+		length -= parsed;
+
+		if (rx_data->cur_parser->status != PARSER_STATUS_GOOD)
+			break;
+
+		if (HAS_FLAG(rx_data->cur_parser->flags,
+			     PARSER_FLAG_BULK_READ)) {
+			const size_t bulk = rx_data->cur_parser->next_bytes;
+
+			if (bulk > length)
+				break;
+			memcpy(rx_data->cur_parser->next_buffer, data, bulk);
+			data += bulk;
+			length -= bulk;
+			rx_data->cur_parser->flags &= ~PARSER_FLAG_BULK_READ;
+			udp_forward_to_specific_parser(link, NULL, 0);
+		} else if (parsed == 0) {
+			break;
+		}
+	}
+
+	if (rx_data->cur_parser->status != PARSER_STATUS_DONE)
+		LOG("UDP: Dropping datagram not containing a valid bundle");
+	udp_reset_parsers(link);
+}
+
+static void udp_rx_task(void *p)
+{
+	struct udp_config *const udp_config = p;
+	const size_t buffer_size = udp_config->max_datagram_size;
+	uint8_t *const buffers = malloc(buffer_size * CLA_UDP_RX_BATCH_SIZE);
+	struct mmsghdr msgs[CLA_UDP_RX_BATCH_SIZE];
+	struct iovec iov[CLA_UDP_RX_BATCH_SIZE];
+
+	ASSERT(buffers != NULL);
+	memset(msgs, 0, sizeof(msgs));
+	for (size_t i = 0; i < CLA_UDP_RX_BATCH_SIZE; i++) {
+		iov[i].iov_base = &buffers[i * buffer_size];
+		iov[i].iov_len = buffer_size;
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	for (;;) {
+		// Block until at least one datagram is there, then take all
+		// others that are already queued in the same system call.
+		const int count = recvmmsg(
+			udp_config->socket,
+			msgs,
+			CLA_UDP_RX_BATCH_SIZE,
+			MSG_WAITFORONE,
+			NULL
+		);
+
+		if (count < 0) {
+			if (errno == EINTR || errno == EAGAIN)
+				continue;
+			LOGF("UDP: recvmmsg() failed: %s", strerror(errno));
+			break;
+		}
+
+		for (int i = 0; i < count; i++) {
+			if (HAS_FLAG(msgs[i].msg_hdr.msg_flags, MSG_TRUNC)) {
+				LOG("UDP: Dropping datagram exceeding max. size");
+				continue;
+			}
+			udp_parse_datagram(
+				&udp_config->rx_link,
+				iov[i].iov_base,
+				msgs[i].msg_len
+			);
+		}
+	}
+
+	free(buffers);
+	// unexpected failure to receive - exit thread in release mode
+	ASSERT(0);
+}
+
+static enum ud3tn_result udp_read(struct cla_link *link,
+				  uint8_t *buffer, size_t length,
+				  size_t *bytes_read)
+{
+	(void)link;
+	(void)buffer;
+	(void)length;
+	(void)bytes_read;
+	// Datagrams are received by the CLA-wide RX task, not per link.
+	return UD3TN_FAIL;
+}
+
+/*
+ * API
+ */
+
+static enum ud3tn_result udp_launch(struct cla_config *const config)
+{
+	struct udp_config *const udp_config = (struct udp_config *)config;
+
+	udp_config->rx_task = hal_task_create(
+		udp_rx_task,
+		"udp_rx_t",
+		CONTACT_RX_TASK_PRIORITY,
+		config,
+		CONTACT_RX_TASK_STACK_SIZE,
+		(void *)CLA_SPECIFIC_TASK_TAG
+	);
+
+	if (!udp_config->rx_task)
+		return UD3TN_FAIL;
+
+	return UD3TN_OK;
+}
+
+static const char *udp_name_get(void)
+{
+	return "udp";
+}
+
+static size_t udp_mbs_get(struct cla_config *const config)
+{
+	struct udp_config *const udp_config = (struct udp_config *)config;
+
+	// Larger bundles are fragmented proactively by the router.
+	return udp_config->max_datagram_size;
+}
+
+static struct udp_link *get_link(struct cla_config *config,
+				 const char *cla_addr)
+{
+	struct udp_config *const udp_config = (struct udp_config *)config;
+	char *const cla_sock_addr = cla_get_connect_addr(cla_addr, "udp");
+
+	if (!cla_sock_addr)
+		return NULL;
+
+	struct udp_link *const link = htab_get(
+		&udp_config->param_htab,
+		cla_sock_addr
+	);
+
+	free(cla_sock_addr);
+	return link;
+}
+
+static struct cla_tx_queue udp_get_tx_queue(
+	struct cla_config *config, const char *eid, const char *cla_addr)
+{
+	(void)eid;
+	struct udp_config *const udp_config = (struct udp_config *)config;
+
+	hal_semaphore_take_blocking(udp_config->param_htab_sem);
+	struct udp_link *const link = get_link(config, cla_addr);
+
+	if (link && link->established) {
+		hal_semaphore_take_blocking(link->base.tx_queue_sem);
+		hal_semaphore_release(udp_config->param_htab_sem);
+
+		// Freed while trying to obtain it
+		if (!link->base.tx_queue_handle)
+			return (struct cla_tx_queue){ NULL, NULL, NULL };
+
+		return (struct cla_tx_queue){
+			.tx_queue_handle = link->base.tx_queue_handle,
+			.tx_queue_sem = link->base.tx_queue_sem,
+			.tx_backlog = &link->base.tx_backlog,
+		};
+	}
+
+	hal_semaphore_release(udp_config->param_htab_sem);
+	return (struct cla_tx_queue){ NULL, NULL, NULL };
+}
+
+static enum ud3tn_result udp_start_scheduled_contact(
+	struct cla_config *config, const char *eid, const char *cla_addr)
+{
+	(void)eid;
+	struct udp_config *const udp_config = (struct udp_config *)config;
+
+	hal_semaphore_take_blocking(udp_config->param_htab_sem);
+	struct udp_link *const link = get_link(config, cla_addr);
+
+	if (link) {
+		LOGF("UDP: Link to \"%s\" already exists", cla_addr);
+		hal_semaphore_release(udp_config->param_htab_sem);
+		return UD3TN_OK;
+	}
+
+	// UDP is connectionless - the link is available right away.
+	launch_link_management_task(udp_config, cla_addr);
+	hal_semaphore_release(udp_config->param_htab_sem);
+
+	return UD3TN_OK;
+}
+
+static enum ud3tn_result udp_end_scheduled_contact(
+	struct cla_config *config, const char *eid, const char *cla_addr)
+{
+	(void)eid;
+	struct udp_config *const udp_config = (struct udp_config *)config;
+
+	hal_semaphore_take_blocking(udp_config->param_htab_sem);
+	struct udp_link *const link = get_link(config, cla_addr);
+
+	if (link && link->established && link->base.active) {
+		LOGF("UDP: Removing link to \"%s\"", cla_addr);
+		link->base.config->vtable->cla_disconnect_handler(&link->base);
+	}
+
+	hal_semaphore_release(udp_config->param_htab_sem);
+
+	return UD3TN_OK;
+}
+
+/*
+ * TX
+ */
+
+static void udp_pace(struct udp_link *const link, const size_t bytes)
+{
+	const uint64_t rate = link->config->pacing_rate;
+
+	if (!rate)
+		return;
+
+	const uint64_t now = hal_time_get_timestamp_ms();
+	// Allow bursts of up to CLA_UDP_PACING_BURST_MS worth of data.
+	const int64_t max_tokens = MAX(
+		(int64_t)(rate * CLA_UDP_PACING_BURST_MS / 1000),
+		(int64_t)bytes
+	);
+
+	if (now > link->pacing_last_ms) {
+		link->pacing_tokens = MIN(
+			max_tokens,
+			link->pacing_tokens +
+				(int64_t)((now - link->pacing_last_ms) *
+					  rate / 1000)
+		);
+		link->pacing_last_ms = now;
+	}
+
+	if (link->pacing_tokens < (int64_t)bytes) {
+		const uint64_t missing = bytes - link->pacing_tokens;
+		const uint64_t delay_ms = (missing * 1000 + rate - 1) / rate;
+
+		hal_task_delay(delay_ms);
+		link->pacing_tokens += delay_ms * rate / 1000;
+		link->pacing_last_ms += delay_ms;
+	}
+
+	link->pacing_tokens -= bytes;
+}
+
+static void udp_flush(struct cla_link *cla_link)
+{
+	struct udp_link *const link = (struct udp_link *)cla_link;
+	size_t sent = 0;
+	size_t bytes = 0;
+
+	for (size_t i = 0; i < link->tx_count; i++)
+		bytes += link->tx_iov[i].iov_len;
+	udp_pace(link, bytes);
+
+	while (sent < link->tx_count) {
+		const int result = sendmmsg(
+			link->config->socket,
+			&link->tx_msgs[sent],
+			link->tx_count - sent,
+			0
+		);
+
+		if (result < 0) {
+			if (errno == EINTR || errno == EAGAIN)
+				continue;
+			// Datagrams are unreliable anyways, do not tear down,
+			// but let the remaining bundles be rescheduled.
+			LOGF("UDP: sendmmsg() to \"%s\" failed: %s",
+			     link->cla_sock_addr, strerror(errno));
+			break;
+		}
+		sent += result;
+	}
+
+	cla_link->tx_flushed_sent += sent;
+	cla_link->tx_flushed_dropped += link->tx_count - sent;
+	link->tx_count = 0;
+}
+
+static void udp_begin_packet(struct cla_link *cla_link, size_t length,
+			     char *cla_addr)
+{
+	struct udp_link *const link = (struct udp_link *)cla_link;
+
+	(void)cla_addr;
+	link->tx_fill = 0;
+	link->tx_discard = false;
+
+	if (length > link->config->max_datagram_size) {
+		LOGF("UDP: Bundle of %zu byte(s) exceeds max. datagram size, dropping",
+		     length);
+		link->tx_discard = true;
+	}
+}
+
+static void udp_end_packet(struct cla_link *cla_link)
+{
+	struct udp_link *const link = (struct udp_link *)cla_link;
+
+	if (link->tx_discard) {
+		cla_link->tx_packet_failed = true;
+		return;
+	}
+
+	link->tx_iov[link->tx_count].iov_len = link->tx_fill;
+	link->tx_count++;
+
+	if (link->tx_count == CLA_UDP_TX_BATCH_SIZE)
+		udp_flush(cla_link);
+}
+
+static void udp_send_packet_data(
+	struct cla_link *cla_link, const void *data, const size_t length)
+{
+	struct udp_link *const link = (struct udp_link *)cla_link;
+	const size_t max_size = link->config->max_datagram_size;
+
+	if (link->tx_discard)
+		return;
+
+	if (link->tx_fill + length > max_size) {
+		LOG("UDP: Serialized bundle exceeds max. datagram size, dropping");
+		link->tx_discard = true;
+		return;
+	}
+
+	memcpy(
+		&link->tx_buffers[link->tx_count * max_size + link->tx_fill],
+		data,
+		length
+	);
+	link->tx_fill += length;
+}
+
+/*
+ * INIT
+ */
+
+const struct cla_vtable udp_vtable = {
+	.cla_name_get = udp_name_get,
+	.cla_launch = udp_launch,
+	.cla_mbs_get = udp_mbs_get,
+
+	.cla_get_tx_queue = udp_get_tx_queue,
+	.cla_start_scheduled_contact = udp_start_scheduled_contact,
+	.cla_end_scheduled_contact = udp_end_scheduled_contact,
+
+	.cla_begin_packet = udp_begin_packet,
+	.cla_end_packet = udp_end_packet,
+	.cla_send_packet_data = udp_send_packet_data,
+	.cla_flush = udp_flush,
+
+	.cla_rx_task_reset_parsers = udp_reset_parsers,
+	.cla_rx_task_forward_to_specific_parser =
+		udp_forward_to_specific_parser,
+
+	.cla_read = udp_read,
+
+	.cla_disconnect_handler = cla_generic_disconnect_handler,
+};
+
+static enum ud3tn_result udp_init(
+	struct udp_config *config,
+	const char *node, const char *service,
+	const size_t max_datagram_size, const uint64_t pacing_rate,
+	const struct bundle_agent_interface *bundle_agent_interface)
+{
+	if (cla_config_init(&config->base, bundle_agent_interface) != UD3TN_OK)
+		return UD3TN_FAIL;
+
+	config->base.vtable = &udp_vtable;
+	config->max_datagram_size = max_datagram_size;
+	config->pacing_rate = pacing_rate;
+	config->rx_task = NULL;
+
+	config->rx_link.config = &config->base;
+	config->rx_link.active = true;
+	config->rx_link.cla_addr = NULL;
+	if (rx_task_data_init(&config->rx_link.rx_task_data,
+			      &config->base) != UD3TN_OK)
+		return UD3TN_FAIL;
+	udp_reset_parsers(&config->rx_link);
+
+	htab_init(&config->param_htab, CLA_UDP_PARAM_HTAB_SLOT_COUNT,
+		  config->param_htab_elem);
+
+	config->param_htab_sem = hal_semaphore_init_binary();
+	hal_semaphore_release(config->param_htab_sem);
+
+	config->socket = udp_create_socket(node, service);
+	if (config->socket < 0)
+		return UD3TN_FAIL;
+
+	LOGF("UDP: CLA udp is now bound to [%s]:%s", node, service);
+
+	return UD3TN_OK;
+}
+
+// Note that this is basically the same as parsing the TCPSPP APID.
+static enum ud3tn_result parse_size(const char *str, uint64_t *result)
+{
+	char *end;
+	unsigned long long val;
+
+	if (!str)
+		return UD3TN_FAIL;
+	errno = 0;
+	val = strtoull(str, &end, 10);
+	if (errno == ERANGE || end == str || *end != 0 || str[0] == '-')
+		return UD3TN_FAIL;
+	*result = (uint64_t)val;
+	return UD3TN_OK;
+}
+
+struct cla_config *udp_create(
+	const char *const options[], const size_t option_count,
+	const struct bundle_agent_interface *bundle_agent_interface)
+{
+	uint64_t max_datagram_size = CLA_UDP_MAX_DATAGRAM_SIZE;
+	uint64_t pacing_rate = 0;
+
+	if (option_count < 2 || option_count > 4) {
+		LOG("UDP: Options format is: <IP>,<PORT>[,<MAX_DATAGRAM_SIZE>[,<RATE_BYTES_PER_S>]]");
+		return NULL;
+	}
+
+	if (option_count > 2 &&
+			(parse_size(options[2], &max_datagram_size) != UD3TN_OK ||
+			 max_datagram_size == 0 ||
+			 max_datagram_size > CLA_UDP_MAX_DATAGRAM_SIZE_LIMIT)) {
+		LOGF("UDP: Could not parse max. datagram size: %s",
+		     options[2]);
+		return NULL;
+	}
+
+	if (option_count > 3 &&
+			parse_size(options[3], &pacing_rate) != UD3TN_OK) {
+		LOGF("UDP: Could not parse pacing rate: %s", options[3]);
+		return NULL;
+	}
+
+	struct udp_config *config = malloc(sizeof(struct udp_config));
+
+	if (!config) {
+		LOG("UDP: Memory allocation failed!");
+		return NULL;
+	}
+
+	if (udp_init(config, options[0], options[1], max_datagram_size,
+		     pacing_rate, bundle_agent_interface) != UD3TN_OK) {
+		free(config);
+		LOG("UDP: Initialization failed!");
+		return NULL;
+	}
+
+	return &config->base;
+}
@@ -0,0 +1,782 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#define _GNU_SOURCE // for memfd_create() and file sealing
+
+/*
+ * CLA for local links via AF_UNIX stream sockets, using the MTCP framing.
+ *
+ * Bundles of at least CLA_UNIX_MEMFD_THRESHOLD bytes are not streamed. The
+ * sender writes the complete MTCP frame into a sealed memfd and passes the
+ * descriptor via SCM_RIGHTS, attached to a single marker byte that cannot
+ * start a regular MTCP frame. The receiver maps the memfd and feeds the frame
+ * to the parser from the mapping.
+ */
+
+#include "cla/cla.h"
+#include "cla/cla_contact_tx_task.h"
+#include "cla/mtcp_proto.h"
+#include "cla/posix/cla_mtcp.h"
+#include "cla/posix/cla_tcp_common.h"
+#include "cla/posix/cla_tcp_util.h"
+#include "cla/posix/cla_unix.h"
+
+#include "platform/hal_config.h"
+#include "platform/hal_io.h"
+#include "platform/hal_queue.h"
+#include "platform/hal_semaphore.h"
+#include "platform/hal_task.h"
+
+#include "ud3tn/bundle_processor.h"
+#include "ud3tn/common.h"
+#include "ud3tn/config.h"
+#include "ud3tn/result.h"
+#include "ud3tn/simplehtab.h"
+#include "ud3tn/task_tags.h"
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// MTCP frames always start with a CBOR byte string header (major type 2).
+#define UNIX_MEMFD_MARKER 0x00
+
+struct unix_config {
+	struct cla_tcp_config base;
+
+	// Outgoing links, keyed by the socket path of the peer
+	struct htab_entrylist *param_htab_elem[CLA_TCP_PARAM_HTAB_SLOT_COUNT];
+	struct htab param_htab;
+	Semaphore_t param_htab_sem;
+};
+
+struct unix_link {
+	// IMPORTANT: The link is only initialized iff connected == true
+	struct mtcp_link base;
+
+	struct unix_config *config;
+
+	Task_t management_task;
+
+	// Socket path of the peer, NULL for incoming connections
+	char *path;
+
+	bool is_outgoing;
+	bool in_contact;
+	bool connected;
+	int connect_attempt;
+
+	int socket;
+
+	// Frame of the current outgoing bundle if it is passed via memfd
+	int tx_memfd;
+	uint8_t *tx_map;
+	size_t tx_map_size;
+	size_t tx_map_fill;
+
+	// Frame received via memfd which is currently handed to the parser
+	uint8_t *rx_map;
+	size_t rx_map_size;
+	size_t rx_map_offset;
+};
+
+/*
+ * MGMT
+ */
+
+static int unix_socket_create(const char *path, const bool client)
+{
+	struct sockaddr_un addr;
+
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		LOGF("UNIX: Socket path \"%s\" is too long", path);
+		return -1;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+
+	const int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+	if (sock < 0) {
+		LOGF("UNIX: socket(): %s", strerror(errno));
+		return -1;
+	}
+
+	if (client) {
+		if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+			LOGF("UNIX: connect(\"%s\"): %s",
+			     path, strerror(errno));
+			close(sock);
+			return -1;
+		}
+		return sock;
+	}
+
+	// Remove a socket file left behind by a previous instance.
+	unlink(path);
+	if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+			listen(sock, CLA_TCP_MULTI_BACKLOG) < 0) {
+		LOGF("UNIX: Listening on \"%s\" failed: %s",
+		     path, strerror(errno));
+		close(sock);
+		return -1;
+	}
+	return sock;
+}
+
+static void unix_link_management_task(void *p)
+{
+	struct unix_link *const link = p;
+	struct unix_config *const unix_config = link->config;
+
+	do {
+		if (link->connected) {
+			ASSERT(link->socket >= 0);
+			if (cla_tcp_link_init(&link->base.base, link->socket,
+					      &unix_config->base, link->path,
+					      link->is_outgoing) != UD3TN_OK) {
+				LOG("UNIX: Error initializing CLA link!");
+				close(link->socket);
+			} else {
+				cla_link_wait_cleanup(&link->base.base.base);
+			}
+			if (link->rx_map) {
+				munmap(link->rx_map, link->rx_map_size);
+				link->rx_map = NULL;
+			}
+			link->connected = false;
+			link->connect_attempt = 0;
+			link->socket = -1;
+		} else {
+			link->socket = unix_socket_create(link->path, true);
+			if (link->socket < 0) {
+				if (++link->connect_attempt >
+						CLA_TCP_MAX_RETRY_ATTEMPTS) {
+					LOG("UNIX: Final retry failed.");
+					break;
+				}
+				LOGF("UNIX: Delayed retry %d of %d in %d ms",
+				     link->connect_attempt,
+				     CLA_TCP_MAX_RETRY_ATTEMPTS,
+				     CLA_TCP_RETRY_INTERVAL_MS);
+				hal_task_delay(CLA_TCP_RETRY_INTERVAL_MS);
+				continue;
+			}
+			LOGF("UNIX: Connected successfully to \"%s\"",
+			     link->path);
+			link->connected = true;
+		}
+	} while (link->in_contact);
+
+	LOGF("UNIX: Terminating link manager for \"%s\"",
+	     link->path ? link->path : "<incoming>");
+	if (link->is_outgoing) {
+		hal_semaphore_take_blocking(unix_config->param_htab_sem);
+		htab_remove(&unix_config->param_htab, link->path);
+		hal_semaphore_release(unix_config->param_htab_sem);
+	}
+	mtcp_parser_reset(&link->base.mtcp_parser);
+	free(link->path);
+
+	Task_t management_task = link->management_task;
+
+	free(link);
+	hal_task_delete(management_task);
+}
+
+static void launch_link_management_task(struct unix_config *const unix_config,
+					const int sock, const char *path)
+{
+	struct unix_link *const link = malloc(sizeof(struct unix_link));
+
+	if (!link) {
+		LOG("UNIX: Failed to allocate memory!");
+		if (sock >= 0)
+			close(sock);
+		return;
+	}
+
+	link->config = unix_config;
+	link->connect_attempt = 0;
+	link->socket = sock;
+	link->is_outgoing = (sock < 0);
+	link->in_contact = link->is_outgoing;
+	link->connected = !link->is_outgoing;
+	link->path = NULL;
+	link->tx_memfd = -1;
+	link->tx_map = NULL;
+	link->rx_map = NULL;
+	mtcp_parser_reset(&link->base.mtcp_parser);
+
+	if (link->is_outgoing) {
+		link->path = strdup(path);
+		if (!link->path) {
+			LOG("UNIX: Failed to copy socket path!");
+			goto fail;
+		}
+		if (!htab_add(&unix_config->param_htab, link->path, link)) {
+			LOG("UNIX: Error creating htab entry!");
+			goto fail;
+		}
+	}
+
+	link->management_task = hal_task_create(
+		unix_link_management_task,
+		"unix_mgmt_t",
+		CONTACT_MANAGEMENT_TASK_PRIORITY,
+		link,
+		CONTACT_MANAGEMENT_TASK_STACK_SIZE,
+		(void *)CLA_SPECIFIC_TASK_TAG
+	);
+
+	if (!link->management_task) {
+		LOG("UNIX: Error creating management task!");
+		if (link->is_outgoing)
+			htab_remove(&unix_config->param_htab, link->path);
+		goto fail;
+	}
+
+	return;
+
+fail:
+	if (sock >= 0)
+		close(sock);
+	free(link->path);
+	free(link);
+}
+
+static void unix_listener_task(void *param)
+{
+	struct unix_config *const unix_config = param;
+
+	for (;;) {
+		const int sock = accept4(unix_config->base.socket, NULL, NULL,
+					 SOCK_CLOEXEC);
+
+		if (sock < 0) {
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			LOGF("UNIX: Accepting connection failed: %s",
+			     strerror(errno));
+			break;
+		}
+
+		LOG("UNIX: Accepted new connection");
+		hal_semaphore_take_blocking(unix_config->param_htab_sem);
+		launch_link_management_task(unix_config, sock, NULL);
+		hal_semaphore_release(unix_config->param_htab_sem);
+	}
+	// unexpected failure to accept() - exit thread in release mode
+	ASSERT(0);
+}
+
+/*
+ * RX
+ */
+
+static enum ud3tn_result unix_map_frame(struct unix_link *const link,
+					const int fd)
+{
+	struct stat st;
+
+	// The sender must not be able to truncate the file while it is mapped.
+	if ((fcntl(fd, F_GET_SEALS) & F_SEAL_SHRINK) == 0 ||
+			fstat(fd, &st) < 0 || st.st_size <= 0) {
+		LOG("UNIX: Received invalid memfd");
+		return UD3TN_FAIL;
+	}
+
+	void *const map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+			       fd, 0);
+
+	if (map == MAP_FAILED) {
+		LOGF("UNIX: mmap() failed: %s", strerror(errno));
+		return UD3TN_FAIL;
+	}
+
+	link->rx_map = map;
+	link->rx_map_size = st.st_size;
+	link->rx_map_offset = 0;
+	return UD3TN_OK;
+}
+
+static enum ud3tn_result unix_read(struct cla_link *cla_link,
+				   uint8_t *buffer, size_t length,
+				   size_t *bytes_read)
+{
+	struct unix_link *const link = (struct unix_link *)cla_link;
+
+	// Frames passed via memfd precede the rest of the stream.
+	if (link->rx_map) {
+		const size_t chunk = MIN(
+			length,
+			link->rx_map_size - link->rx_map_offset
+		);
+
+		memcpy(buffer, &link->rx_map[link->rx_map_offset], chunk);
+		link->rx_map_offset += chunk;
+		if (link->rx_map_offset == link->rx_map_size) {
+			munmap(link->rx_map, link->rx_map_size);
+			link->rx_map = NULL;
+		}
+		if (bytes_read)
+			*bytes_read = chunk;
+		return UD3TN_OK;
+	}
+
+	union {
+		struct cmsghdr align;
+		char buf[CMSG_SPACE(sizeof(int))];
+	} control;
+	struct iovec iov = { .iov_base = buffer, .iov_len = length };
+	struct msghdr msg = {
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+		.msg_control = control.buf,
+		.msg_controllen = sizeof(control.buf),
+	};
+	ssize_t ret;
+
+	do {
+		ret = recvmsg(link->base.base.connection_socket, &msg,
+			      MSG_CMSG_CLOEXEC);
+	} while (ret < 0 && errno == EINTR);
+
+	if (ret < 0) {
+		LOGF("UNIX: Error reading from socket: %s", strerror(errno));
+		cla_link->config->vtable->cla_disconnect_handler(cla_link);
+		return UD3TN_FAIL;
+	} else if (ret == 0) {
+		LOG("UNIX: A peer has disconnected gracefully!");
+		cla_link->config->vtable->cla_disconnect_handler(cla_link);
+		return UD3TN_FAIL;
+	}
+
+	struct cmsghdr *const cmsg = CMSG_FIRSTHDR(&msg);
+
+	if (cmsg && cmsg->cmsg_level == SOL_SOCKET &&
+			cmsg->cmsg_type == SCM_RIGHTS &&
+			cmsg->cmsg_len == CMSG_LEN(sizeof(int))) {
+		int fd;
+
+		memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+
+		// The kernel does not merge data following a descriptor into
+		// the same read, thus, the marker is always the last byte.
+		const bool valid = (
+			buffer[ret - 1] == UNIX_MEMFD_MARKER &&
+			unix_map_frame(link, fd) == UD3TN_OK
+		);
+
+		close(fd);
+		if (!valid) {
+			cla_link->config->vtable->cla_disconnect_handler(
+				cla_link
+			);
+			return UD3TN_FAIL;
+		}
+		if (--ret == 0)
+			return unix_read(cla_link, buffer, length, bytes_read);
+	} else if (HAS_FLAG(msg.msg_flags, MSG_CTRUNC)) {
+		LOG("UNIX: Received unexpected ancillary data");
+		cla_link->config->vtable->cla_disconnect_handler(cla_link);
+		return UD3TN_FAIL;
+	}
+
+	if (bytes_read)
+		*bytes_read = ret;
+	return UD3TN_OK;
+}
+
+/*
+ * API
+ */
+
+static enum ud3tn_result unix_launch(struct cla_config *const config)
+{
+	struct unix_config *const unix_config = (struct unix_config *)config;
+
+	unix_config->base.listen_task = hal_task_create(
+		unix_listener_task,
+		"unix_listen_t",
+		CONTACT_LISTEN_TASK_PRIORITY,
+		config,
+		CONTACT_LISTEN_TASK_STACK_SIZE,
+		(void *)CLA_SPECIFIC_TASK_TAG
+	);
+
+	if (!unix_config->base.listen_task)
+		return UD3TN_FAIL;
+
+	return UD3TN_OK;
+}
+
+static const char *unix_name_get(void)
+{
+	return "unix";
+}
+
+static struct unix_link *get_link(struct cla_config *config,
+				  const char *cla_addr)
+{
+	struct unix_config *const unix_config = (struct unix_config *)config;
+	char *const path = cla_get_connect_addr(cla_addr, "unix");
+
+	if (!path)
+		return NULL;
+
+	struct unix_link *const link = htab_get(&unix_config->param_htab, path);
+
+	free(path);
+	return link;
+}
+
+static struct cla_tx_queue unix_get_tx_queue(
+	struct cla_config *config, const char *eid, const char *cla_addr)
+{
+	(void)eid;
+	struct unix_config *const unix_config = (struct unix_config *)config;
+
+	hal_semaphore_take_blocking(unix_config->param_htab_sem);
+	struct unix_link *const link = get_link(config, cla_addr);
+
+	if (link && link->connected) {
+		struct cla_link *const cla_link = &link->base.base.base;
+
+		hal_semaphore_take_blocking(cla_link->tx_queue_sem);
+		hal_semaphore_release(unix_config->param_htab_sem);
+
+		// Freed while trying to obtain it
+		if (!cla_link->tx_queue_handle)
+			return (struct cla_tx_queue){ NULL, NULL, NULL };
+
+		return (struct cla_tx_queue){
+			.tx_queue_handle = cla_link->tx_queue_handle,
+			.tx_queue_sem = cla_link->tx_queue_sem,
+			.tx_backlog = &cla_link->tx_backlog,
+		};
+	}
+
+	hal_semaphore_release(unix_config->param_htab_sem);
+	return (struct cla_tx_queue){ NULL, NULL, NULL };
+}
+
+static enum ud3tn_result unix_start_scheduled_contact(
+	struct cla_config *config, const char *eid, const char *cla_addr)
+{
+	(void)eid;
+	struct unix_config *const unix_config = (struct unix_config *)config;
+
+	hal_semaphore_take_blocking(unix_config->param_htab_sem);
+	struct unix_link *const link = get_link(config, cla_addr);
+
+	if (link) {
+		LOGF("UNIX: Associating open connection with \"%s\" to new contact",
+		     cla_addr);
+		link->in_contact = true;
+		hal_semaphore_release(unix_config->param_htab_sem);
+		return UD3TN_OK;
+	}
+
+	char *const path = cla_get_connect_addr(cla_addr, "unix");
+
+	if (path && path[0] != '\0')
+		launch_link_management_task(unix_config, -1, path);
+	else
+		LOGF("UNIX: Invalid CLA address \"%s\"", cla_addr);
+	free(path);
+	hal_semaphore_release(unix_config->param_htab_sem);
+
+	return UD3TN_OK;
+}
+
+static enum ud3tn_result unix_end_scheduled_contact(
+	struct cla_config *config, const char *eid, const char *cla_addr)
+{
+	(void)eid;
+	struct unix_config *const unix_config = (struct unix_config *)config;
+
+	hal_semaphore_take_blocking(unix_config->param_htab_sem);
+	struct unix_link *const link = get_link(config, cla_addr);
+
+	if (link && link->in_contact) {
+		struct cla_link *const cla_link = &link->base.base.base;
+
+		link->in_contact = false;
+		if (link->socket >= 0) {
+			LOGF("UNIX: Terminating connection with \"%s\"",
+			     cla_addr);
+			cla_link->config->vtable->cla_disconnect_handler(
+				cla_link
+			);
+		}
+	}
+
+	hal_semaphore_release(unix_config->param_htab_sem);
+
+	return UD3TN_OK;
+}
+
+/*
+ * TX
+ */
+
+static void unix_tx_map_release(struct unix_link *const link)
+{
+	munmap(link->tx_map, link->tx_map_size);
+	close(link->tx_memfd);
+	link->tx_map = NULL;
+	link->tx_memfd = -1;
+}
+
+// Prepares a memfd for the frame, returns false to stream it instead.
+static bool unix_tx_map_create(struct unix_link *const link,
+			       const uint8_t *header, const size_t hdr_len,
+			       const size_t length)
+{
+	const size_t size = hdr_len + length;
+
+	link->tx_memfd = memfd_create("ud3tn-bundle",
+				      MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	if (link->tx_memfd < 0)
+		return false;
+
+	if (ftruncate(link->tx_memfd, size) < 0) {
+		close(link->tx_memfd);
+		link->tx_memfd = -1;
+		return false;
+	}
+
+	void *const map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+			       link->tx_memfd, 0);
+
+	if (map == MAP_FAILED) {
+		close(link->tx_memfd);
+		link->tx_memfd = -1;
+		return false;
+	}
+
+	link->tx_map = map;
+	link->tx_map_size = size;
+	memcpy(link->tx_map, header, hdr_len);
+	link->tx_map_fill = hdr_len;
+	return true;
+}
+
+static enum ud3tn_result unix_tx_map_send(struct unix_link *const link)
+{
+	const int fd = link->tx_memfd;
+	const uint8_t marker = UNIX_MEMFD_MARKER;
+	union {
+		struct cmsghdr align;
+		char buf[CMSG_SPACE(sizeof(int))];
+	} control;
+	struct iovec iov = { .iov_base = (void *)&marker, .iov_len = 1 };
+	struct msghdr msg = {
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+		.msg_control = control.buf,
+		.msg_controllen = sizeof(control.buf),
+	};
+
+	memset(&control, 0, sizeof(control));
+
+	struct cmsghdr *const cmsg = CMSG_FIRSTHDR(&msg);
+
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+	// Write access has to be dropped before the file can be sealed.
+	munmap(link->tx_map, link->tx_map_size);
+	link->tx_map = NULL;
+	const int seals = (
+		F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL
+	);
+
+	if (fcntl(fd, F_ADD_SEALS, seals) < 0) {
+		LOGF("UNIX: Sealing memfd failed: %s", strerror(errno));
+		close(fd);
+		link->tx_memfd = -1;
+		return UD3TN_FAIL;
+	}
+
+	ssize_t ret;
+
+	do {
+		ret = sendmsg(link->base.base.connection_socket, &msg,
+			      MSG_NOSIGNAL);
+	} while (ret < 0 && errno == EINTR);
+
+	// The peer holds its own reference to the file after sending.
+	close(fd);
+	link->tx_memfd = -1;
+	return ret == 1 ? UD3TN_OK : UD3TN_FAIL;
+}
+
+static void unix_begin_packet(struct cla_link *cla_link, size_t length,
+			      char *cla_addr)
+{
+	struct unix_link *const link = (struct unix_link *)cla_link;
+	(void)cla_addr;
+
+	// A previous operation may have canceled the sending process.
+	if (!cla_link->active)
+		return;
+
+	const size_t BUFFER_SIZE = 9; // max. for uint64_t
+	uint8_t buffer[BUFFER_SIZE];
+
+	const size_t hdr_len = mtcp_encode_header(buffer, BUFFER_SIZE, length);
+
+	// Small bundles are streamed, as is everything if memfd is unusable.
+	if (length >= CLA_UNIX_MEMFD_THRESHOLD &&
+			unix_tx_map_create(link, buffer, hdr_len, length))
+		return;
+
+	if (tcp_send_all(link->base.base.connection_socket,
+			 buffer, hdr_len) == -1) {
+		LOG("UNIX: Error during sending. Data discarded.");
+		cla_link->config->vtable->cla_disconnect_handler(cla_link);
+	}
+}
+
+static void unix_end_packet(struct cla_link *cla_link)
+{
+	struct unix_link *const link = (struct unix_link *)cla_link;
+
+	if (!link->tx_map)
+		return;
+
+	// Do not pass incomplete frames.
+	if (!cla_link->active || link->tx_map_fill != link->tx_map_size) {
+		unix_tx_map_release(link);
+		return;
+	}
+
+	if (unix_tx_map_send(link) != UD3TN_OK) {
+		LOG("UNIX: Error during sending. Data discarded.");
+		cla_link->config->vtable->cla_disconnect_handler(cla_link);
+	}
+}
+
+static void unix_send_packet_data(
+	struct cla_link *cla_link, const void *data, const size_t length)
+{
+	struct unix_link *const link = (struct unix_link *)cla_link;
+
+	// A previous operation may have canceled the sending process.
+	if (!cla_link->active)
+		return;
+
+	if (link->tx_map) {
+		if (link->tx_map_fill + length > link->tx_map_size) {
+			LOG("UNIX: Serialized bundle exceeds announced size!");
+			cla_link->config->vtable->cla_disconnect_handler(
+				cla_link
+			);
+			return;
+		}
+		memcpy(&link->tx_map[link->tx_map_fill], data, length);
+		link->tx_map_fill += length;
+		return;
+	}
+
+	if (tcp_send_all(link->base.base.connection_socket,
+			 data, length) == -1) {
+		LOG("UNIX: Error during sending. Data discarded.");
+		cla_link->config->vtable->cla_disconnect_handler(cla_link);
+	}
+}
+
+/*
+ * INIT
+ */
+
+const struct cla_vtable unix_vtable = {
+	.cla_name_get = unix_name_get,
+	.cla_launch = unix_launch,
+	.cla_mbs_get = mtcp_mbs_get,
+
+	.cla_get_tx_queue = unix_get_tx_queue,
+	.cla_start_scheduled_contact = unix_start_scheduled_contact,
+	.cla_end_scheduled_contact = unix_end_scheduled_contact,
+
+	.cla_begin_packet = unix_begin_packet,
+	.cla_end_packet = unix_end_packet,
+	.cla_send_packet_data = unix_send_packet_data,
+
+	.cla_rx_task_reset_parsers = mtcp_reset_parsers,
+	.cla_rx_task_forward_to_specific_parser =
+		mtcp_forward_to_specific_parser,
+
+	.cla_read = unix_read,
+
+	.cla_disconnect_handler = cla_tcp_disconnect_handler,
+};
+
+static enum ud3tn_result unix_init(
+	struct unix_config *config, const char *path,
+	const struct bundle_agent_interface *bundle_agent_interface)
+{
+	/* Initialize base_config */
+	if (cla_tcp_config_init(&config->base,
+				bundle_agent_interface) != UD3TN_OK)
+		return UD3TN_FAIL;
+
+	/* set base_config vtable */
+	config->base.base.vtable = &unix_vtable;
+
+	htab_init(&config->param_htab, CLA_TCP_PARAM_HTAB_SLOT_COUNT,
+		  config->param_htab_elem);
+
+	config->param_htab_sem = hal_semaphore_init_binary();
+	hal_semaphore_release(config->param_htab_sem);
+
+	/* Start listening */
+	config->base.socket = unix_socket_create(path, false);
+	if (config->base.socket < 0)
+		return UD3TN_FAIL;
+
+	LOGF("UNIX: CLA unix is now listening on \"%s\"", path);
+
+	return UD3TN_OK;
+}
+
+struct cla_config *unix_create(
+	const char *const options[], const size_t option_count,
+	const struct bundle_agent_interface *bundle_agent_interface)
+{
+	if (option_count != 1) {
+		LOG("UNIX: Options format has to be: <PATH>");
+		return NULL;
+	}
+
+	struct unix_config *config = malloc(sizeof(struct unix_config));
+
+	if (!config) {
+		LOG("UNIX: Memory allocation failed!");
+		return NULL;
+	}
+
+	if (unix_init(config, options[0], bundle_agent_interface) != UD3TN_OK) {
+		free(config);
+		LOG("UNIX: Initialization failed!");
+		return NULL;
+	}
+
+	return &config->base.base;
+}
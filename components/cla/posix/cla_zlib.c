@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#include "cla/posix/cla_zlib.h"
+
+#include "ud3tn/result.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef UD3TN_WITH_ZLIB
+
+#include <zlib.h>
+
+struct cla_zlib_stream {
+	z_stream zs;
+	bool compress;
+	uint64_t total_out;
+};
+
+bool cla_zlib_available(void)
+{
+	return true;
+}
+
+struct cla_zlib_stream *cla_zlib_create(const bool compress, const int level)
+{
+	struct cla_zlib_stream *const stream = malloc(
+		sizeof(struct cla_zlib_stream)
+	);
+
+	if (!stream)
+		return NULL;
+
+	memset(stream, 0, sizeof(struct cla_zlib_stream));
+	stream->compress = compress;
+
+	const int ret = (
+		compress
+		? deflateInit(&stream->zs, level)
+		: inflateInit(&stream->zs)
+	);
+
+	if (ret != Z_OK) {
+		free(stream);
+		return NULL;
+	}
+
+	return stream;
+}
+
+void cla_zlib_free(struct cla_zlib_stream *stream)
+{
+	if (!stream)
+		return;
+
+	if (stream->compress)
+		deflateEnd(&stream->zs);
+	else
+		inflateEnd(&stream->zs);
+	free(stream);
+}
+
+enum ud3tn_result cla_zlib_process(struct cla_zlib_stream *stream,
+				   const uint8_t **in, size_t *in_length,
+				   uint8_t **out, size_t *out_length,
+				   const bool flush)
+{
+	z_stream *const zs = &stream->zs;
+	// zlib takes lengths as uInt, larger buffers are processed partially.
+	const uInt in_chunk = (uInt)(
+		*in_length > UINT_MAX ? UINT_MAX : *in_length
+	);
+	const uInt out_chunk = (uInt)(
+		*out_length > UINT_MAX ? UINT_MAX : *out_length
+	);
+
+	zs->next_in = (Bytef *)*in;
+	zs->avail_in = in_chunk;
+	zs->next_out = *out;
+	zs->avail_out = out_chunk;
+
+	const int ret = (
+		stream->compress
+		? deflate(
+			zs,
+			(flush && in_chunk == *in_length)
+			? Z_SYNC_FLUSH
+			: Z_NO_FLUSH
+		)
+		: inflate(zs, Z_SYNC_FLUSH)
+	);
+
+	const size_t consumed = in_chunk - zs->avail_in;
+	const size_t produced = out_chunk - zs->avail_out;
+
+	*in += consumed;
+	*in_length -= consumed;
+	*out += produced;
+	*out_length -= produced;
+	stream->total_out += produced;
+
+	// Z_BUF_ERROR only indicates that no progress was possible. The end
+	// of the stream is unexpected as we never finish it.
+	return (ret == Z_OK || ret == Z_BUF_ERROR) ? UD3TN_OK : UD3TN_FAIL;
+}
+
+uint64_t cla_zlib_total_out(const struct cla_zlib_stream *stream)
+{
+	return stream->total_out;
+}
+
+const char *cla_zlib_error(const struct cla_zlib_stream *stream)
+{
+	return stream->zs.msg ? stream->zs.msg : "unexpected end of stream";
+}
+
+#else // UD3TN_WITH_ZLIB
+
+bool cla_zlib_available(void)
+{
+	return false;
+}
+
+struct cla_zlib_stream *cla_zlib_create(const bool compress, const int level)
+{
+	(void)compress;
+	(void)level;
+	return NULL;
+}
+
+void cla_zlib_free(struct cla_zlib_stream *stream)
+{
+	(void)stream;
+}
+
+enum ud3tn_result cla_zlib_process(struct cla_zlib_stream *stream,
+				   const uint8_t **in, size_t *in_length,
+				   uint8_t **out, size_t *out_length,
+				   const bool flush)
+{
+	(void)stream;
+	(void)in;
+	(void)in_length;
+	(void)out;
+	(void)out_length;
+	(void)flush;
+	return UD3TN_FAIL;
+}
+
+uint64_t cla_zlib_total_out(const struct cla_zlib_stream *stream)
+{
+	(void)stream;
+	return 0;
+}
+
+const char *cla_zlib_error(const struct cla_zlib_stream *stream)
+{
+	(void)stream;
+	return "zlib support not available";
+}
+
+#endif // UD3TN_WITH_ZLIB
@@ -8,14 +8,17 @@
  */
 
 #include "platform/hal_queue.h"
+#include "platform/hal_time.h"
 #include "platform/hal_types.h"
 
 #include "platform/posix/simple_queue.h"
 
 #include "ud3tn/result.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
 
 
 QueueIdentifier_t hal_queue_create(int queue_length, int item_size)
@@ -38,6 +41,36 @@ enum ud3tn_result hal_queue_receive(QueueIdentifier_t queue, void *targetBuffer,
 }
 
 
+enum ud3tn_result hal_queue_receive_until(QueueIdentifier_t queue,
+					  void *targetBuffer,
+					  uint64_t deadline_ms)
+{
+	struct timespec ts;
+	uint64_t now_ms, delay_ms;
+
+	if (deadline_ms == UINT64_MAX)
+		return queuePopUntil(queue, targetBuffer, NULL) == 0
+			? UD3TN_OK : UD3TN_FAIL;
+
+	// The DTN time is derived from CLOCK_REALTIME, thus, waiting for an
+	// absolute point in time also holds if the system clock is adjusted.
+	if (clock_gettime(CLOCK_REALTIME, &ts) == -1)
+		return UD3TN_FAIL;
+	now_ms = hal_time_get_timestamp_ms();
+	delay_ms = deadline_ms > now_ms ? deadline_ms - now_ms : 0;
+
+	ts.tv_sec += delay_ms / 1000;
+	ts.tv_nsec += (delay_ms % 1000) * 1000000;
+	if (ts.tv_nsec >= 1000000000) {
+		ts.tv_sec += 1;
+		ts.tv_nsec -= 1000000000;
+	}
+
+	return queuePopUntil(queue, targetBuffer, &ts) == 0
+		? UD3TN_OK : UD3TN_FAIL;
+}
+
+
 void hal_queue_reset(QueueIdentifier_t queue)
 {
 	queueReset(queue);
@@ -14,29 +14,17 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <time.h>
-#include <math.h>
 #include <string.h>
 
-static uint64_t ref_timestamp;
+// Offset of the DTN time to the system time (relative to the DTN epoch)
+static int64_t ref_offset_us;
 static bool mod_time;
-static struct timespec ref_timespec;
 
 static char *time_string;
 static Semaphore_t time_string_semph;
 
-void hal_time_init(const uint64_t initial_timestamp)
-{
-	/* get the current system time */
-	clock_gettime(CLOCK_REALTIME, &ref_timespec);
-
-	/* calculate offset to required time */
-	ref_timestamp = ref_timespec.tv_sec - DTN_TIMESTAMP_OFFSET -
-			initial_timestamp;
-
-	mod_time = (initial_timestamp != 0);
-}
-
-uint64_t hal_time_get_timestamp_s(void)
+// Returns the system time relative to the DTN epoch in microseconds
+static int64_t get_system_dtn_time_us(void)
 {
 	struct timespec ts;
 
@@ -44,42 +32,34 @@ uint64_t hal_time_get_timestamp_s(void)
 	clock_gettime(CLOCK_REALTIME, &ts);
 
 	/* we want to use the DTN epoch -> subtract the offset */
-	return ts.tv_sec - DTN_TIMESTAMP_OFFSET - ref_timestamp;
+	return ((int64_t)ts.tv_sec - DTN_TIMESTAMP_OFFSET) * 1000000 +
+		ts.tv_nsec / 1000;
 }
 
-uint64_t hal_time_get_timestamp_ms(void)
+void hal_time_init(const uint64_t initial_timestamp)
 {
-	struct timespec ts;
-	long ms; /* Milliseconds */
-	time_t s;  /* Seconds */
+	/* calculate offset to required time, so that the sub-second */
+	/* part of the DTN time starts at zero, too */
+	ref_offset_us = get_system_dtn_time_us() -
+		(int64_t)initial_timestamp * 1000000;
 
-	/* Returns the time relative to the unix epoch */
-	clock_gettime(CLOCK_REALTIME, &ts);
+	mod_time = (initial_timestamp != 0);
+}
 
-	/* We want to use the DTN epoch -> subtract the offset */
-	s = ts.tv_sec - DTN_TIMESTAMP_OFFSET - ref_timestamp;
-	/* Convert nanoseconds to milliseconds */
-	ms = round(ts.tv_nsec / 1.0e6);
+uint64_t hal_time_get_timestamp_s(void)
+{
+	return hal_time_get_timestamp_us() / 1000000;
+}
 
-	return (s*1.0e3)+ms;
+uint64_t hal_time_get_timestamp_ms(void)
+{
+	return hal_time_get_timestamp_us() / 1000;
 }
 
 
 uint64_t hal_time_get_timestamp_us(void)
 {
-	struct timespec ts;
-	long us; /* Milliseconds */
-	time_t s;  /* Seconds */
-
-	/* Returns the time relative to the unix epoch */
-	clock_gettime(CLOCK_REALTIME, &ts);
-
-	/* We want to use the DTN epoch -> subtract the offset */
-	s = ts.tv_sec - DTN_TIMESTAMP_OFFSET - ref_timestamp;
-	/* Convert nanoseconds to microseconds */
-	us = round(ts.tv_nsec / 1.0e3);
-
-	return (s*1.0e6)+us;
+	return get_system_dtn_time_us() - ref_offset_us;
 }
 
 
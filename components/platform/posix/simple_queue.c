@@ -123,21 +123,31 @@ unsigned int queueItemsWaiting(Queue_t *queue)
 uint8_t queuePop(Queue_t *queue, void *targetBuffer, int timeout)
 {
 	struct timespec ts;
-	int errsv;
 
-	if (timeout >= 0) {
-		if (clock_gettime(CLOCK_REALTIME, &ts) == -1)
-			exit(EXIT_FAILURE);
+	if (timeout < 0)
+		return queuePopUntil(queue, targetBuffer, NULL);
 
-		ts.tv_sec += timeout / 1000;
-		ts.tv_nsec += (timeout % 1000) * 1000000;
+	if (clock_gettime(CLOCK_REALTIME, &ts) == -1)
+		exit(EXIT_FAILURE);
 
-		if (ts.tv_nsec >= 1000000000) {
-			ts.tv_sec += 1;
-			ts.tv_nsec = (ts.tv_nsec%1000000000);
-		}
+	ts.tv_sec += timeout / 1000;
+	ts.tv_nsec += (timeout % 1000) * 1000000;
+
+	if (ts.tv_nsec >= 1000000000) {
+		ts.tv_sec += 1;
+		ts.tv_nsec = (ts.tv_nsec%1000000000);
+	}
+
+	return queuePopUntil(queue, targetBuffer, &ts);
+}
+
+uint8_t queuePopUntil(Queue_t *queue, void *targetBuffer,
+		      const struct timespec *abs_timeout)
+{
+	int errsv;
 
-		if (sem_timedwait(&(queue->sem_pop), &ts) == -1) {
+	if (abs_timeout != NULL) {
+		if (sem_timedwait(&(queue->sem_pop), abs_timeout) == -1) {
 			errsv = errno;
 
 			if (errsv != ETIMEDOUT) {
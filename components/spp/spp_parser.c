@@ -15,6 +15,38 @@ struct parser *spp_parser_init(struct spp_parser *parser,
 	return &parser->base;
 }
 
+/*
+ * Selects the next state after the primary header has been parsed. Returns
+ * false if the data field follows directly.
+ */
+static bool spp_parser_enter_secondary_header(struct spp_parser *parser)
+{
+	parser->data_length = parser->header.data_length;
+	parser->data_length -= parser->ctx->ancillary_data_len;
+
+	if (!parser->header.has_secondary_header) {
+		// TODO: init subparser if implemented here
+		parser->state = SPP_PARSER_STATE_DATA_SUBPARSER;
+		return false;
+	}
+
+	if (parser->ctx->timecode != NULL) {
+		parser->state = SPP_PARSER_STATE_SH_TIMECODE_SUBPARSER;
+		spp_tc_parser_init(parser->ctx->timecode,
+				   &parser->tc_parser);
+		return true;
+	}
+
+	if (parser->ctx->ancillary_data_len > 0) {
+		// TODO: init subparser if implemented here
+		parser->state = SPP_PARSER_STATE_SH_ANCILLARY_SUBPARSER;
+		return true;
+	}
+
+	parser->state = SPP_PARSER_STATE_DATA_SUBPARSER;
+	return false;
+}
+
 bool spp_parse_byte(struct spp_parser *parser,
 		    const uint8_t byte)
 {
@@ -61,31 +93,7 @@ bool spp_parse_byte(struct spp_parser *parser,
 	{
 		parser->bufw |= byte;
 		spp_parse_ph_len(parser->bufw, &parser->header);
-
-		parser->data_length = parser->header.data_length;
-		parser->data_length -= parser->ctx->ancillary_data_len;
-
-		if (!parser->header.has_secondary_header) {
-			// TODO: init subparser if implemented here
-			parser->state = SPP_PARSER_STATE_DATA_SUBPARSER;
-			return false;
-		}
-
-		if (parser->ctx->timecode != NULL) {
-			parser->state = SPP_PARSER_STATE_SH_TIMECODE_SUBPARSER;
-			spp_tc_parser_init(parser->ctx->timecode,
-					   &parser->tc_parser);
-			break;
-		}
-
-		if (parser->ctx->ancillary_data_len > 0) {
-			// TODO: init subparser if implemented here
-			parser->state = SPP_PARSER_STATE_SH_ANCILLARY_SUBPARSER;
-			break;
-		}
-
-		parser->state = SPP_PARSER_STATE_DATA_SUBPARSER;
-		return false;
+		return spp_parser_enter_secondary_header(parser);
 	}
 	case SPP_PARSER_STATE_SH_TIMECODE_SUBPARSER:
 	{
@@ -136,6 +144,40 @@ bool spp_parse_byte(struct spp_parser *parser,
 }
 
 
+/*
+ * Decodes the whole primary header from a contiguous buffer of at least
+ * SPP_PRIMARY_HEADER_SIZE bytes and continues with the timecode as far as the
+ * buffer reaches, instead of returning to the caller after every field.
+ */
+static size_t spp_parser_read_span(struct spp_parser *parser,
+				   const uint8_t *buffer,
+				   size_t length)
+{
+	const uint8_t *const end = buffer + length;
+	const uint8_t *cur = buffer;
+
+	if (!spp_check_first_byte(buffer[0])) {
+		spp_parser_reset(parser);
+		parser->base.status = PARSER_STATUS_ERROR;
+		return 1;
+	}
+
+	spp_parse_ph_p1((buffer[0] << 8) | buffer[1], &parser->header);
+	spp_parse_ph_p2((buffer[2] << 8) | buffer[3], &parser->header);
+	spp_parse_ph_len((buffer[4] << 8) | buffer[5], &parser->header);
+	cur += SPP_PRIMARY_HEADER_SIZE;
+
+	if (!spp_parser_enter_secondary_header(parser))
+		return cur - buffer;
+
+	while (cur != end &&
+	       parser->state == SPP_PARSER_STATE_SH_TIMECODE_SUBPARSER &&
+	       parser->base.status == PARSER_STATUS_GOOD)
+		spp_parse_byte(parser, *cur++);
+
+	return cur - buffer;
+}
+
 size_t spp_parser_read(struct spp_parser *parser,
 		       const uint8_t *buffer,
 		       size_t length)
@@ -144,6 +186,10 @@ size_t spp_parser_read(struct spp_parser *parser,
 	const uint8_t *cur = buffer;
 	const enum spp_parser_state prev_state = parser->state;
 
+	if (parser->state == SPP_PARSER_STATE_PH_P1_MSB &&
+	    length >= SPP_PRIMARY_HEADER_SIZE)
+		return spp_parser_read_span(parser, buffer, length);
+
 	for (; cur != end; ++cur) {
 		// give control back to the caller on every state change
 		if (parser->state != prev_state)
@@ -427,12 +427,11 @@ size_t bundle_get_last_fragment_min_size(struct bundle *bundle)
 	}
 }
 
-uint64_t bundle_get_expiration_time_s(const struct bundle *const bundle,
-	const uint64_t current_time_s)
+uint64_t bundle_get_expiration_time_ms(const struct bundle *const bundle,
+	const uint64_t current_time_ms)
 {
 	if (bundle->creation_timestamp_ms != 0)
-		return (bundle->creation_timestamp_ms + bundle->lifetime_ms +
-			500) / 1000;
+		return bundle->creation_timestamp_ms + bundle->lifetime_ms;
 
 	const struct bundle_block *const age_block = bundle_block_find_first_by_type(
 		bundle->blocks, BUNDLE_BLOCK_TYPE_BUNDLE_AGE);
@@ -443,13 +442,18 @@ uint64_t bundle_get_expiration_time_s(const struct bundle *const bundle,
 	    age_block->length))
 		return 0;
 
-	const uint64_t current_time_ms = current_time_s * 1000;
-
 	// EXP_TIME = CUR_TIME + REMAINING_LIFETIME
 	// REMAINING_LIFETIME = TOTAL_LIFETIME - TOTAL_AGE
 	// TOTAL_AGE = AGE_IN_BLOCK + LOCAL_STORAGE_DURATION
-	return (current_time_ms + bundle->lifetime_ms - bundle_age_ms -
-		(current_time_ms - bundle->reception_timestamp_ms) + 500) / 1000;
+	return current_time_ms + bundle->lifetime_ms - bundle_age_ms -
+		(current_time_ms - bundle->reception_timestamp_ms);
+}
+
+uint64_t bundle_get_expiration_time_s(const struct bundle *const bundle,
+	const uint64_t current_time_s)
+{
+	return (bundle_get_expiration_time_ms(bundle, current_time_s * 1000) +
+		500) / 1000;
 }
 
 enum ud3tn_result bundle_age_update(struct bundle *bundle,
@@ -529,7 +533,8 @@ struct bundle_adu bundle_adu_init(const struct bundle *bundle)
 		.source = strdup(bundle->source),
 		.destination = strdup(bundle->destination),
 		.payload = NULL,
-		.length = 0
+		.length = 0,
+		.payload_offset = 0
 	};
 }
 
@@ -66,6 +66,8 @@ static void handle_process_router_command(
 	const struct bp_context *const ctx, struct router_command *cmd);
 static void handle_contact_over(
 	const struct bp_context *const ctx, struct contact *contact);
+static void handle_reschedule_bundles(
+	const struct bp_context *const ctx, struct routed_bundle_list *bundles);
 
 static enum ud3tn_result bundle_dispatch(
 	struct bp_context *const ctx, struct bundle *bundle);
@@ -102,6 +104,9 @@ static void bundle_handle_custody_signal(
 	struct bundle_administrative_record *signal);
 static void bundle_dangling(
 	const struct bp_context *const ctx, struct bundle *bundle);
+static void bundle_routing_failed(
+	const struct bp_context *const ctx,
+	struct bundle *bundle, enum router_result_status result);
 static bool hop_count_validation(struct bundle *bundle);
 static const char *get_agent_id(
 	const struct bp_context *const ctx, const char *dest_eid);
@@ -161,6 +166,20 @@ void bundle_processor_inform(
 	hal_queue_push_to_back(bundle_processor_signaling_queue, &signal);
 }
 
+void bundle_processor_reschedule_bundles(
+	QueueIdentifier_t bundle_processor_signaling_queue,
+	struct routed_bundle_list *bundles,
+	char *peer_cla_addr)
+{
+	struct bundle_processor_signal signal = {
+		.type = BP_SIGNAL_RESCHEDULE_BUNDLES,
+		.peer_cla_addr = peer_cla_addr,
+		.bundles = bundles,
+	};
+
+	hal_queue_push_to_back(bundle_processor_signaling_queue, &signal);
+}
+
 int bundle_processor_perform_agent_action(
 	QueueIdentifier_t signaling_queue,
 	enum bundle_processor_signal_type type,
@@ -263,7 +282,7 @@ void bundle_processor_task(void * const param)
 	/* Start contact manager */
 	ctx.cm_param = contact_manager_start(
 		p->signaling_queue,
-		routing_table_get_raw_contact_list_ptr());
+		routing_table_get_contact_timeline());
 	ASSERT(ctx.cm_param.control_queue != NULL);
 
 	LOGF("BundleProcessor: BPA initialized for \"%s\", status reports %s",
@@ -335,12 +354,34 @@ static inline void handle_signal(
 		// XXX: We do not use the provided CLA address.
 		free(signal.peer_cla_addr);
 		break;
+	case BP_SIGNAL_TX_BACKLOG_LOW:
+		// XXX: We do not use the provided CLA address.
+		free(signal.peer_cla_addr);
+		// A congested link can accept bundles again.
+		wake_up_contact_manager(
+			ctx->cm_param.control_queue,
+			CM_SIGNAL_PROCESS_CURRENT_BUNDLES
+		);
+		break;
 	case BP_SIGNAL_PROCESS_ROUTER_COMMAND:
 		handle_process_router_command(ctx, signal.router_cmd);
 		break;
 	case BP_SIGNAL_CONTACT_OVER:
 		handle_contact_over(ctx, signal.contact);
 		break;
+	case BP_SIGNAL_RESCHEDULE_BUNDLES:
+		// XXX: We do not use the provided CLA address.
+		free(signal.peer_cla_addr);
+		handle_reschedule_bundles(ctx, signal.bundles);
+		break;
+	case BP_SIGNAL_TIME_CHANGED:
+		// The CM sleeps until the next contact starts or ends, which
+		// has to be re-determined based on the new time.
+		wake_up_contact_manager(
+			ctx->cm_param.control_queue,
+			CM_SIGNAL_UPDATE_CONTACT_LIST
+		);
+		break;
 	default:
 		LOGF("BundleProcessor: Invalid signal (%d) detected",
 		     signal.type);
@@ -351,20 +392,24 @@ static inline void handle_signal(
 static void handle_process_router_command(
 	const struct bp_context *const ctx, struct router_command *cmd)
 {
+	size_t applied;
+
 	hal_semaphore_take_blocking(ctx->cm_param.semaphore);
 
 	// NOTE: May invoke router via bundle_dangling!
-	enum ud3tn_result result = router_process_command(
+	router_process_command(
 		cmd,
 		(struct rescheduling_handle) {
 			.reschedule_func = bundle_resched_func,
 			.reschedule_func_context = ctx,
-		}
+		},
+		&applied
 	);
 
 	hal_semaphore_release(ctx->cm_param.semaphore);
 
-	if (result == UD3TN_OK) {
+	// Parts of a command may have been applied despite failures.
+	if (applied != 0) {
 		wake_up_contact_manager(
 			ctx->cm_param.control_queue,
 			CM_SIGNAL_UPDATE_CONTACT_LIST
@@ -387,6 +432,87 @@ static void handle_contact_over(
 	hal_semaphore_release(ctx->cm_param.semaphore);
 }
 
+struct deferred_route_failure {
+	struct bundle *bundle;
+	enum router_result_status result;
+	struct deferred_route_failure *next;
+};
+
+// NOTE: Called with the routing table locked, must not route bundles.
+static void defer_route_failure(struct bundle *bundle,
+				enum router_result_status result,
+				void *context)
+{
+	struct deferred_route_failure **const failures = context;
+	struct deferred_route_failure *const entry = malloc(
+		sizeof(struct deferred_route_failure)
+	);
+
+	if (!entry) {
+		LOGF("BundleProcessor: Dropping bundle %p: Rescheduling failed and no memory to report it.",
+		     bundle);
+		bundle_discard(bundle);
+		return;
+	}
+
+	entry->bundle = bundle;
+	entry->result = result;
+	entry->next = *failures;
+	*failures = entry;
+}
+
+static void handle_reschedule_bundles(
+	const struct bp_context *const ctx, struct routed_bundle_list *bundles)
+{
+	if (FAILED_FORWARD_POLICY != POLICY_TRY_RE_SCHEDULE) {
+		while (bundles) {
+			struct routed_bundle_list *const next = bundles->next;
+
+			bundle_forwarding_failed(
+				ctx,
+				bundles->data,
+				BUNDLE_SR_REASON_TRANSMISSION_CANCELED
+			);
+			free(bundles);
+			bundles = next;
+		}
+		return;
+	}
+
+	struct deferred_route_failure *failures = NULL;
+
+	// Route the whole batch at once so the CM is only woken up once.
+	hal_semaphore_take_blocking(ctx->cm_param.semaphore);
+
+	const size_t routed = router_route_bundle_list(
+		bundles,
+		(struct route_failure_handle) {
+			.route_failure_func = defer_route_failure,
+			.route_failure_func_context = &failures,
+		}
+	);
+
+	hal_semaphore_release(ctx->cm_param.semaphore);
+
+	LOGF("BundleProcessor: Rescheduled %lu bundle(s) of failed link",
+	     (unsigned long)routed);
+	if (routed)
+		wake_up_contact_manager(
+			ctx->cm_param.control_queue,
+			CM_SIGNAL_PROCESS_CURRENT_BUNDLES
+		);
+
+	// Status reports for the failures are routed, too, which requires the
+	// routing table lock to be released.
+	while (failures) {
+		struct deferred_route_failure *const next = failures->next;
+
+		bundle_routing_failed(ctx, failures->bundle, failures->result);
+		free(failures);
+		failures = next;
+	}
+}
+
 /* BUNDLE HANDLING */
 
 /* 5.3 */
@@ -819,14 +945,10 @@ static void bundle_deliver_adu(const struct bp_context *const ctx, struct bundle
 				adu.payload
 			);
 
-			// Remove the record-specific bytes from the ADU so
-			// only the BPDU remains.
+			// Skip the record-specific bytes in place so only the
+			// BPDU remains, the buffer is released as a whole.
 			adu.length = adu.length - bytes_to_skip;
-			memmove(
-				adu.payload,
-				adu.payload + bytes_to_skip,
-				adu.length
-			);
+			adu.payload_offset = bytes_to_skip;
 			adu.proc_flags = BUNDLE_FLAG_ADMINISTRATIVE_RECORD;
 
 			const char *agent_id = get_eid_scheme(ctx->local_eid) == EID_SCHEME_DTN ? "bibe" : "2925";
@@ -1005,6 +1127,15 @@ static enum ud3tn_result send_bundle(
 		return UD3TN_OK;
 	}
 
+	bundle_routing_failed(ctx, bundle, result);
+
+	return UD3TN_FAIL;
+}
+
+static void bundle_routing_failed(
+	const struct bp_context *const ctx,
+	struct bundle *bundle, enum router_result_status result)
+{
 	LOGF("BundleProcessor: Routing bundle %p failed: %s",
 		bundle,
 		get_router_status_str(result));
@@ -1016,8 +1147,6 @@ static enum ud3tn_result send_bundle(
 			bundle,
 			get_fail_reason(result)
 		);
-
-	return UD3TN_FAIL;
 }
 
 /**
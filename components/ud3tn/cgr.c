@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#include "ud3tn/bundle.h"
+#include "ud3tn/cgr.h"
+#include "ud3tn/common.h"
+#include "ud3tn/node.h"
+#include "ud3tn/router.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static int compare_contacts(const void *a, const void *b)
+{
+	const struct contact *const ca = *(struct contact *const *)a;
+	const struct contact *const cb = *(struct contact *const *)b;
+
+	if (ca->from != cb->from)
+		return ca->from < cb->from ? -1 : 1;
+	if (ca->to != cb->to)
+		return ca->to < cb->to ? -1 : 1;
+	return 0;
+}
+
+struct cgr_route_list *cgr_route_list_create(
+	const struct contact_list *contacts)
+{
+	const struct contact_list *cur;
+	struct cgr_route_list *routes;
+	size_t count = 0;
+
+	for (cur = contacts; cur != NULL; cur = cur->next)
+		count++;
+
+	routes = malloc(
+		sizeof(struct cgr_route_list) +
+		count * sizeof(struct contact *)
+	);
+	if (routes == NULL)
+		return NULL;
+
+	routes->count = 0;
+	for (cur = contacts; cur != NULL; cur = cur->next)
+		routes->contacts[routes->count++] = cur->data;
+	qsort(routes->contacts, routes->count, sizeof(struct contact *),
+	      compare_contacts);
+
+	return routes;
+}
+
+void cgr_route_list_free(struct cgr_route_list *routes)
+{
+	free(routes);
+}
+
+uint64_t cgr_get_arrival_time_ms(
+	const struct contact *contact, const uint32_t size,
+	const uint64_t time_ms)
+{
+	const uint64_t start_ms = MAX(contact->from, time_ms);
+	uint64_t queued = size;
+
+	if (contact->bitrate == 0)
+		return start_ms;
+
+	// Bundles scheduled for the contact are sent first.
+	if (contact->total_capacity < CONTACT_CAPACITY_INFINITE &&
+	    contact->remaining_capacity_p0 < (int64_t)contact->total_capacity)
+		queued += contact->total_capacity -
+			contact->remaining_capacity_p0;
+
+	// Split the division to not overflow for large volumes.
+	return start_ms + queued / contact->bitrate * 1000 +
+		(queued % contact->bitrate * 1000 + contact->bitrate - 1) /
+		contact->bitrate;
+}
+
+bool cgr_find_route(
+	const struct cgr_route_list *routes, const uint32_t size,
+	const enum bundle_routing_priority priority, const uint64_t time_ms,
+	const uint64_t deadline_ms, struct cgr_route *result)
+{
+	size_t first = 0;
+
+	return cgr_find_route_from(
+		routes,
+		&first,
+		size,
+		priority,
+		time_ms,
+		deadline_ms,
+		result
+	);
+}
+
+bool cgr_find_route_from(
+	const struct cgr_route_list *routes, size_t *const first,
+	const uint32_t size, const enum bundle_routing_priority priority,
+	const uint64_t time_ms, const uint64_t deadline_ms,
+	struct cgr_route *result)
+{
+	size_t i;
+
+	ASSERT(routes != NULL);
+	ASSERT(first != NULL);
+	ASSERT(result != NULL);
+	result->contact = NULL;
+	result->arrival_time_ms = UINT64_MAX;
+	result->preemption_improved = 0;
+
+	for (i = *first; i < routes->count; i++) {
+		struct contact *const c = routes->contacts[i];
+
+		// The bundle cannot arrive before the start of the contact,
+		// thus none of the following contacts can be any better.
+		if (c->from >= result->arrival_time_ms ||
+		    c->from >= deadline_ms)
+			break;
+
+		const int64_t capacity = (
+			c->to <= time_ms
+			? 0
+			: ROUTER_CONTACT_CAPACITY(c, priority)
+		);
+
+		// Neither time nor scheduled bundles give capacity back, so
+		// leading contacts without capacity can be skipped next time.
+		if (capacity <= 0) {
+			if (i == *first)
+				(*first)++;
+			continue;
+		}
+		if (ROUTER_CONTACT_CAPACITY(c, BUNDLE_RPRIO_LOW) <
+				(int64_t)size) {
+			if (capacity >= (int64_t)size)
+				result->preemption_improved++;
+			continue;
+		}
+
+		const uint64_t arrival_ms = cgr_get_arrival_time_ms(
+			c,
+			size,
+			time_ms
+		);
+
+		if (arrival_ms >= result->arrival_time_ms ||
+		    arrival_ms > deadline_ms)
+			continue;
+		result->contact = c;
+		result->arrival_time_ms = arrival_ms;
+	}
+
+	return result->contact != NULL;
+}
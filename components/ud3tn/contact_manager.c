@@ -2,6 +2,7 @@
 #include "ud3tn/common.h"
 #include "ud3tn/config.h"
 #include "ud3tn/contact_manager.h"
+#include "ud3tn/contact_timeline.h"
 #include "ud3tn/node.h"
 #include "ud3tn/routing_table.h"
 #include "ud3tn/task_tags.h"
@@ -26,141 +27,205 @@ struct contact_manager_task_parameters {
 	Semaphore_t semaphore;
 	QueueIdentifier_t control_queue;
 	QueueIdentifier_t bp_queue;
-	struct contact_list **contact_list_ptr;
+	struct contact_timeline *contact_timeline;
 };
 
 struct contact_info {
+	// Entry in the index of active contacts by contact pointer
+	struct contact_timeline_entry by_contact;
+	// Entry in the index of active contacts by end time
+	struct contact_timeline_entry by_end;
+	// Used to pass lists of started and ended contacts around
+	struct contact_info *next;
 	struct contact *contact;
 	char *eid;
 	char *cla_addr;
+	struct cla_config *cla_config;
 };
 
 struct contact_manager_context {
-	struct contact_info current_contacts[MAX_CONCURRENT_CONTACTS];
-	int8_t current_contact_count;
+	// The set of active contacts, indexed by contact pointer and end time
+	struct contact_timeline_entry *active_by_contact;
+	struct contact_timeline_entry *active_by_end;
+	// DTN time in ms at which the next contact starts or ends
 	uint64_t next_contact_time;
 };
 
-static bool contact_active(
+static inline struct contact_info *info_by_contact(
+	struct contact_timeline_entry *e)
+{
+	return (struct contact_info *)(
+		(char *)e - offsetof(struct contact_info, by_contact)
+	);
+}
+
+static inline struct contact_info *info_by_end(
+	struct contact_timeline_entry *e)
+{
+	return (struct contact_info *)(
+		(char *)e - offsetof(struct contact_info, by_end)
+	);
+}
+
+static struct contact_info *find_active_contact(
 	const struct contact_manager_context *const ctx,
 	const struct contact *contact)
 {
-	int8_t i;
+	struct contact_timeline_entry *e = contact_index_find(
+		ctx->active_by_contact,
+		0,
+		contact
+	);
 
-	for (i = 0; i < ctx->current_contact_count; i++) {
-		if (ctx->current_contacts[i].contact == contact)
-			return true;
-	}
-	return false;
+	return e ? info_by_contact(e) : NULL;
 }
 
-static int8_t remove_expired_contacts(
+static void add_active_contact(
+	struct contact_manager_context *const ctx, struct contact_info *info)
+{
+	info->by_contact.contact = info->contact;
+	info->by_contact.time = 0;
+	contact_index_insert(&ctx->active_by_contact, &info->by_contact);
+	info->by_end.contact = info->contact;
+	info->by_end.time = info->contact->to;
+	contact_index_insert(&ctx->active_by_end, &info->by_end);
+}
+
+static void remove_active_contact(
+	struct contact_manager_context *const ctx, struct contact_info *info)
+{
+	contact_index_remove(&ctx->active_by_contact, &info->by_contact);
+	contact_index_remove(&ctx->active_by_end, &info->by_end);
+}
+
+static struct contact_info *remove_expired_contacts(
 	struct contact_manager_context *const ctx,
-	const uint64_t current_timestamp, struct contact_info list[])
+	const uint64_t current_timestamp)
 {
-	/* Check for ending contacts */
-	/* We do this first as it frees space in the list */
-	int8_t i, c, removed = 0;
-
-	for (i = ctx->current_contact_count - 1; i >= 0; i--) {
-		if (ctx->current_contacts[i].contact->to <= current_timestamp) {
-			ASSERT(i <= MAX_CONCURRENT_CONTACTS);
-			/* Unset "active" constraint */
-			ctx->current_contacts[i].contact->active = 0;
-			/* The TX task takes care of re-scheduling */
-			list[removed++] = ctx->current_contacts[i];
-			/* If it's not the last element, we have to move mem */
-			if (i != ctx->current_contact_count - 1) {
-				for (c = i; c < ctx->current_contact_count; c++)
-					ctx->current_contacts[c] =
-						ctx->current_contacts[c+1];
-			}
-			ctx->current_contact_count--;
-		}
+	struct contact_timeline_entry *e;
+	struct contact_info *info, *removed = NULL, **tail = &removed;
+
+	/* The index is sorted ascending by end, so we can stop */
+	/* checking at the first contact that has not ended yet */
+	while ((e = contact_index_first(ctx->active_by_end)) != NULL &&
+	       e->time <= current_timestamp) {
+		info = info_by_end(e);
+		remove_active_contact(ctx, info);
+		/* Unset "active" constraint */
+		info->contact->active = 0;
+		/* The TX task takes care of re-scheduling */
+		info->next = NULL;
+		*tail = info;
+		tail = &info->next;
 	}
 	return removed;
 }
 
-static uint8_t check_upcoming(
-	struct contact_manager_context *const ctx,
-	struct contact *c, struct contact_info list[], const uint8_t index)
+static void update_active_contact(
+	struct contact_manager_context *const ctx, struct contact_info *info)
 {
-	// Contact is already active, do nothing
-	if (contact_active(ctx, c))
-		return 0;
-
-	// Too many contacts are already active, cannot add another...
-	if (ctx->current_contact_count >= MAX_CONCURRENT_CONTACTS) {
-		LOGF("ContactManager: Cannot start contact with \"%s\", too many contacts are already active",
-		    c->node->eid);
-		return 0;
-	}
+	// The end of the contact may have been changed by a contact plan update
+	if (info->by_end.time == info->contact->to)
+		return;
+	contact_index_remove(&ctx->active_by_end, &info->by_end);
+	info->by_end.time = info->contact->to;
+	contact_index_insert(&ctx->active_by_end, &info->by_end);
+}
 
-	/* Set "active" constraint, "blocking" the contact */
-	c->active = 1;
+static struct contact_info *start_contact(
+	struct contact_manager_context *const ctx, struct contact *c)
+{
+	struct contact_info *info = malloc(sizeof(struct contact_info));
 
-	/* Add contact */
-	ctx->current_contacts[ctx->current_contact_count].contact = c;
-	ctx->current_contacts[ctx->current_contact_count].eid = strdup(
-		c->node->eid
-	);
-	if (!ctx->current_contacts[ctx->current_contact_count].eid) {
+	if (!info) {
+		LOG("ContactManager: Failed to allocate contact info");
+		return NULL;
+	}
+	info->contact = c;
+	info->eid = strdup(c->node->eid);
+	if (!info->eid) {
 		LOG("ContactManager: Failed to copy EID");
-		return 0;
+		free(info);
+		return NULL;
 	}
-	ctx->current_contacts[ctx->current_contact_count].cla_addr = strdup(
-		c->node->cla_addr
-	);
-	if (!ctx->current_contacts[ctx->current_contact_count].cla_addr) {
+	info->cla_addr = strdup(c->node->cla_addr);
+	if (!info->cla_addr) {
 		LOG("ContactManager: Failed to copy CLA address");
-		free(ctx->current_contacts[ctx->current_contact_count].eid);
-		return 0;
+		free(info->eid);
+		free(info);
+		return NULL;
 	}
-	list[index] = ctx->current_contacts[ctx->current_contact_count];
-	ctx->current_contact_count++;
+	info->cla_config = c->node->cla_config;
+
+	/* Set "active" constraint, "blocking" the contact */
+	c->active = 1;
+	add_active_contact(ctx, info);
 
-	return 1;
+	return info;
 }
 
-static int8_t process_upcoming_list(
-	struct contact_manager_context *const ctx,
-	struct contact_list *contact_list, const uint64_t current_timestamp,
-	struct contact_info list[])
+static void process_contact(
+	struct contact_manager_context *const ctx, struct contact *c,
+	const uint64_t current_timestamp, struct contact_info ***tail)
 {
-	int8_t added = 0;
-	struct contact_list *cur_entry;
-
-	ctx->next_contact_time = UINT64_MAX;
-	cur_entry = contact_list;
-	while (cur_entry != NULL) {
-		if (cur_entry->data->from <= current_timestamp) {
-			if (cur_entry->data->to > current_timestamp) {
-				added += check_upcoming(
-					ctx,
-					cur_entry->data,
-					list,
-					added
-				);
-				if (cur_entry->data->to < ctx->next_contact_time)
-					ctx->next_contact_time =
-						cur_entry->data->to;
-			}
-		} else {
-			if (cur_entry->data->from < ctx->next_contact_time)
-				ctx->next_contact_time = cur_entry->data->from;
-			/* As our contact_list is sorted ascending by */
-			/* from-time we can stop checking here */
-			break;
+	struct contact_info *info;
+
+	if (c->active) {
+		info = find_active_contact(ctx, c);
+		if (info != NULL)
+			update_active_contact(ctx, info);
+	} else if (c->from <= current_timestamp && c->to > current_timestamp) {
+		info = start_contact(ctx, c);
+		if (info != NULL) {
+			info->next = NULL;
+			**tail = info;
+			*tail = &info->next;
 		}
-		cur_entry = cur_entry->next;
 	}
+}
+
+static struct contact_info *process_upcoming_list(
+	struct contact_manager_context *const ctx,
+	struct contact_timeline *timeline,
+	const uint64_t current_timestamp)
+{
+	struct contact_info *added = NULL, **tail = &added;
+	struct contact_timeline_entry *e;
+	struct contact *c;
+
+	/* Contacts modified or added after they have been processed */
+	while ((c = contact_timeline_pop_changed(timeline)) != NULL)
+		process_contact(ctx, c, current_timestamp, &tail);
+
+	/* Only contacts that started since the last check are visited, */
+	/* the timeline is sorted ascending by from-time */
+	c = contact_timeline_first_start_from(
+		timeline,
+		timeline->processed_before
+	);
+	while (c != NULL && c->from <= current_timestamp) {
+		process_contact(ctx, c, current_timestamp, &tail);
+		c = contact_timeline_next_start(timeline, c);
+	}
+	if (current_timestamp >= timeline->processed_before)
+		contact_timeline_set_processed(timeline, current_timestamp + 1);
+
+	ctx->next_contact_time = contact_timeline_next_event(
+		timeline,
+		current_timestamp
+	);
+	// Active contacts removed from the timeline still have to be ended.
+	e = contact_index_first(ctx->active_by_end);
+	if (e != NULL && e->time > current_timestamp)
+		ctx->next_contact_time = MIN(ctx->next_contact_time, e->time);
 	return added;
 }
 
-static int hand_over_contact_bundles(
-	struct contact_manager_context *const ctx, Semaphore_t semphr, int8_t i)
+static void hand_over_contact_bundles(
+	struct contact_manager_context *const ctx, Semaphore_t semphr,
+	struct contact_info *info)
 {
-	struct contact_info cinfo = ctx->current_contacts[i];
+	struct contact_info cinfo = *info;
 
 	hal_semaphore_take_blocking(semphr);
 
@@ -181,37 +246,28 @@ static int hand_over_contact_bundles(
 		LOGF("ContactManager: Could not find contact %p to \"%s\" via \"%s\", discarding record",
 		     cinfo.contact, cinfo.eid, cinfo.cla_addr);
 		// Remove invalid contact info
-		free(cinfo.eid);
-		free(cinfo.cla_addr);
-		if (i < ctx->current_contact_count - 1) {
-			memmove(
-				&ctx->current_contacts[i],
-				&ctx->current_contacts[i + 1],
-				sizeof(struct contact_info) * (
-					ctx->current_contact_count - 1 - i
-				)
-			);
-		}
-		ctx->current_contact_count--;
+		remove_active_contact(ctx, info);
+		free(info->eid);
+		free(info->cla_addr);
+		free(info);
 		hal_semaphore_release(semphr);
-		return 0;
+		return;
 	}
 
 	// Contact found and valid -> continue!
 	if (cinfo.contact->contact_bundles == NULL) {
 		hal_semaphore_release(semphr);
-		return 1;
+		return;
 	}
 
 	ASSERT(cinfo.cla_addr != NULL);
-	// Try to obtain a handler
-	struct cla_config *cla_config = cla_config_get(cinfo.cla_addr);
+	struct cla_config *cla_config = cinfo.cla_config;
 
 	if (!cla_config) {
 		LOGF("ContactManager: Could not obtain CLA for address \"%s\"",
 		     cinfo.cla_addr);
 		hal_semaphore_release(semphr);
-		return 1;
+		return;
 	}
 
 	struct cla_tx_queue tx_queue = cla_config->vtable->cla_get_tx_queue(
@@ -226,106 +282,137 @@ static int hand_over_contact_bundles(
 		// Re-scheduling will be done by routerTask or transmission will
 		// occur after signal of new connection.
 		hal_semaphore_release(semphr);
-		return 1;
+		return;
 	}
 
-	LOGF("ContactManager: Queuing bundles for contact with \"%s\".",
-	     cinfo.eid);
+	struct cla_tx_backlog *const backlog = tx_queue.tx_backlog;
+
+	// Let the router account for the size the bundles actually occupy on
+	// the link, e.g., if the CLA compresses them.
+	if (backlog)
+		cinfo.contact->node->wire_size_permille =
+			backlog->wire_size_permille;
+
+	// Leave the bundles with the contact while the link is congested, the
+	// TX task requests more as soon as it reaches the low watermark.
+	if (backlog &&
+	    backlog->queued_bytes >= CONTACT_TX_QUEUE_HIGH_WATERMARK) {
+		if (!backlog->congested)
+			LOGF("ContactManager: TX queue for \"%s\" congested, deferring bundles.",
+			     cinfo.eid);
+		backlog->congested = true;
+		hal_semaphore_release(tx_queue.tx_queue_sem);
+		hal_semaphore_release(semphr);
+		return;
+	}
 
 	struct cla_contact_tx_task_command command = {
 		.type = TX_COMMAND_BUNDLES,
-		// Take over the bundles as we can now push them into the queue
-		// that is protected by the CLA semaphore.
 		.bundles = cinfo.contact->contact_bundles,
+		.cla_address = strdup(cinfo.cla_addr),
+		// Used by the TX task to pace the transmission
+		.bitrate = cinfo.contact->bitrate,
 	};
+	size_t bytes = 0;
+
+	for (struct routed_bundle_list *rbl = command.bundles; rbl;
+	     rbl = rbl->next)
+		bytes += bundle_get_serialized_size(rbl->data);
+
+	// Never block on a full queue, a slow link must not stall the
+	// handover to all other links.
+	if (!command.cla_address ||
+	    hal_queue_try_push_to_back(tx_queue.tx_queue_handle,
+				       &command, 0) != UD3TN_OK) {
+		LOGF("ContactManager: TX queue for \"%s\" full, deferring bundles.",
+		     cinfo.eid);
+		free(command.cla_address);
+		if (backlog)
+			backlog->congested = true;
+		hal_semaphore_release(tx_queue.tx_queue_sem);
+		hal_semaphore_release(semphr);
+		return;
+	}
 
-	// Ensure the Router does not interfere. We own the list now and the
-	// TX task will free it.
-	cinfo.contact->contact_bundles = NULL;
-	// Now we can also let the BP do its thing again...
-	hal_semaphore_release(semphr);
-	// NOTE: From now on, cinfo.contact MAY become invalid again!
+	LOGF("ContactManager: Queued bundles for contact with \"%s\".",
+	     cinfo.eid);
 
-	command.cla_address = strdup(cinfo.cla_addr);
-	hal_queue_push_to_back(tx_queue.tx_queue_handle, &command);
+	// Ensure the Router does not interfere. The TX task owns the list now
+	// and will free it.
+	contact_take_bundles(cinfo.contact);
+	if (backlog)
+		backlog->queued_bytes += bytes;
 	hal_semaphore_release(tx_queue.tx_queue_sem); // taken by get_tx_queue
-
-	return 1;
+	// Now we can also let the BP do its thing again...
+	hal_semaphore_release(semphr);
 }
 
-static uint8_t check_for_contacts(
+static struct contact_info *check_for_contacts(
 	struct contact_manager_context *const ctx,
-	struct contact_list *contact_list,
-	struct contact_info removed_contacts[])
+	struct contact_timeline *timeline)
 {
-	int8_t i;
-	static struct contact_info added_contacts[MAX_CONCURRENT_CONTACTS];
-	uint64_t current_timestamp = hal_time_get_timestamp_s();
-	int8_t removed_count = remove_expired_contacts(
+	struct contact_info *info;
+	uint64_t current_timestamp = hal_time_get_timestamp_ms();
+	// This also updates the end of active contacts, thus, it comes first.
+	struct contact_info *added = process_upcoming_list(
 		ctx,
-		current_timestamp,
-		removed_contacts
+		timeline,
+		current_timestamp
 	);
-	int8_t added_count = process_upcoming_list(
+	struct contact_info *removed = remove_expired_contacts(
 		ctx,
-		contact_list,
-		current_timestamp,
-		added_contacts
+		current_timestamp
 	);
 
-	for (i = 0; i < added_count; i++) {
+	for (info = added; info != NULL; info = info->next) {
 		LOGF("ContactManager: Scheduled contact with \"%s\" started (%p).",
-		     added_contacts[i].eid,
-		     added_contacts[i].contact);
+		     info->eid,
+		     info->contact);
 
-		struct cla_config *cla_config = cla_config_get(
-			added_contacts[i].cla_addr
-		);
+		struct cla_config *cla_config = info->cla_config;
 
 		if (!cla_config) {
 			LOGF("ContactManager: Could not obtain CLA for address \"%s\"",
-			     added_contacts[i].cla_addr);
+			     info->cla_addr);
 		} else {
 			cla_config->vtable->cla_start_scheduled_contact(
 				cla_config,
-				added_contacts[i].eid,
-				added_contacts[i].cla_addr
+				info->eid,
+				info->cla_addr
 			);
 		}
 	}
-	for (i = 0; i < removed_count; i++) {
+	for (info = removed; info != NULL; info = info->next) {
 		LOGF("ContactManager: Scheduled contact with \"%s\" ended (%p).",
-		     removed_contacts[i].eid,
-		     removed_contacts[i].contact);
+		     info->eid,
+		     info->contact);
 
-		struct cla_config *cla_config = cla_config_get(
-			removed_contacts[i].cla_addr
-		);
+		struct cla_config *cla_config = info->cla_config;
 
 		if (!cla_config) {
 			LOGF("ContactManager: Could not obtain CLA for address \"%s\"",
-			     removed_contacts[i].cla_addr);
+			     info->cla_addr);
 		} else {
 			cla_config->vtable->cla_end_scheduled_contact(
 				cla_config,
-				removed_contacts[i].eid,
-				removed_contacts[i].cla_addr
+				info->eid,
+				info->cla_addr
 			);
 		}
-		free(removed_contacts[i].eid);
-		free(removed_contacts[i].cla_addr);
+		free(info->eid);
+		free(info->cla_addr);
 	}
-	return removed_count;
+	return removed;
 }
 
-/* We assume that contact_list will not change. */
 static void manage_contacts(
 	struct contact_manager_context *const ctx,
-	struct contact_list **contact_list, enum contact_manager_signal signal,
+	struct contact_timeline *timeline,
+	enum contact_manager_signal signal,
 	Semaphore_t semphr, QueueIdentifier_t bp_queue)
 {
-	struct contact_info removed_list[MAX_CONCURRENT_CONTACTS];
-	int8_t removed, i;
+	struct contact_info *removed, *next;
+	struct contact_timeline_entry *e, *next_e;
 
 	ASSERT(semphr != NULL);
 	ASSERT(bp_queue != NULL);
@@ -333,9 +420,9 @@ static void manage_contacts(
 	// NOTE: CM_SIGNAL_UNKNOWN has both flags
 	if (HAS_FLAG(signal, CM_SIGNAL_UPDATE_CONTACT_LIST)) {
 		hal_semaphore_take_blocking(semphr);
-		removed = check_for_contacts(ctx, *contact_list, removed_list);
+		removed = check_for_contacts(ctx, timeline);
 		hal_semaphore_release(semphr);
-		for (i = 0; i < removed; i++) {
+		while (removed != NULL) {
 			/* The contact has to be deleted first... */
 			bundle_processor_inform(
 				bp_queue,
@@ -343,18 +430,24 @@ static void manage_contacts(
 				BP_SIGNAL_CONTACT_OVER,
 				NULL,
 				NULL,
-				removed_list[i].contact,
+				removed->contact,
 				NULL
 			);
+			next = removed->next;
+			free(removed);
+			removed = next;
 		}
 	}
 
 	// NOTE: CM_SIGNAL_UNKNOWN has both flags
 	if (HAS_FLAG(signal, CM_SIGNAL_PROCESS_CURRENT_BUNDLES)) {
-		for (int8_t i = 0; i < ctx->current_contact_count; ) {
-			// NOTE this may either return 1 or 0, the latter if it
-			// deleted an item & modified ctx->current_contact_count
-			i += hand_over_contact_bundles(ctx, semphr, i);
+		e = contact_index_first(ctx->active_by_contact);
+		while (e != NULL) {
+			// The contact info is freed if it is no longer valid.
+			next_e = contact_index_next(ctx->active_by_contact, e);
+			hand_over_contact_bundles(ctx, semphr,
+						  info_by_contact(e));
+			e = next_e;
 		}
 	}
 }
@@ -365,9 +458,9 @@ static void contact_manager_task(void *cm_parameters)
 		= (struct contact_manager_task_parameters *)cm_parameters;
 	int8_t led_state = 0;
 	enum contact_manager_signal signal = CM_SIGNAL_NONE;
-	uint64_t cur_time, next_time, delay;
 	struct contact_manager_context ctx = {
-		.current_contact_count = 0,
+		.active_by_contact = NULL,
+		.active_by_end = NULL,
 		.next_contact_time = UINT64_MAX,
 	};
 
@@ -378,33 +471,28 @@ static void contact_manager_task(void *cm_parameters)
 		if (signal != CM_SIGNAL_NONE) {
 			manage_contacts(
 				&ctx,
-				parameters->contact_list_ptr,
+				parameters->contact_timeline,
 				signal,
 				parameters->semaphore,
 				parameters->bp_queue
 			);
 		}
 		signal = CM_SIGNAL_UNKNOWN;
-		cur_time = hal_time_get_timestamp_ms();
-
-		next_time = MIN(UINT64_MAX, ctx.next_contact_time * 1000);
-		if (next_time > (cur_time + CONTACT_CHECKING_MAX_PERIOD))
-			delay = CONTACT_CHECKING_MAX_PERIOD;
-		else if (next_time <= cur_time)
+		if (ctx.next_contact_time <= hal_time_get_timestamp_ms())
 			continue;
-		else
-			delay = next_time - cur_time;
-		hal_queue_receive(
+		// Sleep until the next contact starts or ends, or until we are
+		// signaled, e.g., because the contact plan or the time changed.
+		hal_queue_receive_until(
 			parameters->control_queue,
 			&signal,
-			delay + 1
+			ctx.next_contact_time
 		);
 	}
 }
 
 struct contact_manager_params contact_manager_start(
 	QueueIdentifier_t bp_queue,
-	struct contact_list **clistptr)
+	struct contact_timeline *timeline)
 {
 	struct contact_manager_params ret = {
 		.semaphore = NULL,
@@ -431,7 +519,7 @@ struct contact_manager_params contact_manager_start(
 	cmt_params->semaphore = semaphore;
 	cmt_params->control_queue = queue;
 	cmt_params->bp_queue = bp_queue;
-	cmt_params->contact_list_ptr = clistptr;
+	cmt_params->contact_timeline = timeline;
 	hal_task_create(contact_manager_task,
 			"cont_man_t",
 			CONTACT_MANAGER_TASK_PRIORITY,
@@ -0,0 +1,374 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#include "ud3tn/common.h"
+#include "ud3tn/contact_timeline.h"
+#include "ud3tn/node.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* AVL TREE */
+
+static inline int8_t entry_height(const struct contact_timeline_entry *e)
+{
+	return e ? e->height : 0;
+}
+
+static inline void entry_update_height(struct contact_timeline_entry *e)
+{
+	e->height = 1 + MAX(entry_height(e->left), entry_height(e->right));
+}
+
+// Orders by time, entries with the same key by the address of the contact.
+static inline bool entry_less(
+	const struct contact_timeline_entry *a,
+	const struct contact_timeline_entry *b)
+{
+	if (a->time != b->time)
+		return a->time < b->time;
+	return (uintptr_t)a->contact < (uintptr_t)b->contact;
+}
+
+static struct contact_timeline_entry *rotate_right(
+	struct contact_timeline_entry *e)
+{
+	struct contact_timeline_entry *const l = e->left;
+
+	e->left = l->right;
+	l->right = e;
+	entry_update_height(e);
+	entry_update_height(l);
+	return l;
+}
+
+static struct contact_timeline_entry *rotate_left(
+	struct contact_timeline_entry *e)
+{
+	struct contact_timeline_entry *const r = e->right;
+
+	e->right = r->left;
+	r->left = e;
+	entry_update_height(e);
+	entry_update_height(r);
+	return r;
+}
+
+static struct contact_timeline_entry *rebalance(
+	struct contact_timeline_entry *e)
+{
+	const int balance = entry_height(e->left) - entry_height(e->right);
+
+	if (balance > 1) {
+		if (entry_height(e->left->left) < entry_height(e->left->right))
+			e->left = rotate_left(e->left);
+		return rotate_right(e);
+	}
+	if (balance < -1) {
+		if (entry_height(e->right->right) <
+				entry_height(e->right->left))
+			e->right = rotate_right(e->right);
+		return rotate_left(e);
+	}
+	entry_update_height(e);
+	return e;
+}
+
+static struct contact_timeline_entry *tree_insert(
+	struct contact_timeline_entry *root,
+	struct contact_timeline_entry *e)
+{
+	if (root == NULL) {
+		e->left = NULL;
+		e->right = NULL;
+		e->height = 1;
+		return e;
+	}
+	if (entry_less(e, root))
+		root->left = tree_insert(root->left, e);
+	else
+		root->right = tree_insert(root->right, e);
+	return rebalance(root);
+}
+
+static struct contact_timeline_entry *tree_remove_min(
+	struct contact_timeline_entry *root,
+	struct contact_timeline_entry **min)
+{
+	if (root->left == NULL) {
+		*min = root;
+		return root->right;
+	}
+	root->left = tree_remove_min(root->left, min);
+	return rebalance(root);
+}
+
+static struct contact_timeline_entry *tree_remove(
+	struct contact_timeline_entry *root,
+	struct contact_timeline_entry *e)
+{
+	struct contact_timeline_entry *min;
+
+	if (root == NULL)
+		return NULL;
+	if (root == e) {
+		if (e->right == NULL)
+			return e->left;
+		root = tree_remove_min(e->right, &min);
+		min->right = root;
+		min->left = e->left;
+		return rebalance(min);
+	}
+	if (entry_less(e, root))
+		root->left = tree_remove(root->left, e);
+	else
+		root->right = tree_remove(root->right, e);
+	return rebalance(root);
+}
+
+static struct contact_timeline_entry *tree_first(
+	struct contact_timeline_entry *root)
+{
+	if (root == NULL)
+		return NULL;
+	while (root->left != NULL)
+		root = root->left;
+	return root;
+}
+
+static struct contact_timeline_entry *tree_successor(
+	struct contact_timeline_entry *root,
+	const struct contact_timeline_entry *e)
+{
+	struct contact_timeline_entry *result = NULL;
+
+	while (root != NULL) {
+		if (entry_less(e, root)) {
+			result = root;
+			root = root->left;
+		} else {
+			root = root->right;
+		}
+	}
+	return result;
+}
+
+static struct contact_timeline_entry *tree_first_after(
+	struct contact_timeline_entry *root, const uint64_t time)
+{
+	struct contact_timeline_entry *result = NULL;
+
+	while (root != NULL) {
+		if (root->time > time) {
+			result = root;
+			root = root->left;
+		} else {
+			root = root->right;
+		}
+	}
+	return result;
+}
+
+/* INDEX */
+
+void contact_index_insert(
+	struct contact_timeline_entry **root, struct contact_timeline_entry *e)
+{
+	*root = tree_insert(*root, e);
+}
+
+void contact_index_remove(
+	struct contact_timeline_entry **root, struct contact_timeline_entry *e)
+{
+	*root = tree_remove(*root, e);
+}
+
+struct contact_timeline_entry *contact_index_first(
+	struct contact_timeline_entry *root)
+{
+	return tree_first(root);
+}
+
+struct contact_timeline_entry *contact_index_next(
+	struct contact_timeline_entry *root,
+	const struct contact_timeline_entry *e)
+{
+	return tree_successor(root, e);
+}
+
+struct contact_timeline_entry *contact_index_find(
+	struct contact_timeline_entry *root,
+	const uint64_t time, const struct contact *contact)
+{
+	const struct contact_timeline_entry key = {
+		.contact = (struct contact *)contact,
+		.time = time,
+	};
+
+	while (root != NULL) {
+		if (root->time == time && root->contact == contact)
+			return root;
+		if (entry_less(&key, root))
+			root = root->left;
+		else
+			root = root->right;
+	}
+	return NULL;
+}
+
+/* TIMELINE */
+
+void contact_timeline_init(struct contact_timeline *timeline)
+{
+	timeline->starts = NULL;
+	timeline->ends = NULL;
+	timeline->count = 0;
+	timeline->processed_before = 0;
+	timeline->changed = NULL;
+}
+
+void contact_timeline_insert(
+	struct contact_timeline *timeline, struct contact *contact)
+{
+	ASSERT(contact != NULL);
+	contact_timeline_remove(timeline, contact);
+	contact->timeline_start.contact = contact;
+	contact->timeline_start.time = contact->from;
+	timeline->starts = tree_insert(
+		timeline->starts,
+		&contact->timeline_start
+	);
+	contact->timeline_end.contact = contact;
+	contact->timeline_end.time = contact->to;
+	timeline->ends = tree_insert(
+		timeline->ends,
+		&contact->timeline_end
+	);
+	timeline->count++;
+	if (contact->from < timeline->processed_before || contact->active) {
+		contact->timeline_changed.contact = contact;
+		contact->timeline_changed.time = 0;
+		timeline->changed = tree_insert(
+			timeline->changed,
+			&contact->timeline_changed
+		);
+	}
+}
+
+void contact_timeline_remove(
+	struct contact_timeline *timeline, struct contact *contact)
+{
+	ASSERT(contact != NULL);
+	if (!contact_timeline_contains(contact))
+		return;
+	timeline->starts = tree_remove(
+		timeline->starts,
+		&contact->timeline_start
+	);
+	contact->timeline_start.height = 0;
+	timeline->ends = tree_remove(
+		timeline->ends,
+		&contact->timeline_end
+	);
+	contact->timeline_end.height = 0;
+	if (contact->timeline_changed.height != 0) {
+		timeline->changed = tree_remove(
+			timeline->changed,
+			&contact->timeline_changed
+		);
+		contact->timeline_changed.height = 0;
+	}
+	timeline->count--;
+}
+
+bool contact_timeline_contains(const struct contact *contact)
+{
+	return contact->timeline_start.height != 0;
+}
+
+struct contact *contact_timeline_first_start(
+	const struct contact_timeline *timeline)
+{
+	struct contact_timeline_entry *e = tree_first(timeline->starts);
+
+	return e ? e->contact : NULL;
+}
+
+struct contact *contact_timeline_next_start(
+	const struct contact_timeline *timeline, const struct contact *contact)
+{
+	struct contact_timeline_entry *e = tree_successor(
+		timeline->starts,
+		&contact->timeline_start
+	);
+
+	return e ? e->contact : NULL;
+}
+
+struct contact *contact_timeline_first_start_from(
+	const struct contact_timeline *timeline, const uint64_t time)
+{
+	struct contact_timeline_entry *e = (
+		time == 0
+		? tree_first(timeline->starts)
+		: tree_first_after(timeline->starts, time - 1)
+	);
+
+	return e ? e->contact : NULL;
+}
+
+void contact_timeline_set_processed(
+	struct contact_timeline *timeline, const uint64_t time)
+{
+	timeline->processed_before = time;
+}
+
+struct contact *contact_timeline_pop_changed(
+	struct contact_timeline *timeline)
+{
+	struct contact_timeline_entry *e = tree_first(timeline->changed);
+
+	if (e == NULL)
+		return NULL;
+	timeline->changed = tree_remove(timeline->changed, e);
+	e->height = 0;
+	return e->contact;
+}
+
+struct contact *contact_timeline_first_end(
+	const struct contact_timeline *timeline)
+{
+	struct contact_timeline_entry *e = tree_first(timeline->ends);
+
+	return e ? e->contact : NULL;
+}
+
+struct contact *contact_timeline_next_end(
+	const struct contact_timeline *timeline, const struct contact *contact)
+{
+	struct contact_timeline_entry *e = tree_successor(
+		timeline->ends,
+		&contact->timeline_end
+	);
+
+	return e ? e->contact : NULL;
+}
+
+uint64_t contact_timeline_next_event(
+	const struct contact_timeline *timeline, const uint64_t time)
+{
+	const struct contact_timeline_entry *start = tree_first_after(
+		timeline->starts,
+		time
+	);
+	const struct contact_timeline_entry *end = tree_first_after(
+		timeline->ends,
+		time
+	);
+	uint64_t result = UINT64_MAX;
+
+	if (start != NULL)
+		result = start->time;
+	if (end != NULL)
+		result = MIN(result, end->time);
+	return result;
+}
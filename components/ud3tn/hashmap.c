@@ -0,0 +1,427 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#define _POSIX_C_SOURCE 200809L // for posix_memalign()
+
+#include "ud3tn/common.h"
+#include "ud3tn/hashmap.h"
+#include "ud3tn/result.h"
+
+#include "util/htab_hash.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif /* __SSE2__ */
+
+#define CTRL_EMPTY 0x80
+#define CTRL_DELETED 0xFE
+
+// The seven least significant bits are stored in the control byte...
+#define HASH_H2(hash) ((uint8_t)((hash) & 0x7F))
+// ...and the remaining bits select the group to start probing at.
+#define HASH_H1(hash) ((hash) >> 7)
+
+// Number of old groups moved to the new table per modifying operation
+#define MIGRATION_GROUPS_PER_OP 2
+
+static inline uint32_t hash_key(const char *key)
+{
+	return hashlittle(key, strlen(key), 0);
+}
+
+static inline size_t table_capacity(const struct hashmap_table *t)
+{
+	return t->group_count * HASHMAP_GROUP_WIDTH;
+}
+
+// Maximum load factor of 7/8, including tombstones
+static inline size_t table_max_load(const struct hashmap_table *t)
+{
+	return table_capacity(t) - table_capacity(t) / 8;
+}
+
+/* GROUP MATCHING */
+
+// Returns a bit mask of all slots in the group having the given control byte
+static inline uint32_t group_match(const uint8_t *group, const uint8_t ctrl)
+{
+#ifdef __SSE2__
+	const __m128i g = _mm_load_si128((const __m128i *)group);
+
+	return (uint32_t)_mm_movemask_epi8(
+		_mm_cmpeq_epi8(g, _mm_set1_epi8((char)ctrl))
+	);
+#else /* __SSE2__ */
+	uint32_t mask = 0;
+	int i;
+
+	for (i = 0; i < HASHMAP_GROUP_WIDTH; i++)
+		mask |= (uint32_t)(group[i] == ctrl) << i;
+	return mask;
+#endif /* __SSE2__ */
+}
+
+// Returns a bit mask of all slots in the group which are empty or deleted
+static inline uint32_t group_match_free(const uint8_t *group)
+{
+#ifdef __SSE2__
+	// Both CTRL_EMPTY and CTRL_DELETED have the most significant bit set.
+	return (uint32_t)_mm_movemask_epi8(
+		_mm_load_si128((const __m128i *)group)
+	);
+#else /* __SSE2__ */
+	uint32_t mask = 0;
+	int i;
+
+	for (i = 0; i < HASHMAP_GROUP_WIDTH; i++)
+		mask |= (uint32_t)(group[i] >> 7) << i;
+	return mask;
+#endif /* __SSE2__ */
+}
+
+static inline int lowest_bit(const uint32_t mask)
+{
+	return __builtin_ctz(mask);
+}
+
+/* TABLE */
+
+static enum ud3tn_result table_alloc(
+	struct hashmap_table *t, const size_t group_count)
+{
+	const size_t capacity = group_count * HASHMAP_GROUP_WIDTH;
+
+	// The control bytes of a group are loaded with one aligned access.
+	if (posix_memalign((void **)&t->ctrl, HASHMAP_GROUP_WIDTH,
+			   capacity) != 0) {
+		t->ctrl = NULL;
+		return UD3TN_FAIL;
+	}
+	t->slots = malloc(sizeof(struct hashmap_slot) * capacity);
+	if (t->slots == NULL) {
+		free(t->ctrl);
+		t->ctrl = NULL;
+		return UD3TN_FAIL;
+	}
+	memset(t->ctrl, CTRL_EMPTY, capacity);
+	t->group_count = group_count;
+	t->used = 0;
+	t->deleted = 0;
+	return UD3TN_OK;
+}
+
+static void table_release(struct hashmap_table *t)
+{
+	free(t->ctrl);
+	free(t->slots);
+	t->ctrl = NULL;
+	t->slots = NULL;
+	t->group_count = 0;
+	t->used = 0;
+	t->deleted = 0;
+}
+
+static void table_free_keys(struct hashmap_table *t)
+{
+	const size_t capacity = table_capacity(t);
+	size_t i;
+
+	for (i = 0; i < capacity; i++) {
+		if (!(t->ctrl[i] & 0x80))
+			free((char *)t->slots[i].key);
+	}
+}
+
+/*
+ * Probes the groups of the table in a triangular sequence, which visits
+ * every group exactly once as the group count is a power of two.
+ */
+static struct hashmap_slot *table_find(
+	const struct hashmap_table *t, const char *key, const uint32_t hash,
+	size_t *index)
+{
+	const size_t group_mask = t->group_count - 1;
+	size_t group = HASH_H1(hash) & group_mask;
+	size_t step;
+	uint32_t match;
+
+	if (t->group_count == 0 || t->used == 0)
+		return NULL;
+	for (step = 1; step <= t->group_count; step++) {
+		const uint8_t *ctrl = &t->ctrl[group * HASHMAP_GROUP_WIDTH];
+
+		match = group_match(ctrl, HASH_H2(hash));
+		while (match) {
+			const size_t i = group * HASHMAP_GROUP_WIDTH +
+				lowest_bit(match);
+			struct hashmap_slot *const slot = &t->slots[i];
+
+			if (slot->hash == hash && strcmp(slot->key, key) == 0) {
+				if (index != NULL)
+					*index = i;
+				return slot;
+			}
+			match &= match - 1;
+		}
+		// An empty slot terminates every probe sequence.
+		if (group_match(ctrl, CTRL_EMPTY))
+			return NULL;
+		group = (group + step) & group_mask;
+	}
+	return NULL;
+}
+
+// Inserts an entry known not to be contained in the table.
+static void table_insert(
+	struct hashmap_table *t, const char *key, const uint32_t hash,
+	void *value)
+{
+	const size_t group_mask = t->group_count - 1;
+	size_t group = HASH_H1(hash) & group_mask;
+	size_t step = 1;
+	uint32_t match;
+	size_t i;
+
+	for (;;) {
+		match = group_match_free(&t->ctrl[group * HASHMAP_GROUP_WIDTH]);
+		if (match)
+			break;
+		group = (group + step++) & group_mask;
+		ASSERT(step <= t->group_count);
+	}
+	i = group * HASHMAP_GROUP_WIDTH + lowest_bit(match);
+	if (t->ctrl[i] == CTRL_DELETED)
+		t->deleted--;
+	t->ctrl[i] = HASH_H2(hash);
+	t->slots[i].hash = hash;
+	t->slots[i].key = key;
+	t->slots[i].value = value;
+	t->used++;
+}
+
+static void table_erase(struct hashmap_table *t, const size_t index)
+{
+	const size_t group = index / HASHMAP_GROUP_WIDTH;
+
+	/*
+	 * If the group still contains an empty slot, no probe sequence can
+	 * have continued past it, thus, the slot can be marked empty again.
+	 */
+	if (group_match(&t->ctrl[group * HASHMAP_GROUP_WIDTH], CTRL_EMPTY)) {
+		t->ctrl[index] = CTRL_EMPTY;
+	} else {
+		t->ctrl[index] = CTRL_DELETED;
+		t->deleted++;
+	}
+	t->used--;
+}
+
+/* MIGRATION */
+
+static void migrate_groups(struct hashmap *map, size_t groups)
+{
+	struct hashmap_table *const old = &map->old_table;
+	size_t i, end;
+
+	if (old->ctrl == NULL)
+		return;
+	while (groups-- && map->migrated_groups < old->group_count) {
+		i = map->migrated_groups * HASHMAP_GROUP_WIDTH;
+		end = i + HASHMAP_GROUP_WIDTH;
+		for (; i < end; i++) {
+			if (old->ctrl[i] & 0x80)
+				continue;
+			table_insert(
+				&map->table,
+				old->slots[i].key,
+				old->slots[i].hash,
+				old->slots[i].value
+			);
+			// Keeps probe sequences in the old table intact.
+			old->ctrl[i] = CTRL_DELETED;
+			old->used--;
+			old->deleted++;
+		}
+		map->migrated_groups++;
+	}
+	if (map->migrated_groups == old->group_count) {
+		ASSERT(old->used == 0);
+		table_release(old);
+		map->migrated_groups = 0;
+	}
+}
+
+static enum ud3tn_result start_resize(struct hashmap *map)
+{
+	struct hashmap_table *const t = &map->table;
+	struct hashmap_table new_table;
+	size_t group_count = t->group_count;
+
+	// Only one resize can be in progress at a time.
+	migrate_groups(map, SIZE_MAX);
+	// If the load is mostly caused by tombstones, rehash in place.
+	if (t->used * 2 > table_capacity(t))
+		group_count *= 2;
+	if (table_alloc(&new_table, group_count) != UD3TN_OK)
+		return UD3TN_FAIL;
+	map->old_table = *t;
+	map->table = new_table;
+	map->migrated_groups = 0;
+	return UD3TN_OK;
+}
+
+/* MAP */
+
+enum ud3tn_result hashmap_init(
+	struct hashmap *map, const size_t capacity, const bool borrow_keys)
+{
+	size_t group_count = 1;
+
+	ASSERT(map != NULL);
+	while (group_count * HASHMAP_GROUP_WIDTH * 7 / 8 < capacity)
+		group_count *= 2;
+	map->old_table = (struct hashmap_table){ .ctrl = NULL };
+	map->migrated_groups = 0;
+	map->borrow_keys = borrow_keys;
+	return table_alloc(&map->table, group_count);
+}
+
+void hashmap_free(struct hashmap *map)
+{
+	ASSERT(map != NULL);
+	if (!map->borrow_keys) {
+		table_free_keys(&map->table);
+		if (map->old_table.ctrl != NULL)
+			table_free_keys(&map->old_table);
+	}
+	table_release(&map->table);
+	table_release(&map->old_table);
+	map->migrated_groups = 0;
+}
+
+void hashmap_clear(struct hashmap *map)
+{
+	ASSERT(map != NULL);
+	if (!map->borrow_keys) {
+		table_free_keys(&map->table);
+		if (map->old_table.ctrl != NULL)
+			table_free_keys(&map->old_table);
+	}
+	table_release(&map->old_table);
+	map->migrated_groups = 0;
+	memset(map->table.ctrl, CTRL_EMPTY, table_capacity(&map->table));
+	map->table.used = 0;
+	map->table.deleted = 0;
+}
+
+enum ud3tn_result hashmap_add(
+	struct hashmap *map, const char *key, void *value)
+{
+	const uint32_t hash = hash_key(key);
+	char *stored_key;
+
+	ASSERT(map != NULL);
+	if (hashmap_get(map, key) != NULL)
+		return UD3TN_FAIL;
+	if (map->table.used + map->table.deleted + 1 >
+			table_max_load(&map->table)) {
+		if (start_resize(map) != UD3TN_OK)
+			return UD3TN_FAIL;
+	}
+	if (map->borrow_keys) {
+		stored_key = (char *)key;
+	} else {
+		stored_key = strdup(key);
+		if (stored_key == NULL)
+			return UD3TN_FAIL;
+	}
+	table_insert(&map->table, stored_key, hash, value);
+	migrate_groups(map, MIGRATION_GROUPS_PER_OP);
+	return UD3TN_OK;
+}
+
+void *hashmap_get(const struct hashmap *map, const char *key)
+{
+	const uint32_t hash = hash_key(key);
+	struct hashmap_slot *slot;
+
+	ASSERT(map != NULL);
+	slot = table_find(&map->table, key, hash, NULL);
+	if (slot == NULL && map->old_table.ctrl != NULL)
+		slot = table_find(&map->old_table, key, hash, NULL);
+	return slot ? slot->value : NULL;
+}
+
+void *hashmap_remove(struct hashmap *map, const char *key)
+{
+	const uint32_t hash = hash_key(key);
+	struct hashmap_table *t = &map->table;
+	struct hashmap_slot *slot;
+	size_t index;
+	void *value;
+
+	ASSERT(map != NULL);
+	slot = table_find(t, key, hash, &index);
+	if (slot == NULL && map->old_table.ctrl != NULL) {
+		t = &map->old_table;
+		slot = table_find(t, key, hash, &index);
+	}
+	if (slot == NULL)
+		return NULL;
+	value = slot->value;
+	if (!map->borrow_keys)
+		free((char *)slot->key);
+	if (t == &map->old_table) {
+		// Keeps probe sequences in the old table intact.
+		t->ctrl[index] = CTRL_DELETED;
+		t->used--;
+		t->deleted++;
+	} else {
+		table_erase(t, index);
+	}
+	migrate_groups(map, MIGRATION_GROUPS_PER_OP);
+	return value;
+}
+
+size_t hashmap_count(const struct hashmap *map)
+{
+	return map->table.used + map->old_table.used;
+}
+
+bool hashmap_iterate(
+	const struct hashmap *map, size_t *iter,
+	const char **key, void **value)
+{
+	const size_t capacity = table_capacity(&map->table);
+	const size_t old_capacity = (
+		map->old_table.ctrl != NULL
+		? table_capacity(&map->old_table)
+		: 0
+	);
+	const struct hashmap_table *t;
+	size_t i;
+
+	ASSERT(iter != NULL);
+	while (*iter < capacity + old_capacity) {
+		if (*iter < capacity) {
+			t = &map->table;
+			i = *iter;
+		} else {
+			t = &map->old_table;
+			i = *iter - capacity;
+		}
+		(*iter)++;
+		if (t->ctrl[i] & 0x80)
+			continue;
+		if (key != NULL)
+			*key = t->slots[i].key;
+		if (value != NULL)
+			*value = t->slots[i].value;
+		return true;
+	}
+	return false;
+}
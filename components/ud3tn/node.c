@@ -27,6 +27,9 @@ struct node *node_create(char *eid)
 		return NULL;
 
 	ret->cla_addr = NULL;
+	ret->cla_config = NULL;
+	ret->cla_mbs = 0;
+	ret->wire_size_permille = 1000;
 	ret->flags = NODE_FLAG_NONE;
 	ret->endpoints = NULL;
 	ret->contacts = NULL;
@@ -40,6 +43,7 @@ struct node *node_create(char *eid)
 struct contact *contact_create(struct node *node)
 {
 	struct contact *ret = malloc(sizeof(struct contact));
+	int p;
 
 	if (ret == NULL)
 		return NULL;
@@ -53,8 +57,16 @@ struct contact *contact_create(struct node *node)
 	ret->remaining_capacity_p2 = 0;
 	ret->contact_endpoints = NULL;
 	ret->contact_bundles = NULL;
+	for (p = 0; p < BUNDLE_RPRIO_MAX; p++)
+		ret->contact_bundles_tail[p] = NULL;
 	ret->bundle_count = 0;
+	ret->bundle_bytes = 0;
 	ret->active = 0;
+	ret->timeline_start = (struct contact_timeline_entry){ .contact = ret };
+	ret->timeline_end = (struct contact_timeline_entry){ .contact = ret };
+	ret->timeline_changed = (struct contact_timeline_entry){
+		.contact = ret
+	};
 	return ret;
 }
 
@@ -73,7 +85,7 @@ static void free_contact_internal(
 			cur_eid = endpoint_list_free(cur_eid);
 	}
 	/* Free associated bundle list (not bundles themselves) */
-	cur_bundle = contact->contact_bundles;
+	cur_bundle = contact_take_bundles(contact);
 	while (cur_bundle != NULL) {
 		next = cur_bundle->next;
 		free(cur_bundle);
@@ -281,6 +293,7 @@ static inline void add_to_modified_list(
 static inline bool merge_contacts(struct contact *old, struct contact *new)
 {
 	const uint64_t old_duration = old->to - old->from;
+	const bool endpoints_added = new->contact_endpoints != NULL;
 
 	old->from = MIN(old->from, new->from);
 	old->to = MAX(old->to, new->to);
@@ -295,7 +308,8 @@ static inline bool merge_contacts(struct contact *old, struct contact *new)
 		recalculate_contact_capacity(old);
 		return true;
 	}
-	return false;
+	/* The contact may be reachable via further EIDs */
+	return endpoints_added;
 }
 
 struct contact_list *contact_list_union(
@@ -305,7 +319,7 @@ struct contact_list *contact_list_union(
 	struct contact_list **cur_slot = &a;
 	struct contact_list *cur_can = b;
 	struct contact_list *next_can;
-	uint64_t cur_from, cur_to;
+	uint64_t cur_from;
 	bool modified;
 
 	ASSERT(contact_list_sorted(a, 1));
@@ -316,7 +330,6 @@ struct contact_list *contact_list_union(
 		return a;
 	while (*cur_slot != NULL) {
 		cur_from = (*cur_slot)->data->from;
-		cur_to = (*cur_slot)->data->to;
 		ASSERT((*cur_slot)->data->node != NULL);
 		/* Traverse b linearly and insert contacts "smaller" than the
 		 * current one in a before it.
@@ -354,13 +367,14 @@ struct contact_list *contact_list_union(
 			cur_can = next_can;
 		}
 
-		// Check rest of cur_can if can->from < slot->to and same node
+		// Check rest of cur_can if can->from < slot->to and same node,
+		// as b is sorted we can stop at the first one starting later.
 		struct contact_list **cur_can_p = &cur_can;
 
-		while (*cur_can_p != NULL) {
+		while (*cur_can_p != NULL &&
+		       (*cur_can_p)->data->from < (*cur_slot)->data->to) {
 			ASSERT((*cur_can_p)->data->node != NULL);
-			if ((*cur_can_p)->data->from < cur_to &&
-			    strcmp((*cur_can_p)->data->node->eid,
+			if (strcmp((*cur_can_p)->data->node->eid,
 				   (*cur_slot)->data->node->eid) == 0) {
 				// overlap -> merge
 				modified = merge_contacts(
@@ -485,62 +499,80 @@ int node_prepare_and_verify(struct node *node)
 			return 0;
 		cl->data->contact_endpoints = endpoint_list_strip_and_sort(
 			cl->data->contact_endpoints);
+		/* As the list is sorted by from-time, any overlap involves */
+		/* the next contact */
 		i = cl->next;
-		while (i != NULL) {
-			if (contacts_overlap(cl->data, i->data))
-				return 0;
-			i = i->next;
-		}
+		if (i != NULL && contacts_overlap(cl->data, i->data))
+			return 0;
 		cl = cl->next;
 	}
 	return 1;
 }
 
+// Returns the number of bytes sent at the given bitrate (in bytes per second)
+// within the given time in ms, or CONTACT_CAPACITY_INFINITE if too large.
+static uint64_t get_volume(const uint64_t duration_ms, const uint64_t bitrate)
+{
+	const uint64_t duration_s = duration_ms / 1000;
+	const uint64_t rest_ms = duration_ms % 1000;
+	uint64_t volume, rest_volume;
+
+	if (bitrate != 0 && duration_s >= CONTACT_CAPACITY_INFINITE / bitrate)
+		return CONTACT_CAPACITY_INFINITE;
+	volume = duration_s * bitrate;
+	rest_volume = (
+		bitrate / 1000 * rest_ms +
+		bitrate % 1000 * rest_ms / 1000
+	);
+	if (rest_volume >= CONTACT_CAPACITY_INFINITE - volume)
+		return CONTACT_CAPACITY_INFINITE;
+	return volume + rest_volume;
+}
+
 void recalculate_contact_capacity(struct contact *contact)
 {
-	uint64_t duration, new_capacity;
-	int32_t capacity_difference;
+	uint64_t new_capacity;
+	int64_t capacity_difference;
 
 	ASSERT(contact != NULL);
-	duration = contact->to - contact->from;
-	new_capacity = duration * contact->bitrate;
-	// If the calculation overflows or the capacity is > INT32_MAX,
-	// we assume an "infinite" contact capacity.
-	if ((duration != 0 && new_capacity / duration != contact->bitrate) ||
-	    new_capacity >= INT32_MAX) {
-		contact->total_capacity = INT32_MAX;
-		contact->remaining_capacity_p0 = INT32_MAX;
-		contact->remaining_capacity_p1 = INT32_MAX;
-		contact->remaining_capacity_p2 = INT32_MAX;
+	new_capacity = get_volume(contact->to - contact->from, contact->bitrate);
+	// If the capacity cannot be represented, we assume an "infinite"
+	// contact capacity.
+	if (new_capacity == CONTACT_CAPACITY_INFINITE) {
+		contact->total_capacity = CONTACT_CAPACITY_INFINITE;
+		contact->remaining_capacity_p0 = CONTACT_CAPACITY_INFINITE;
+		contact->remaining_capacity_p1 = CONTACT_CAPACITY_INFINITE;
+		contact->remaining_capacity_p2 = CONTACT_CAPACITY_INFINITE;
 		return;
 	}
-	capacity_difference = new_capacity - (int32_t)contact->total_capacity;
-	contact->total_capacity = (uint32_t)new_capacity;
+	capacity_difference = new_capacity - (int64_t)contact->total_capacity;
+	contact->total_capacity = new_capacity;
 	contact->remaining_capacity_p0 += capacity_difference;
 	contact->remaining_capacity_p1 += capacity_difference;
 	contact->remaining_capacity_p2 += capacity_difference;
 }
 
-int32_t contact_get_cur_remaining_capacity(
+int64_t contact_get_cur_remaining_capacity(
 	struct contact *contact, enum bundle_routing_priority prio)
 {
 	uint64_t time;
 	uint64_t cap_left;
-	int32_t cap_result;
 
 	ASSERT(contact != NULL);
-	time = hal_time_get_timestamp_s();
+	time = hal_time_get_timestamp_ms();
 	if (time >= contact->to)
 		return 0;
 	if (time <= contact->from)
 		return CONTACT_CAPACITY(contact, prio);
-	if (contact->total_capacity >= INT32_MAX)
-		return INT32_MAX;
-	cap_left = contact->total_capacity
-		* (uint64_t)(contact->to - time)
-		/ (uint64_t)(contact->to - contact->from);
-	cap_result = cap_left;
-	return MIN(cap_result, CONTACT_CAPACITY(contact, prio));
+	if (contact->total_capacity >= CONTACT_CAPACITY_INFINITE)
+		return CONTACT_CAPACITY_INFINITE;
+	// Same as total_capacity * (to - time) / (to - from), which could
+	// overflow for large contacts.
+	cap_left = MIN(
+		get_volume(contact->to - time, contact->bitrate),
+		contact->total_capacity
+	);
+	return MIN((int64_t)cap_left, CONTACT_CAPACITY(contact, prio));
 }
 
 int add_contact_to_ordered_list(
@@ -592,3 +624,81 @@ int remove_contact_from_list(
 	}
 	return 0;
 }
+
+void contact_append_bundle_entry(
+	struct contact *contact, struct routed_bundle_list *entry)
+{
+	struct routed_bundle_list *prev = NULL;
+	int p;
+
+	ASSERT(entry->priority < BUNDLE_RPRIO_MAX);
+	// Insert after the last entry with the same or a higher priority.
+	for (p = entry->priority; p < BUNDLE_RPRIO_MAX && prev == NULL; p++)
+		prev = contact->contact_bundles_tail[p];
+	entry->prev = prev;
+	if (prev != NULL) {
+		entry->next = prev->next;
+		prev->next = entry;
+	} else {
+		entry->next = contact->contact_bundles;
+		contact->contact_bundles = entry;
+	}
+	if (entry->next != NULL)
+		entry->next->prev = entry;
+	contact->contact_bundles_tail[entry->priority] = entry;
+	contact->bundle_count++;
+	contact->bundle_bytes += entry->scheduled_size;
+}
+
+void contact_remove_bundle_entry(
+	struct contact *contact, struct routed_bundle_list *entry)
+{
+	struct routed_bundle_list **const tail =
+		&contact->contact_bundles_tail[entry->priority];
+
+	ASSERT(contact->bundle_count != 0);
+	if (*tail == entry) {
+		if (entry->prev != NULL &&
+		    entry->prev->priority == entry->priority)
+			*tail = entry->prev;
+		else
+			*tail = NULL;
+	}
+	if (entry->prev != NULL)
+		entry->prev->next = entry->next;
+	else
+		contact->contact_bundles = entry->next;
+	if (entry->next != NULL)
+		entry->next->prev = entry->prev;
+	entry->next = NULL;
+	entry->prev = NULL;
+	contact->bundle_count--;
+	contact->bundle_bytes -= entry->scheduled_size;
+}
+
+struct routed_bundle_list *contact_find_bundle_entry(
+	const struct contact *contact, const struct bundle *bundle,
+	const enum bundle_routing_priority prio)
+{
+	struct routed_bundle_list *cur;
+
+	for (cur = contact->contact_bundles_tail[prio];
+	     cur != NULL && cur->priority == prio; cur = cur->prev) {
+		if (cur->data == bundle)
+			return cur;
+	}
+	return NULL;
+}
+
+struct routed_bundle_list *contact_take_bundles(struct contact *contact)
+{
+	struct routed_bundle_list *const list = contact->contact_bundles;
+	int p;
+
+	contact->contact_bundles = NULL;
+	for (p = 0; p < BUNDLE_RPRIO_MAX; p++)
+		contact->contact_bundles_tail[p] = NULL;
+	contact->bundle_count = 0;
+	contact->bundle_bytes = 0;
+	return list;
+}
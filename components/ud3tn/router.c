@@ -1,7 +1,9 @@
 // SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
 #include "ud3tn/bundle.h"
+#include "ud3tn/cgr.h"
 #include "ud3tn/common.h"
 #include "ud3tn/eid.h"
+#include "ud3tn/hashmap.h"
 #include "ud3tn/node.h"
 #include "ud3tn/router.h"
 #include "ud3tn/routing_table.h"
@@ -10,6 +12,7 @@
 
 #include "platform/hal_io.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
@@ -20,6 +23,23 @@ static struct router_config RC = {
 	.router_min_contacts_htab = ROUTER_MIN_CONTACTS_HTAB,
 };
 
+struct route_cache_entry {
+	// Routing table generation the node table entry is valid for
+	uint32_t generation;
+	// Value of capacity_generation the route hints are valid for
+	uint32_t hint_generation;
+	// NULL if the destination cannot be reached
+	struct node_table_entry *node_entry;
+	// Index of the first route worth checking, per routing priority
+	size_t first_route[BUNDLE_RPRIO_MAX];
+};
+
+// Destination EID -> struct route_cache_entry
+static struct hashmap route_cache;
+static bool route_cache_initialized;
+// Incremented whenever capacity is given back to a contact
+static uint32_t capacity_generation;
+
 struct router_config router_get_config(void)
 {
 	return RC;
@@ -30,10 +50,44 @@ void router_update_config(struct router_config conf)
 	RC = conf;
 }
 
-struct contact_list *router_lookup_destination(char *const dest)
+// The remaining capacity in bytes of serialized bundles, which may be more
+// than the capacity on the wire if the CLA of the node compresses bundles.
+int64_t router_get_contact_capacity(
+	struct contact *contact, enum bundle_routing_priority prio)
+{
+	const int64_t capacity = contact_get_cur_remaining_capacity(
+		contact,
+		prio
+	);
+	const uint16_t permille = contact->node->wire_size_permille;
+
+	if (capacity <= 0 || capacity == CONTACT_CAPACITY_INFINITE ||
+	    permille == 1000)
+		return capacity;
+
+	// Scale without overflowing for capacities close to the limit.
+	if ((uint64_t)capacity / permille >= CONTACT_CAPACITY_INFINITE / 1000)
+		return CONTACT_CAPACITY_INFINITE - 1;
+	return capacity / permille * 1000 +
+		capacity % permille * 1000 / permille;
+}
+
+// The capacity of the contact occupied by a bundle of the given size.
+static uint64_t router_get_scheduled_size(
+	const struct contact *contact, const size_t bundle_size)
+{
+	const uint16_t permille = contact->node->wire_size_permille;
+
+	if (permille == 1000)
+		return bundle_size;
+
+	return ((uint64_t)bundle_size * permille + 999) / 1000;
+}
+
+struct node_table_entry *router_lookup_destination(const char *const dest)
 {
 	char *dest_node_eid = get_node_id(dest);
-	const struct node_table_entry *e = NULL;
+	struct node_table_entry *e = NULL;
 
 	if (dest_node_eid)
 		e = routing_table_lookup_eid(dest_node_eid);
@@ -42,36 +96,73 @@ struct contact_list *router_lookup_destination(char *const dest)
 	if (!dest_node_eid || !e)
 		e = routing_table_lookup_eid(dest);
 
-	uint16_t results = 0;
-	struct contact_list *result = NULL;
+	free(dest_node_eid);
 
-	if (e != NULL) {
-		struct contact_list *cur = e->contacts;
+	return e;
+}
 
-		while (cur != NULL) {
-			add_contact_to_ordered_list(&result, cur->data, 0);
-			results++;
-			cur = cur->next;
-		}
+void router_clear_route_cache(void)
+{
+	size_t iter = 0;
+	void *entry;
+
+	if (!route_cache_initialized)
+		return;
+	while (hashmap_iterate(&route_cache, &iter, NULL, &entry))
+		free(entry);
+	hashmap_clear(&route_cache);
+}
+
+static struct route_cache_entry *router_get_cached_routes(
+	const char *const dest)
+{
+	const uint32_t generation = routing_table_get_generation();
+	struct route_cache_entry *e;
+
+	if (!route_cache_initialized) {
+		if (hashmap_init(&route_cache, ROUTER_ROUTE_CACHE_SIZE,
+				 false) != UD3TN_OK)
+			return NULL;
+		route_cache_initialized = true;
 	}
 
-	free(dest_node_eid);
+	e = hashmap_get(&route_cache, dest);
+	if (e == NULL) {
+		if (hashmap_count(&route_cache) >= ROUTER_ROUTE_CACHE_SIZE)
+			router_clear_route_cache();
+		e = malloc(sizeof(struct route_cache_entry));
+		if (e == NULL)
+			return NULL;
+		if (hashmap_add(&route_cache, dest, e) != UD3TN_OK) {
+			free(e);
+			return NULL;
+		}
+		e->generation = generation - 1;
+	}
 
-	return result;
+	if (e->generation != generation) {
+		e->generation = generation;
+		e->node_entry = router_lookup_destination(dest);
+		e->hint_generation = capacity_generation - 1;
+	}
+	if (e->hint_generation != capacity_generation) {
+		e->hint_generation = capacity_generation;
+		memset(e->first_route, 0, sizeof(e->first_route));
+	}
+	return e;
 }
 
 static inline struct max_fragment_size_result {
-	uint32_t max_fragment_size;
-	uint32_t payload_capacity;
+	uint64_t max_fragment_size;
+	uint64_t payload_capacity;
 } router_get_max_reasonable_fragment_size(
 	struct contact_list *contacts, uint32_t full_size,
 	uint32_t max_fragment_min_size, uint32_t payload_size,
 	enum bundle_routing_priority priority, uint64_t exp_time)
 {
-	uint32_t payload_capacity = 0;
-	uint32_t max_frag_size = UINT32_MAX;
-	uint32_t min_capacity, c_capacity;
-	int32_t c_pay_capacity;
+	uint64_t payload_capacity = 0;
+	uint64_t max_frag_size = UINT64_MAX;
+	int64_t min_capacity, c_capacity, c_pay_capacity;
 	struct contact *c;
 
 	(void)exp_time;
@@ -86,26 +177,19 @@ static inline struct max_fragment_size_result {
 		if (c_capacity < min_capacity)
 			continue;
 
-		// A CLA may have a maximum bundle size, determine it
-		struct cla_config *const cla_config = cla_config_get(
-			c->node->cla_addr
-		);
-
-		if (!cla_config)
+		// A CLA may have a maximum bundle size, cached on the node
+		if (!c->node->cla_config)
 			continue;
 
-		const size_t c_mbs = MIN(
-			MIN(
-				(size_t)c_capacity,
-				cla_config->vtable->cla_mbs_get(cla_config)
-			),
+		const uint64_t c_mbs = MIN(
+			MIN((uint64_t)c_capacity, c->node->cla_mbs),
 			RC.global_mbs
 		);
 
 		// Contact of "infinite" capacity -> max. frag. size == MBS
-		if (c_capacity >= INT32_MAX)
+		if (c_capacity == CONTACT_CAPACITY_INFINITE)
 			return (struct max_fragment_size_result){
-				MIN((uint32_t)INT32_MAX, c_mbs),
+				c_mbs,
 				payload_size,
 			};
 
@@ -125,12 +209,12 @@ static inline struct max_fragment_size_result {
 
 uint8_t router_calculate_fragment_route(
 	struct fragment_route *res, uint32_t size,
-	struct contact_list *contacts, uint32_t preprocessed_size,
+	struct contact_list *contacts, uint64_t preprocessed_size,
 	enum bundle_routing_priority priority, uint64_t exp_time,
 	struct contact **excluded_contacts, uint8_t excluded_contacts_count)
 {
-	uint64_t time = hal_time_get_timestamp_s();
-	uint32_t cap;
+	uint64_t time = hal_time_get_timestamp_ms();
+	int64_t cap;
 	uint8_t d, i;
 	struct contact *c;
 
@@ -149,9 +233,9 @@ uint8_t router_calculate_fragment_route(
 			continue; // Ignore -- NOTE: List is ordered by c->to
 		if (c->to <= time)
 			continue;
-		cap = ROUTER_CONTACT_CAPACITY(c, 0);
+		cap = MAX(ROUTER_CONTACT_CAPACITY(c, 0), 0);
 		if (preprocessed_size != 0) {
-			if (preprocessed_size >= cap) {
+			if (preprocessed_size >= (uint64_t)cap) {
 				preprocessed_size -= cap;
 				continue;
 			} else {
@@ -160,8 +244,8 @@ uint8_t router_calculate_fragment_route(
 			}
 		}
 		if (cap < size) {
-			if ((ROUTER_CONTACT_CAPACITY(c, priority)
-					- preprocessed_size) >= size)
+			if (ROUTER_CONTACT_CAPACITY(c, priority) >=
+					(int64_t)(preprocessed_size + size))
 				res->preemption_improved++;
 			preprocessed_size = 0;
 			continue;
@@ -175,38 +259,50 @@ uint8_t router_calculate_fragment_route(
 }
 
 static inline void router_get_first_route_nonfrag(
-	struct router_result *res, struct contact_list *contacts,
-	struct bundle *bundle, uint32_t bundle_size, uint64_t expiration_time)
+	struct router_result *res, struct node_table_entry *entry,
+	size_t *first_route, struct bundle *bundle, uint32_t bundle_size,
+	uint64_t expiration_time)
 {
+	const struct cgr_route_list *routes = routing_table_get_routes(entry);
+	struct cgr_route route;
+
+	if (routes == NULL) {
+		LOG("Router: Could not allocate route list");
+		return;
+	}
+
 	res->fragment_results[0].payload_size
 		= bundle->payload_block->length;
-	/* Determine route */
-	if (router_calculate_fragment_route(
-		&res->fragment_results[0], bundle_size,
-		contacts, 0, ROUTER_BUNDLE_PRIORITY(bundle), expiration_time,
-		NULL, 0)
+	/* Determine route with the earliest arrival time */
+	if (cgr_find_route_from(
+		routes, first_route, bundle_size,
+		ROUTER_BUNDLE_PRIORITY(bundle),
+		hal_time_get_timestamp_ms(),
+		expiration_time,
+		&route)
 	) {
+		res->fragment_results[0].contact = route.contact;
 		res->fragments = 1;
-		res->preemption_improved
-			= res->fragment_results[0].preemption_improved;
 	}
+	res->preemption_improved = route.preemption_improved;
 }
 
 static inline void router_get_first_route_frag(
 	struct router_result *res, struct contact_list *contacts,
 	struct bundle *bundle, uint32_t bundle_size, uint64_t expiration_time,
-	uint32_t max_frag_sz, uint32_t first_frag_sz, uint32_t last_frag_sz)
+	uint64_t max_frag_sz, uint32_t first_frag_sz, uint32_t last_frag_sz)
 {
-	uint32_t mid_frag_sz, next_frag_sz, remaining_pay, processed_sz;
-	int32_t min_pay, max_pay;
+	uint32_t mid_frag_sz, next_frag_sz, remaining_pay;
+	uint64_t processed_sz;
+	int64_t min_pay, max_pay;
 	int32_t success, index;
 
 	/* Determine fragment minimum sizes */
 	mid_frag_sz = bundle_get_mid_fragment_min_size(bundle);
 	next_frag_sz = first_frag_sz;
 	if (next_frag_sz > max_frag_sz || last_frag_sz > max_frag_sz) {
-		LOGF("Router: Cannot fragment because max. frag. size of %lu bytes is smaller than bundle headers (first = %lu, mid = %lu, last = %lu)",
-		     max_frag_sz, next_frag_sz, mid_frag_sz, last_frag_sz);
+		LOGF("Router: Cannot fragment because max. frag. size of %llu bytes is smaller than bundle headers (first = %lu, mid = %lu, last = %lu)",
+		     (unsigned long long)max_frag_sz, next_frag_sz, mid_frag_sz, last_frag_sz);
 		return; /* failed */
 	}
 
@@ -215,8 +311,8 @@ static inline void router_get_first_route_frag(
 		min_pay = MIN(remaining_pay, RC.fragment_min_payload);
 		max_pay = max_frag_sz - next_frag_sz;
 		if (max_pay < min_pay) {
-			LOGF("Router: Cannot fragment because minimum amount of payload (%lu bytes) will not fit in fragment with maximum payload size of %lu bytes",
-			     min_pay, max_pay);
+			LOGF("Router: Cannot fragment because minimum amount of payload (%lld bytes) will not fit in fragment with maximum payload size of %lld bytes",
+			     (long long)min_pay, (long long)max_pay);
 			break; /* failed: remaining_pay != 0 */
 		}
 		if (remaining_pay <= max_frag_sz - last_frag_sz) {
@@ -226,7 +322,7 @@ static inline void router_get_first_route_frag(
 			remaining_pay = 0;
 		} else {
 			/* Another fragment */
-			max_pay = MIN((int32_t)remaining_pay, max_pay);
+			max_pay = MIN((int64_t)remaining_pay, max_pay);
 			res->fragment_results[res->fragments++].payload_size
 				= max_pay;
 			remaining_pay -= max_pay;
@@ -265,13 +361,24 @@ static inline void router_get_first_route_frag(
 /* max. ~200 bytes on stack */
 struct router_result router_get_first_route(struct bundle *bundle)
 {
-	const uint64_t expiration_time = bundle_get_expiration_time_s(bundle, hal_time_get_timestamp_s());
-	struct router_result res;
-	struct contact_list *contacts
-		= router_lookup_destination(bundle->destination);
+	const uint64_t expiration_time = bundle_get_expiration_time_ms(
+		bundle,
+		hal_time_get_timestamp_ms()
+	);
+	struct router_result res = { .fragments = 0 };
+	struct route_cache_entry *cached
+		= router_get_cached_routes(bundle->destination);
+	struct node_table_entry *entry;
+	size_t first_route = 0;
+
+	if (cached != NULL) {
+		entry = cached->node_entry;
+	} else {
+		LOG("Router: Could not cache routes, looking them up directly");
+		entry = router_lookup_destination(bundle->destination);
+	}
 
-	res.fragments = 0;
-	if (contacts == NULL) {
+	if (entry == NULL) {
 		LOGF("Router: Could not determine a node over which the destination \"%s\" for bundle %p is reachable",
 		     bundle->destination, bundle);
 		return res;
@@ -285,7 +392,7 @@ struct router_result router_get_first_route(struct bundle *bundle)
 
 	const struct max_fragment_size_result mrfs =
 		router_get_max_reasonable_fragment_size(
-			contacts,
+			entry->contacts,
 			bundle_size,
 			MAX(first_frag_sz, last_frag_sz),
 			bundle->payload_block->length,
@@ -294,14 +401,14 @@ struct router_result router_get_first_route(struct bundle *bundle)
 		);
 
 	if (mrfs.max_fragment_size == 0) {
-		LOGF("Router: Contact payload capacity (%lu bytes) too low for bundle %p of size %lu bytes (min. frag. sz. = %lu, payload sz. = %lu)",
-		     mrfs.payload_capacity, bundle, bundle_size,
+		LOGF("Router: Contact payload capacity (%llu bytes) too low for bundle %p of size %lu bytes (min. frag. sz. = %lu, payload sz. = %lu)",
+		     (unsigned long long)mrfs.payload_capacity, bundle, bundle_size,
 		     MAX(first_frag_sz, last_frag_sz),
 		     bundle->payload_block->length);
-		goto finish;
-	} else if (mrfs.max_fragment_size != INT32_MAX) {
-		LOGF("Router: Determined max. frag size of %lu bytes for bundle %p of size %lu bytes (payload sz. = %lu)",
-		     mrfs.max_fragment_size, bundle, bundle_size,
+		return res;
+	} else if (mrfs.max_fragment_size != CONTACT_CAPACITY_INFINITE) {
+		LOGF("Router: Determined max. frag size of %llu bytes for bundle %p of size %lu bytes (payload sz. = %lu)",
+		     (unsigned long long)mrfs.max_fragment_size, bundle, bundle_size,
 		     bundle->payload_block->length);
 	} else {
 		LOGF("Router: Determined infinite max. frag size for bundle of size %lu bytes (payload sz. = %lu)",
@@ -311,18 +418,20 @@ struct router_result router_get_first_route(struct bundle *bundle)
 	if (bundle_must_not_fragment(bundle) ||
 			bundle_size <= mrfs.max_fragment_size)
 		router_get_first_route_nonfrag(&res,
-			contacts, bundle, bundle_size, expiration_time);
+			entry,
+			(cached != NULL
+			 ? &cached->first_route[ROUTER_BUNDLE_PRIORITY(bundle)]
+			 : &first_route),
+			bundle, bundle_size, expiration_time);
 	else
 		router_get_first_route_frag(&res,
-			contacts, bundle, bundle_size, expiration_time,
+			entry->contacts, bundle, bundle_size, expiration_time,
 			mrfs.max_fragment_size, first_frag_sz, last_frag_sz);
 
 	if (!res.fragments)
 		LOGF("Router: No feasible route found for bundle %p to \"%s\" with size of %lu bytes",
 		     bundle, bundle->destination, bundle_size);
 
-finish:
-	list_free(contacts);
 	return res;
 }
 
@@ -330,10 +439,11 @@ finish:
 struct router_result router_try_reuse(
 	struct router_result route, struct bundle *bundle)
 {
-	uint64_t time = hal_time_get_timestamp_s();
-	uint64_t expiration_time = bundle_get_expiration_time_s(bundle, time);
+	uint64_t time = hal_time_get_timestamp_ms();
+	uint64_t expiration_time = bundle_get_expiration_time_ms(bundle, time);
 	uint32_t remaining_pay = bundle->payload_block->length;
-	uint32_t size, min_cap;
+	uint32_t size;
+	int64_t min_cap;
 	struct fragment_route *fr;
 	int32_t f;
 
@@ -348,7 +458,7 @@ struct router_result router_try_reuse(
 		if (fr->contact->to <= time
 			|| fr->contact->to > expiration_time
 			|| ROUTER_CONTACT_CAPACITY(fr->contact, 0)
-				< (int32_t)size
+				< (int64_t)size
 		)
 			route.fragments = 0;
 		return route;
@@ -363,11 +473,11 @@ struct router_result router_try_reuse(
 		else
 			size = bundle_get_mid_fragment_min_size(bundle);
 		fr = &route.fragment_results[f];
-		min_cap = UINT32_MAX;
+		min_cap = INT64_MAX;
 		if (fr->contact->to <= time
 			|| fr->contact->to > expiration_time
 			|| ROUTER_CONTACT_CAPACITY(fr->contact, 0)
-				< (int32_t)(size + RC.fragment_min_payload)
+				< (int64_t)size + RC.fragment_min_payload
 		) {
 			route.fragments = 0;
 			return route;
@@ -375,7 +485,7 @@ struct router_result router_try_reuse(
 		min_cap = MIN(min_cap,
 			ROUTER_CONTACT_CAPACITY(fr->contact, 0)
 			- size);
-		fr->payload_size = MIN(remaining_pay, min_cap);
+		fr->payload_size = MIN((int64_t)remaining_pay, min_cap);
 		remaining_pay -= fr->payload_size;
 		if (remaining_pay == 0) {
 			route.fragments = f - 1;
@@ -391,7 +501,7 @@ struct router_result router_try_reuse(
 enum ud3tn_result router_add_bundle_to_contact(
 	struct contact *contact, struct bundle *b)
 {
-	struct routed_bundle_list *new_entry, **cur_entry;
+	struct routed_bundle_list *new_entry;
 
 	ASSERT(contact != NULL);
 	ASSERT(b != NULL);
@@ -400,22 +510,19 @@ enum ud3tn_result router_add_bundle_to_contact(
 	if (new_entry == NULL)
 		return UD3TN_FAIL;
 	new_entry->data = b;
-	new_entry->next = NULL;
-	cur_entry = &contact->contact_bundles;
-	/* Go to end of list (=> FIFO) */
-	while (*cur_entry != NULL) {
-		ASSERT((*cur_entry)->data != b);
-		cur_entry = &(*cur_entry)->next;
-	}
-	*cur_entry = new_entry;
-	contact->bundle_count++;
+	new_entry->scheduled_size = router_get_scheduled_size(
+		contact,
+		bundle_get_serialized_size(b)
+	);
+	new_entry->priority = bundle_get_routing_priority(b);
+	/* Append to the end of the sub-queue of its priority (=> FIFO) */
+	contact_append_bundle_entry(contact, new_entry);
 	// This contact is of infinite capacity, just return "OK".
-	if (contact->remaining_capacity_p0 == INT32_MAX)
+	if (contact->remaining_capacity_p0 == CONTACT_CAPACITY_INFINITE)
 		return UD3TN_OK;
 
-	const size_t bundle_size = bundle_get_serialized_size(b);
-	const enum bundle_routing_priority prio =
-		bundle_get_routing_priority(b);
+	const uint64_t bundle_size = new_entry->scheduled_size;
+	const enum bundle_routing_priority prio = new_entry->priority;
 
 	contact->remaining_capacity_p0 -= bundle_size;
 	if (prio > BUNDLE_RPRIO_LOW) {
@@ -429,37 +536,39 @@ enum ud3tn_result router_add_bundle_to_contact(
 enum ud3tn_result router_remove_bundle_from_contact(
 	struct contact *contact, struct bundle *bundle)
 {
-	struct routed_bundle_list **cur_entry, *tmp;
+	struct routed_bundle_list *entry;
 
 	ASSERT(contact != NULL);
-	cur_entry = &contact->contact_bundles;
-	/* Find bundle */
-	while (*cur_entry != NULL) {
-		ASSERT((*cur_entry)->data != NULL);
-		if ((*cur_entry)->data == bundle) {
-			tmp = *cur_entry;
-			*cur_entry = (*cur_entry)->next;
-			free(tmp);
-			contact->bundle_count--;
-			// This contact is of infinite capacity, do nothing.
-			if (contact->remaining_capacity_p0 == INT32_MAX)
-				continue;
+	entry = contact_find_bundle_entry(
+		contact,
+		bundle,
+		bundle_get_routing_priority(bundle)
+	);
+	if (entry == NULL)
+		return UD3TN_FAIL;
+	router_remove_bundle_entry_from_contact(contact, entry);
+	return UD3TN_OK;
+}
 
-			const size_t bundle_size =
-				bundle_get_serialized_size(bundle);
-			const enum bundle_routing_priority prio =
-				bundle_get_routing_priority(bundle);
-
-			contact->remaining_capacity_p0 += bundle_size;
-			if (prio > BUNDLE_RPRIO_LOW) {
-				contact->remaining_capacity_p1 += bundle_size;
-				if (prio != BUNDLE_RPRIO_NORMAL)
-					contact->remaining_capacity_p2
-						+= bundle_size;
-			}
-			return UD3TN_OK;
-		}
-		cur_entry = &(*cur_entry)->next;
+void router_remove_bundle_entry_from_contact(
+	struct contact *contact, struct routed_bundle_list *entry)
+{
+	const uint64_t bundle_size = entry->scheduled_size;
+	const enum bundle_routing_priority prio = entry->priority;
+
+	ASSERT(contact != NULL);
+	contact_remove_bundle_entry(contact, entry);
+	free(entry);
+	// This contact is of infinite capacity, do nothing.
+	if (contact->remaining_capacity_p0 == CONTACT_CAPACITY_INFINITE)
+		return;
+
+	// Contacts skipped by cached route lookups may be usable again.
+	capacity_generation++;
+	contact->remaining_capacity_p0 += bundle_size;
+	if (prio > BUNDLE_RPRIO_LOW) {
+		contact->remaining_capacity_p1 += bundle_size;
+		if (prio != BUNDLE_RPRIO_NORMAL)
+			contact->remaining_capacity_p2 += bundle_size;
 	}
-	return UD3TN_FAIL;
 }
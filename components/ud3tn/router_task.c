@@ -15,7 +15,24 @@
 
 // COMMAND HANDLING
 
-static bool process_router_command(
+static size_t add_nodes(
+	struct router_command *router_cmd,
+	struct rescheduling_handle rescheduler)
+{
+	size_t i, applied = 0;
+
+	for (i = 0; i < router_cmd->node_count; i++) {
+		if (routing_table_add_node(router_cmd->nodes[i], rescheduler))
+			applied++;
+	}
+	free(router_cmd->nodes);
+	if (applied != router_cmd->node_count)
+		LOGF("Router: %zu of %zu nodes could not be added",
+		     router_cmd->node_count - applied, router_cmd->node_count);
+	return applied;
+}
+
+static bool process_node_command(
 	struct router_command *router_cmd,
 	struct rescheduling_handle rescheduler)
 {
@@ -41,16 +58,42 @@ static bool process_router_command(
 	}
 }
 
+static bool process_router_command(
+	struct router_command *router_cmd,
+	struct rescheduling_handle rescheduler,
+	size_t *applied)
+{
+	bool success;
+
+	switch (router_cmd->type) {
+	case ROUTER_COMMAND_ADD_BULK:
+		*applied = add_nodes(router_cmd, rescheduler);
+		return *applied == router_cmd->node_count;
+	case ROUTER_COMMAND_MODIFY:
+		return routing_table_modify_contacts(
+			router_cmd->data,
+			rescheduler,
+			applied
+		);
+	default:
+		success = process_node_command(router_cmd, rescheduler);
+		*applied = success ? 1 : 0;
+		return success;
+	}
+}
+
 enum ud3tn_result router_process_command(
 	struct router_command *command,
-	struct rescheduling_handle rescheduler)
+	struct rescheduling_handle rescheduler,
+	size_t *applied_count)
 {
-	bool success = true;
-
-	success = process_router_command(
+	size_t applied = 0;
+	const bool success = process_router_command(
 		command,
-		rescheduler
+		rescheduler,
+		&applied
 	);
+
 	if (success) {
 		LOGF("Router: Command (T = %c) processed.",
 			command->type);
@@ -60,6 +103,8 @@ enum ud3tn_result router_process_command(
 	}
 	free(command);
 
+	if (applied_count != NULL)
+		*applied_count = applied;
 	return success ? UD3TN_OK : UD3TN_FAIL;
 }
 
@@ -226,3 +271,29 @@ enum router_result_status router_route_bundle(struct bundle *b)
 		return br_to_rrs(proc_result.status_or_fragments);
 	return ROUTER_RESULT_OK;
 }
+
+size_t router_route_bundle_list(
+	struct routed_bundle_list *bundles,
+	struct route_failure_handle failure_handler)
+{
+	size_t routed = 0;
+
+	while (bundles) {
+		struct routed_bundle_list *const next = bundles->next;
+		struct bundle *const b = bundles->data;
+		const enum router_result_status result = router_route_bundle(b);
+
+		if (result == ROUTER_RESULT_OK)
+			routed++;
+		else
+			failure_handler.route_failure_func(
+				b,
+				result,
+				failure_handler.route_failure_func_context
+			);
+		free(bundles);
+		bundles = next;
+	}
+
+	return routed;
+}
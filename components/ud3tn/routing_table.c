@@ -1,21 +1,33 @@
 // SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
 #include "ud3tn/bundle.h"
+#include "ud3tn/cgr.h"
 #include "ud3tn/common.h"
+#include "ud3tn/contact_timeline.h"
+#include "ud3tn/hashmap.h"
 #include "ud3tn/node.h"
 #include "ud3tn/router.h"
 #include "ud3tn/routing_table.h"
-#include "ud3tn/simplehtab.h"
+
+#include "cla/cla.h"
+
+#include "platform/hal_io.h"
 
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
 static struct node_list *node_list;
-static struct contact_list *contact_list;
+static struct contact_timeline contact_timeline;
 
-static struct htab_entrylist *htab_elem[NODE_HTAB_SLOT_COUNT];
-static struct htab eid_table;
+// Node EID -> entry in node_list, borrows the EID of the node as key
+static struct hashmap node_index;
+// All nodes with NODE_FLAG_INTERNET_ACCESS
+static struct node_list *hot_node_list;
+
+static struct hashmap eid_table;
 static uint8_t eid_table_initialized;
+// Incremented whenever the contacts reachable via any EID change
+static uint32_t generation;
 
 /* INIT */
 
@@ -23,9 +35,16 @@ enum ud3tn_result routing_table_init(void)
 {
 	if (eid_table_initialized != 0)
 		return UD3TN_OK;
+	if (hashmap_init(&node_index, NODE_HTAB_SLOT_COUNT, true) != UD3TN_OK)
+		return UD3TN_FAIL;
+	if (hashmap_init(&eid_table, NODE_HTAB_SLOT_COUNT, false) !=
+			UD3TN_OK) {
+		hashmap_free(&node_index);
+		return UD3TN_FAIL;
+	}
 	node_list = NULL;
-	contact_list = NULL;
-	htab_init(&eid_table, NODE_HTAB_SLOT_COUNT, htab_elem);
+	hot_node_list = NULL;
+	contact_timeline_init(&contact_timeline);
 	eid_table_initialized = 1;
 	return UD3TN_OK;
 }
@@ -33,47 +52,94 @@ enum ud3tn_result routing_table_init(void)
 void routing_table_free(void)
 {
 	struct node_list *next;
+	struct contact *contact;
 
-	while (contact_list != NULL)
-		routing_table_delete_contact(contact_list->data);
+	while ((contact = contact_timeline_first_start(&contact_timeline)))
+		routing_table_delete_contact(contact);
 	while (node_list != NULL) {
 		free_node(node_list->node);
 		next = node_list->next;
 		free(node_list);
 		node_list = next;
 	}
+	while (hot_node_list != NULL) {
+		next = hot_node_list->next;
+		free(hot_node_list);
+		hot_node_list = next;
+	}
+	hashmap_clear(&node_index);
+	router_clear_route_cache();
 }
 
-/* LOOKUP */
+/* NODE INDEX */
 
-static struct node_list **get_node_entry_ptr_by_eid(
+static struct node_list *get_node_entry_by_eid(
 	const char *eid)
 {
-	struct node_list **cur = &node_list;
-
 	if (eid == NULL)
 		return NULL;
-	/* Linear search for now */
-	while ((*cur) != NULL) {
-		if (strcmp((*cur)->node->eid, eid) == 0)
-			return cur;
-		cur = &((*cur)->next);
+	return hashmap_get(&node_index, eid);
+}
+
+static void add_hot_node(struct node *node)
+{
+	struct node_list *entry;
+
+	if (!HAS_FLAG(node->flags, NODE_FLAG_INTERNET_ACCESS))
+		return;
+	entry = malloc(sizeof(struct node_list));
+	if (entry == NULL)
+		return;
+	entry->node = node;
+	entry->prev = NULL;
+	entry->next = hot_node_list;
+	hot_node_list = entry;
+}
+
+static void remove_hot_node(struct node *node)
+{
+	struct node_list **cur = &hot_node_list, *tmp;
+
+	if (!HAS_FLAG(node->flags, NODE_FLAG_INTERNET_ACCESS))
+		return;
+	while (*cur != NULL) {
+		if ((*cur)->node == node) {
+			tmp = *cur;
+			*cur = tmp->next;
+			free(tmp);
+			return;
+		}
+		cur = &(*cur)->next;
 	}
-	return NULL;
 }
 
-static struct node_list *get_node_entry_by_eid(
-	const char *eid)
+static bool link_node_entry(struct node_list *entry)
 {
-	struct node_list **entry_ptr
-		= get_node_entry_ptr_by_eid(eid);
+	if (hashmap_add(&node_index, entry->node->eid, entry) != UD3TN_OK)
+		return false;
+	entry->prev = NULL;
+	entry->next = node_list;
+	if (node_list != NULL)
+		node_list->prev = entry;
+	node_list = entry;
+	add_hot_node(entry->node);
+	return true;
+}
 
-	if (entry_ptr == NULL)
-		return NULL;
+static void unlink_node_entry(struct node_list *entry)
+{
+	hashmap_remove(&node_index, entry->node->eid);
+	if (entry->prev != NULL)
+		entry->prev->next = entry->next;
 	else
-		return *entry_ptr;
+		node_list = entry->next;
+	if (entry->next != NULL)
+		entry->next->prev = entry->prev;
+	remove_hot_node(entry->node);
 }
 
+/* LOOKUP */
+
 struct node *routing_table_lookup_node(const char *eid)
 {
 	struct node_list *entry = get_node_entry_by_eid(eid);
@@ -86,22 +152,39 @@ struct node *routing_table_lookup_node(const char *eid)
 
 struct node_table_entry *routing_table_lookup_eid(const char *eid)
 {
-	return (struct node_table_entry *)htab_get(&eid_table, eid);
+	return hashmap_get(&eid_table, eid);
+}
+
+const struct cgr_route_list *routing_table_get_routes(
+	struct node_table_entry *entry)
+{
+	ASSERT(entry != NULL);
+	if (entry->routes == NULL)
+		entry->routes = cgr_route_list_create(entry->contacts);
+	return entry->routes;
+}
+
+static void invalidate_routes(struct node_table_entry *entry)
+{
+	cgr_route_list_free(entry->routes);
+	entry->routes = NULL;
+	generation++;
+}
+
+uint32_t routing_table_get_generation(void)
+{
+	return generation;
 }
 
 
 uint8_t routing_table_lookup_hot_node(
 	struct node **target, uint8_t max)
 {
-	struct node_list *cur = node_list;
+	struct node_list *cur = hot_node_list;
 	uint8_t c = 0;
 
-	while (cur != NULL) {
-		if (HAS_FLAG(cur->node->flags, NODE_FLAG_INTERNET_ACCESS)) {
-			target[c] = cur->node;
-			if (++c == max)
-				break;
-		}
+	while (cur != NULL && c < max) {
+		target[c++] = cur->node;
 		cur = cur->next;
 	}
 	return c;
@@ -111,9 +194,16 @@ uint8_t routing_table_lookup_hot_node(
 static void add_node_to_tables(struct node *node);
 static void remove_node_from_tables(struct node *node, bool drop_contacts,
 				  struct rescheduling_handle rescheduler);
+static void add_contact_to_tables(struct node *node, struct contact *c);
+static void remove_contact_from_tables(struct node *node, struct contact *c);
+static void remove_contacts_from_tables(
+	struct node *node, struct contact_list *contacts);
+static void resolve_node_cla(struct node *node);
 
 static void reschedule_bundles(
 	struct contact *contact, struct rescheduling_handle rescheduler);
+static void reschedule_excess_bundles(
+	struct contact *contact, struct rescheduling_handle rescheduler);
 
 static bool add_new_node(struct node *new_node)
 {
@@ -130,8 +220,11 @@ static bool add_new_node(struct node *new_node)
 		return false;
 	}
 	new_elem->node = new_node;
-	new_elem->next = node_list;
-	node_list = new_elem;
+	if (!link_node_entry(new_elem)) {
+		free(new_elem);
+		free_node(new_node);
+		return false;
+	}
 
 	add_node_to_tables(new_node);
 	return true;
@@ -177,24 +270,33 @@ bool routing_table_add_node(
 		cur_contact->data->node = cur_node;
 		cur_contact = cur_contact->next;
 	}
-	/* Process contacts with modified capacity */
+	/* Process merged contacts with modified capacity or endpoints */
 	while (cap_modified != NULL) {
-		/* Check for all nodes with modified bandwidth if now */
-		/* the remaining capacity for p0 is negative: */
+		/* Only if new node endpoints are reachable via all contacts, */
+		/* the whole node has to be re-added below. */
+		if (new_node->endpoints == NULL) {
+			remove_contact_from_tables(cur_node, cap_modified->data);
+			add_contact_to_tables(cur_node, cap_modified->data);
+		}
 		/* We assume that the new contact capacity */
 		/* has already been calculated */
-		/* TODO: This can be improved! */
-		if (cap_modified->data->remaining_capacity_p0 < 0) {
-			reschedule_bundles(
-				cap_modified->data,
-				rescheduler
-			);
-		}
+		reschedule_excess_bundles(cap_modified->data, rescheduler);
 		next = cap_modified->next;
 		free(cap_modified);
 		cap_modified = next;
 	}
-	add_node_to_tables(cur_node);
+	if (new_node->endpoints != NULL) {
+		add_node_to_tables(cur_node);
+	} else {
+		/* Contacts not in the timeline yet have just been added */
+		resolve_node_cla(cur_node);
+		for (cur_contact = cur_node->contacts; cur_contact != NULL;
+		     cur_contact = cur_contact->next) {
+			if (!contact_timeline_contains(cur_contact->data))
+				add_contact_to_tables(cur_node,
+						      cur_contact->data);
+		}
+	}
 	free(new_node->eid);
 	free(new_node);
 	return true;
@@ -217,8 +319,14 @@ bool routing_table_replace_node(
 
 	remove_node_from_tables(entry->node, true,
 				rescheduler);
+	remove_hot_node(entry->node);
+	// The index borrows the EID of the node which is about to be freed.
+	hashmap_remove(&node_index, entry->node->eid);
 	free_node(entry->node);
 	entry->node = node;
+	if (hashmap_add(&node_index, node->eid, entry) != UD3TN_OK)
+		LOGF("RoutingTable: Could not re-index node \"%s\"", node->eid);
+	add_hot_node(node);
 	add_node_to_tables(node);
 	return true;
 }
@@ -226,14 +334,13 @@ bool routing_table_replace_node(
 bool routing_table_delete_node_by_eid(
 	char *eid, struct rescheduling_handle rescheduler)
 {
-	struct node_list **entry_ptr, *old_node_entry;
+	struct node_list *old_node_entry;
 
 	ASSERT(eid != NULL);
-	entry_ptr = get_node_entry_ptr_by_eid(eid);
-	if (entry_ptr != NULL) {
+	old_node_entry = get_node_entry_by_eid(eid);
+	if (old_node_entry != NULL) {
 		/* Delete whole node */
-		old_node_entry = *entry_ptr;
-		*entry_ptr = old_node_entry->next;
+		unlink_node_entry(old_node_entry);
 		remove_node_from_tables(old_node_entry->node, true,
 					rescheduler);
 		free_node(old_node_entry->node);
@@ -246,7 +353,7 @@ bool routing_table_delete_node_by_eid(
 bool routing_table_delete_node(
 	struct node *new_node, struct rescheduling_handle rescheduler)
 {
-	struct node_list **entry_ptr, *old_node_entry;
+	struct node_list *old_node_entry;
 	struct node *cur_node;
 	struct contact_list *modified = NULL, *deleted = NULL, *next, *tmp;
 
@@ -255,13 +362,12 @@ bool routing_table_delete_node(
 		return false;
 	}
 
-	entry_ptr = get_node_entry_ptr_by_eid(new_node->eid);
-	if (entry_ptr != NULL) {
-		cur_node = (*entry_ptr)->node;
+	old_node_entry = get_node_entry_by_eid(new_node->eid);
+	if (old_node_entry != NULL) {
+		cur_node = old_node_entry->node;
 		if (new_node->endpoints == NULL && new_node->contacts == NULL) {
 			/* Delete whole node */
-			old_node_entry = *entry_ptr;
-			*entry_ptr = old_node_entry->next;
+			unlink_node_entry(old_node_entry);
 			remove_node_from_tables(old_node_entry->node, true,
 						rescheduler);
 			free_node(old_node_entry->node);
@@ -269,7 +375,16 @@ bool routing_table_delete_node(
 			free_node(new_node);
 		} else {
 			/* Delete contacts/nodes */
-			remove_node_from_tables(cur_node, false, rescheduler);
+			const bool only_contacts = new_node->endpoints == NULL;
+
+			/* Without node endpoints to be deleted, only the */
+			/* given contacts have to be removed from the tables */
+			if (only_contacts)
+				remove_contacts_from_tables(cur_node,
+							    new_node->contacts);
+			else
+				remove_node_from_tables(cur_node, false,
+							rescheduler);
 			cur_node->endpoints = endpoint_list_difference(
 				cur_node->endpoints, new_node->endpoints, 1);
 			cur_node->contacts = contact_list_difference(
@@ -279,6 +394,9 @@ bool routing_table_delete_node(
 			while (modified != NULL) {
 				reschedule_bundles(
 					modified->data, rescheduler);
+				if (only_contacts)
+					add_contact_to_tables(cur_node,
+							      modified->data);
 				next = modified->next;
 				free(modified);
 				modified = next;
@@ -295,7 +413,8 @@ bool routing_table_delete_node(
 					deleted = contact_list_free(deleted);
 				}
 			}
-			add_node_to_tables(cur_node);
+			if (!only_contacts)
+				add_node_to_tables(cur_node);
 			free(new_node->eid);
 			free(new_node);
 		}
@@ -305,33 +424,153 @@ bool routing_table_delete_node(
 	return false;
 }
 
+// Returns the only contact of the node overlapping with the given one.
+static struct contact *find_overlapping_contact(
+	struct node *node, const struct contact *c)
+{
+	struct contact_list *cur;
+	struct contact *result = NULL;
+
+	for (cur = node->contacts; cur != NULL; cur = cur->next) {
+		// The list is sorted by the start of the contacts.
+		if (cur->data->from >= c->to)
+			break;
+		if (cur->data->to <= c->from)
+			continue;
+		if (result != NULL)
+			return NULL;
+		result = cur->data;
+	}
+	return result;
+}
+
+bool routing_table_modify_contacts(
+	struct node *node, struct rescheduling_handle rescheduler,
+	size_t *modified)
+{
+	struct node_list *entry;
+	struct contact_list *cur;
+	struct contact *c;
+	bool success = true;
+
+	*modified = 0;
+	if (!node_prepare_and_verify(node)) {
+		free_node(node);
+		return false;
+	}
+
+	entry = get_node_entry_by_eid(node->eid);
+	if (entry == NULL) {
+		free_node(node);
+		return false;
+	}
+
+	for (cur = node->contacts; cur != NULL; cur = cur->next) {
+		c = find_overlapping_contact(entry->node, cur->data);
+		if (c == NULL) {
+			LOGF("RoutingTable: Not exactly one contact with \"%s\" overlaps [%llu, %llu], not modifying it",
+			     node->eid, (unsigned long long)cur->data->from,
+			     (unsigned long long)cur->data->to);
+			success = false;
+			continue;
+		}
+		// Re-insert it as its position in all lists may change.
+		remove_contact_from_tables(entry->node, c);
+		remove_contact_from_list(&entry->node->contacts, c);
+		c->from = cur->data->from;
+		c->to = cur->data->to;
+		c->bitrate = cur->data->bitrate;
+		add_contact_to_ordered_list(&entry->node->contacts, c, 1);
+		add_contact_to_tables(entry->node, c);
+		// Only bundles exceeding a reduced capacity have to be re-routed.
+		reschedule_excess_bundles(c, rescheduler);
+		(*modified)++;
+	}
+	free_node(node);
+	return success;
+}
+
 static bool add_contact_to_node_in_htab(char *eid, struct contact *c);
 static bool remove_contact_from_node_in_htab(char *eid, struct contact *c);
 
+static void resolve_node_cla(struct node *node)
+{
+	node->cla_config = NULL;
+	node->cla_mbs = 0;
+	if (node->cla_addr == NULL || node->cla_addr[0] == '\0')
+		return;
+	node->cla_config = cla_config_get(node->cla_addr);
+	if (node->cla_config != NULL)
+		node->cla_mbs = node->cla_config->vtable->cla_mbs_get(
+			node->cla_config
+		);
+}
+
+static void add_contact_to_tables(struct node *node, struct contact *c)
+{
+	struct endpoint_list *cur_persistent_node, *cur_contact_node;
+
+	add_contact_to_node_in_htab(node->eid, c);
+	cur_persistent_node = node->endpoints;
+	while (cur_persistent_node != NULL) {
+		add_contact_to_node_in_htab(cur_persistent_node->eid, c);
+		cur_persistent_node = cur_persistent_node->next;
+	}
+	cur_contact_node = c->contact_endpoints;
+	while (cur_contact_node != NULL) {
+		add_contact_to_node_in_htab(cur_contact_node->eid, c);
+		cur_contact_node = cur_contact_node->next;
+	}
+	contact_timeline_insert(&contact_timeline, c);
+	recalculate_contact_capacity(c);
+}
+
+static void remove_contact_from_tables(struct node *node, struct contact *c)
+{
+	struct endpoint_list *cur_persistent_node, *cur_contact_node;
+
+	remove_contact_from_node_in_htab(node->eid, c);
+	cur_persistent_node = node->endpoints;
+	while (cur_persistent_node != NULL) {
+		remove_contact_from_node_in_htab(
+			cur_persistent_node->eid, c);
+		cur_persistent_node = cur_persistent_node->next;
+	}
+	cur_contact_node = c->contact_endpoints;
+	while (cur_contact_node != NULL) {
+		remove_contact_from_node_in_htab(cur_contact_node->eid, c);
+		cur_contact_node = cur_contact_node->next;
+	}
+	contact_timeline_remove(&contact_timeline, c);
+}
+
+// Removes the contacts of the node matching the given ones (by start and end
+// time) from the tables, both lists have to be sorted by the contact start.
+static void remove_contacts_from_tables(
+	struct node *node, struct contact_list *contacts)
+{
+	struct contact_list *cur = node->contacts, *l;
+
+	for (; contacts != NULL; contacts = contacts->next) {
+		while (cur != NULL && cur->data->from < contacts->data->from)
+			cur = cur->next;
+		for (l = cur; l != NULL && l->data->from ==
+		     contacts->data->from; l = l->next) {
+			if (l->data->to == contacts->data->to)
+				remove_contact_from_tables(node, l->data);
+		}
+	}
+}
+
 static void add_node_to_tables(struct node *node)
 {
 	struct contact_list *cur_contact;
-	struct endpoint_list *cur_persistent_node, *cur_contact_node;
 
 	ASSERT(node != NULL);
+	resolve_node_cla(node);
 	cur_contact = node->contacts;
 	while (cur_contact != NULL) {
-		add_contact_to_node_in_htab(node->eid, cur_contact->data);
-		cur_persistent_node = node->endpoints;
-		while (cur_persistent_node != NULL) {
-			add_contact_to_node_in_htab(
-				cur_persistent_node->eid, cur_contact->data);
-			cur_persistent_node = cur_persistent_node->next;
-		}
-		cur_contact_node = cur_contact->data->contact_endpoints;
-		while (cur_contact_node != NULL) {
-			add_contact_to_node_in_htab(
-				cur_contact_node->eid, cur_contact->data);
-			cur_contact_node = cur_contact_node->next;
-		}
-		add_contact_to_ordered_list(
-			&contact_list, cur_contact->data, 1);
-		recalculate_contact_capacity(cur_contact->data);
+		add_contact_to_tables(node, cur_contact->data);
 		cur_contact = cur_contact->next;
 	}
 }
@@ -340,27 +579,13 @@ static void remove_node_from_tables(struct node *node, bool drop_contacts,
 				    struct rescheduling_handle rescheduler)
 {
 	struct contact_list **cur_slot;
-	struct endpoint_list *cur_persistent_node, *cur_contact_node;
 
 	ASSERT(node != NULL);
 	cur_slot = &node->contacts;
 	while (*cur_slot != NULL) {
 		struct contact_list *const cur_contact = *cur_slot;
 
-		remove_contact_from_node_in_htab(node->eid, cur_contact->data);
-		cur_persistent_node = node->endpoints;
-		while (cur_persistent_node != NULL) {
-			remove_contact_from_node_in_htab(
-				cur_persistent_node->eid, cur_contact->data);
-			cur_persistent_node = cur_persistent_node->next;
-		}
-		cur_contact_node = cur_contact->data->contact_endpoints;
-		while (cur_contact_node != NULL) {
-			remove_contact_from_node_in_htab(
-				cur_contact_node->eid, cur_contact->data);
-			cur_contact_node = cur_contact_node->next;
-		}
-		remove_contact_from_list(&contact_list, cur_contact->data);
+		remove_contact_from_tables(node, cur_contact->data);
 		if (drop_contacts) {
 			reschedule_bundles(cur_contact->data,
 					   rescheduler);
@@ -385,15 +610,21 @@ static bool add_contact_to_node_in_htab(char *eid, struct contact *c)
 
 	ASSERT(eid != NULL);
 	ASSERT(c != NULL);
-	entry = (struct node_table_entry *)htab_get(&eid_table, eid);
+	entry = hashmap_get(&eid_table, eid);
 	if (entry == NULL) {
 		entry = malloc(sizeof(struct node_table_entry));
 		if (entry == NULL)
 			return false;
 		entry->ref_count = 0;
 		entry->contacts = NULL;
-		htab_add(&eid_table, eid, entry);
+		entry->routes = NULL;
+		if (hashmap_add(&eid_table, eid, entry) != UD3TN_OK) {
+			free(entry);
+			return false;
+		}
 	}
+	// Also invalidate if the contact is known, it may have been modified.
+	invalidate_routes(entry);
 	if (add_contact_to_ordered_list(&(entry->contacts), c, 0)) {
 		entry->ref_count++;
 		return true;
@@ -407,13 +638,14 @@ static bool remove_contact_from_node_in_htab(char *eid, struct contact *c)
 
 	ASSERT(eid != NULL);
 	ASSERT(c != NULL);
-	entry = (struct node_table_entry *)htab_get(&eid_table, eid);
+	entry = hashmap_get(&eid_table, eid);
 	if (entry == NULL)
 		return false;
 	if (remove_contact_from_list(&(entry->contacts), c)) {
+		invalidate_routes(entry);
 		entry->ref_count--;
 		if (entry->ref_count <= 0) {
-			htab_remove(&eid_table, eid);
+			hashmap_remove(&eid_table, eid);
 			free(entry);
 		}
 		return true;
@@ -422,9 +654,9 @@ static bool remove_contact_from_node_in_htab(char *eid, struct contact *c)
 }
 
 /* CONTACT LIST */
-struct contact_list **routing_table_get_raw_contact_list_ptr(void)
+struct contact_timeline *routing_table_get_contact_timeline(void)
 {
-	return &contact_list;
+	return &contact_timeline;
 }
 
 struct node_list *routing_table_get_node_list(void)
@@ -460,8 +692,8 @@ void routing_table_delete_contact(struct contact *contact)
 		cur_eid = endpoint_list_free(cur_eid);
 	}
 	contact->contact_endpoints = NULL;
-	/* Remove from global list */
-	remove_contact_from_list(&contact_list, contact);
+	/* Remove from timeline */
+	contact_timeline_remove(&contact_timeline, contact);
 	/* Free contact itself */
 	free_contact(contact);
 }
@@ -469,18 +701,19 @@ void routing_table_delete_contact(struct contact *contact)
 void routing_table_contact_passed(
 	struct contact *contact, struct rescheduling_handle rescheduler)
 {
-	struct routed_bundle_list *tmp;
+	struct routed_bundle_list *cur, *next;
 
 	if (contact->node != NULL) {
-		while (contact->contact_bundles != NULL) {
+		cur = contact_take_bundles(contact);
+		while (cur != NULL) {
 			rescheduler.reschedule_func(
-				contact->contact_bundles->data,
+				cur->data,
 				rescheduler.reschedule_func_context
 			);
-			tmp = contact->contact_bundles->next;
-			free(contact->contact_bundles->data);
-			free(contact->contact_bundles);
-			contact->contact_bundles = tmp;
+			next = cur->next;
+			free(cur->data);
+			free(cur);
+			cur = next;
 		}
 	}
 	routing_table_delete_contact(contact);
@@ -497,9 +730,37 @@ static void reschedule_bundles(
 	/* Empty the bundle list and queue them in for re-scheduling */
 	while (contact->contact_bundles != NULL) {
 		b = contact->contact_bundles->data;
-		router_remove_bundle_from_contact(contact, b);
+		router_remove_bundle_entry_from_contact(
+			contact,
+			contact->contact_bundles
+		);
+		rescheduler.reschedule_func(
+			b,
+			rescheduler.reschedule_func_context
+		);
+	}
+}
+
+// Re-routes bundles until the contact is no longer over-booked, starting with
+// the most recently scheduled bundles of the lowest priority.
+static void reschedule_excess_bundles(
+	struct contact *contact, struct rescheduling_handle rescheduler)
+{
+	struct routed_bundle_list *entry;
+	struct bundle *b;
+	int prio = BUNDLE_RPRIO_LOW;
+
+	ASSERT(contact != NULL);
+	while (contact->remaining_capacity_p0 < 0 && prio < BUNDLE_RPRIO_MAX) {
+		entry = contact->contact_bundles_tail[prio];
+		if (entry == NULL) {
+			prio++;
+			continue;
+		}
+		b = entry->data;
+		router_remove_bundle_entry_from_contact(contact, entry);
 		rescheduler.reschedule_func(
-			contact->contact_bundles->data,
+			b,
 			rescheduler.reschedule_func_context
 		);
 	}
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#ifndef CONTACTPLANPARSER_H_INCLUDED
+#define CONTACTPLANPARSER_H_INCLUDED
+
+#include "ud3tn/router.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Decoder for contact plans in the binary bulk format, a CBOR array of nodes
+ * as described in doc/contacts_data_format.md. The whole plan is decoded
+ * into a single ROUTER_COMMAND_ADD_BULK command, so that it is applied to
+ * the routing table at once.
+ */
+
+/**
+ * @brief Checks whether the data starts like a plan in the bulk format
+ *
+ * Commands in the text format start with an ASCII digit, plans in the bulk
+ * format with the header of a CBOR array.
+ */
+bool contact_plan_is_bulk(const uint8_t *buffer, size_t length);
+
+/**
+ * @brief Decodes a complete plan in the bulk format
+ *
+ * @return A ROUTER_COMMAND_ADD_BULK command containing all nodes of the plan,
+ *         or NULL if the plan is invalid or memory could not be allocated
+ */
+struct router_command *contact_plan_parse(
+	const uint8_t *buffer, size_t length);
+
+#endif /* CONTACTPLANPARSER_H_INCLUDED */
@@ -14,6 +14,7 @@ struct bibe_header {
 	uint8_t *data;
 };
 
+// The encapsulated bundle in the BPDU points into the provided buffer.
 size_t bibe_parser_parse(const uint8_t *buffer, size_t length,
 			 struct bibe_protocol_data_unit *bpdu);
 
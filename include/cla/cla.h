@@ -25,6 +25,17 @@ struct cla_config {
 	const struct bundle_agent_interface *bundle_agent_interface;
 };
 
+// Fill level of a TX queue, protected by the semaphore of the queue
+struct cla_tx_backlog {
+	// Serialized size of the bundles handed over but not sent yet
+	size_t queued_bytes;
+	// Set on reaching the high watermark, until the low watermark is hit
+	bool congested;
+	// Average size of the sent bundles on the wire per 1000 bytes of
+	// serialized data, lower than 1000 if the CLA compresses them
+	uint16_t wire_size_permille;
+};
+
 struct cla_link {
 	struct cla_config *config;
 
@@ -51,11 +62,25 @@ struct cla_link {
 	QueueIdentifier_t tx_queue_handle;
 	// Semaphore blocking the TX queue while bundles are being added
 	Semaphore_t tx_queue_sem;
+	// Amount of data in the TX queue and the local TX task backlog
+	struct cla_tx_backlog tx_backlog;
+	// Set by the CLA in cla_end_packet if the packet occupied a different
+	// amount of bytes on the wire, e.g., because it was compressed
+	size_t tx_packet_wire_size;
+	// Set by the CLA if it dropped the packet instead of sending it, e.g.,
+	// because it exceeded a limit of the peer - the bundle is rescheduled
+	bool tx_packet_failed;
+	// Set by CLAs buffering packets (see cla_flush) when handing them over
+	// to the lower layer: the number of the oldest buffered packets which
+	// were sent, followed by the number of packets which were dropped
+	size_t tx_flushed_sent;
+	size_t tx_flushed_dropped;
 };
 
 struct cla_tx_queue {
 	QueueIdentifier_t tx_queue_handle;
 	Semaphore_t tx_queue_sem;
+	struct cla_tx_backlog *tx_backlog;
 };
 
 /*
@@ -130,6 +155,8 @@ struct cla_vtable {
 	void (*cla_send_packet_data)(struct cla_link *,
 				     const void *,
 				     const size_t);
+	/* Optional: Sends out packets the CLA buffered, see tx_flushed_sent */
+	void (*cla_flush)(struct cla_link *);
 
 	// RX Task API
 
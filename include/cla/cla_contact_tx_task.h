@@ -9,6 +9,8 @@
 
 #include "platform/hal_queue.h"
 
+#include <stdint.h>
+
 enum cla_contact_tx_task_command_type {
 	TX_COMMAND_UNDEFINED, /* 0x00 */
 	TX_COMMAND_BUNDLES,   /* 0x01 */
@@ -19,10 +21,24 @@ struct cla_contact_tx_task_command {
 	enum cla_contact_tx_task_command_type type;
 	struct routed_bundle_list *bundles;
 	char *cla_address;
+	// Bitrate of the contact in bytes per second, 0 = not limited
+	uint64_t bitrate;
 };
 
 enum ud3tn_result cla_launch_contact_tx_task(struct cla_link *link);
 
 void cla_contact_tx_task_request_exit(QueueIdentifier_t queue);
 
+/**
+ * Removes bundles which left a TX queue from its backlog. If the queue was
+ * congested and drops below CONTACT_TX_QUEUE_LOW_WATERMARK, the contact
+ * manager is woken up via the BP to hand over further bundles. The amount
+ * of bytes the bundles occupied on the wire updates the size estimation
+ * used by the router.
+ */
+void cla_tx_backlog_release(struct cla_link *link,
+			    struct cla_tx_backlog *backlog,
+			    Semaphore_t tx_queue_sem, size_t bytes,
+			    size_t wire_bytes);
+
 #endif /* CLA_CONTACT_TX_TASK_H_INCLUDED */
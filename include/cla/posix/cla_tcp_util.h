@@ -4,6 +4,7 @@
 
 #include <netinet/in.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -55,6 +56,18 @@ int cla_tcp_connect_to_cla_addr(const char *const cla_addr,
 ssize_t tcp_send_all(const int socket, const void *const buffer,
 		     const size_t length);
 
+/**
+ * Send all data referenced by an I/O vector to the given socket with as few
+ * system calls as possible, ignoring interruptions by signals.
+ *
+ * @param socket The socket to be written to.
+ * @param iov The I/O vector, which is modified to track the progress.
+ * @param iovcnt The number of elements in the I/O vector.
+ * @return The return value is compatible to sendmsg(2).
+ *         errno might be set accordingly.
+ */
+ssize_t tcp_send_all_iov(const int socket, struct iovec *iov, int iovcnt);
+
 /**
  * Receive all data from the given socket, ignoring interruptions by signals.
  *
@@ -66,4 +79,16 @@ ssize_t tcp_send_all(const int socket, const void *const buffer,
  */
 ssize_t tcp_recv_all(const int socket, void *const buffer, const size_t length);
 
+/**
+ * Enable TCP keepalive probes to detect broken connections while idle.
+ *
+ * @param socket The connected TCP socket.
+ * @param idle_s The time in seconds after which the first probe is sent.
+ * @param interval_s The time in seconds between two probes.
+ * @param count The number of unanswered probes until the connection is reset.
+ * @return 0 on success, -1 on error (errno is set accordingly).
+ */
+int tcp_enable_keepalive(const int socket, const int idle_s,
+			 const int interval_s, const int count);
+
 #endif // CLA_TCP_UTIL_H_INCLUDED
@@ -19,6 +19,13 @@ enum tcpclv3_flags {
 	TCPCLV3_FLAG_S = 0x02,
 };
 
+enum tcpclv3_contact_flags {
+	TCPCLV3_CONTACT_FLAG_NONE        = 0x00,
+	// Not assigned by RFC 7242: After the contact header exchange, the
+	// session is compressed as a zlib stream in both directions.
+	TCPCLV3_CONTACT_FLAG_COMPRESSION = 0x80,
+};
+
 enum tcpclv3_parser_stage {
 	TCPCLV3_EXPECT_TYPE_FLAGS,
 	TCPCLV3_GET_SIZE,
@@ -39,7 +46,8 @@ struct tcpclv3_parser {
 // HANDSHAKE
 
 char *cla_tcpclv3_generate_contact_header(
-	const char *const local_eid, size_t *len);
+	const char *const local_eid, enum tcpclv3_contact_flags flags,
+	size_t *len);
 
 // SERIALIZER
 
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#ifndef CLA_TCPCLV4PROTO_H_INCLUDED
+#define CLA_TCPCLV4PROTO_H_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+
+// RFC 9174, section 4.2: "dtn!" magic, version, flags
+#define TCPCLV4_CONTACT_HEADER_SIZE 6
+#define TCPCLV4_VERSION 0x04
+
+// Message type code, flags, transfer ID, extension items length, data length
+#define TCPCLV4_MAX_SEGMENT_HEADER_SIZE (1 + 1 + 8 + 4 + 8)
+// Transfer Length extension item (flags, type, length, value)
+#define TCPCLV4_TRANSFER_LENGTH_ITEM_SIZE (1 + 2 + 2 + 8)
+// Message type code, flags, transfer ID, acknowledged length
+#define TCPCLV4_XFER_ACK_SIZE (1 + 1 + 8 + 8)
+// Message type code, reason code, transfer ID
+#define TCPCLV4_XFER_REFUSE_SIZE (1 + 1 + 8)
+// Message type code, flags, reason code
+#define TCPCLV4_SESS_TERM_SIZE (1 + 1 + 1)
+// Message type code, reason code, rejected message header
+#define TCPCLV4_MSG_REJECT_SIZE (1 + 1 + 1)
+// Message type code, keepalive, segment MRU, transfer MRU, node ID length
+#define TCPCLV4_SESS_INIT_FIXED_SIZE (1 + 2 + 8 + 8 + 2)
+
+enum tcpclv4_contact_flags {
+	TCPCLV4_CONTACT_FLAG_CAN_TLS = 0x01,
+};
+
+enum tcpclv4_message_type {
+	TCPCLV4_TYPE_XFER_SEGMENT = 0x01,
+	TCPCLV4_TYPE_XFER_ACK     = 0x02,
+	TCPCLV4_TYPE_XFER_REFUSE  = 0x03,
+	TCPCLV4_TYPE_KEEPALIVE    = 0x04,
+	TCPCLV4_TYPE_SESS_TERM    = 0x05,
+	TCPCLV4_TYPE_MSG_REJECT   = 0x06,
+	TCPCLV4_TYPE_SESS_INIT    = 0x07,
+};
+
+enum tcpclv4_segment_flags {
+	TCPCLV4_SEGMENT_FLAG_END   = 0x01,
+	TCPCLV4_SEGMENT_FLAG_START = 0x02,
+};
+
+enum tcpclv4_extension_flags {
+	TCPCLV4_EXTENSION_FLAG_CRITICAL = 0x01,
+};
+
+enum tcpclv4_transfer_extension_type {
+	TCPCLV4_TRANSFER_EXTENSION_LENGTH = 0x0001,
+};
+
+enum tcpclv4_refuse_reason {
+	TCPCLV4_REFUSE_UNKNOWN        = 0x00,
+	TCPCLV4_REFUSE_COMPLETED      = 0x01,
+	TCPCLV4_REFUSE_NO_RESOURCES   = 0x02,
+	TCPCLV4_REFUSE_RETRANSMIT     = 0x03,
+	TCPCLV4_REFUSE_NOT_ACCEPTABLE = 0x04,
+	TCPCLV4_REFUSE_EXTENSION_FAIL = 0x05,
+	TCPCLV4_REFUSE_SESSION_TERM   = 0x06,
+};
+
+enum tcpclv4_sess_term_flags {
+	TCPCLV4_SESS_TERM_FLAG_REPLY = 0x01,
+};
+
+enum tcpclv4_sess_term_reason {
+	TCPCLV4_TERM_UNKNOWN          = 0x00,
+	TCPCLV4_TERM_IDLE_TIMEOUT     = 0x01,
+	TCPCLV4_TERM_VERSION_MISMATCH = 0x02,
+	TCPCLV4_TERM_BUSY             = 0x03,
+	TCPCLV4_TERM_CONTACT_FAILURE  = 0x04,
+	TCPCLV4_TERM_RESOURCE_EXHAUST = 0x05,
+};
+
+enum tcpclv4_msg_reject_reason {
+	TCPCLV4_REJECT_TYPE_UNKNOWN = 0x01,
+	TCPCLV4_REJECT_UNSUPPORTED  = 0x02,
+	TCPCLV4_REJECT_UNEXPECTED   = 0x03,
+};
+
+// INTEGER CODING
+
+void tcpclv4_write_u16(uint8_t *buffer, uint16_t value);
+void tcpclv4_write_u32(uint8_t *buffer, uint32_t value);
+void tcpclv4_write_u64(uint8_t *buffer, uint64_t value);
+uint16_t tcpclv4_read_u16(const uint8_t *buffer);
+uint32_t tcpclv4_read_u32(const uint8_t *buffer);
+uint64_t tcpclv4_read_u64(const uint8_t *buffer);
+
+// HANDSHAKE
+
+void tcpclv4_generate_contact_header(uint8_t *buffer);
+
+uint8_t *tcpclv4_generate_sess_init(
+	const char *const local_node_id, uint16_t keepalive_interval,
+	uint64_t segment_mru, uint64_t transfer_mru, size_t *len);
+
+// SERIALIZER
+
+/**
+ * Writes the XFER_SEGMENT header ending immediately before the given data
+ * pointer, so that header and data can be sent in a single call.
+ * If the START flag is set, a Transfer Length extension item announcing the
+ * total transfer length is included, allowing an early refusal by the peer.
+ *
+ * @return The size of the header, which starts at `data_start - size`.
+ *         The caller has to provide at least TCPCLV4_MAX_SEGMENT_HEADER_SIZE
+ *         plus TCPCLV4_TRANSFER_LENGTH_ITEM_SIZE bytes of headroom.
+ */
+size_t tcpclv4_prepend_segment_header(
+	uint8_t *data_start, uint8_t flags, uint64_t transfer_id,
+	uint64_t transfer_length, uint64_t data_length);
+
+void tcpclv4_generate_xfer_ack(uint8_t *buffer, uint8_t flags,
+			       uint64_t transfer_id, uint64_t ack_length);
+
+void tcpclv4_generate_xfer_refuse(uint8_t *buffer, uint8_t reason,
+				  uint64_t transfer_id);
+
+void tcpclv4_generate_sess_term(uint8_t *buffer, uint8_t flags,
+				uint8_t reason);
+
+void tcpclv4_generate_msg_reject(uint8_t *buffer, uint8_t reason,
+				 uint8_t rejected_header);
+
+// EXTENSION ITEMS
+
+/**
+ * Iterates over the given transfer extension items and extracts the value of
+ * the Transfer Length item, if present.
+ *
+ * @return 0 on success, -1 if the items are malformed or an unknown item is
+ *         flagged as critical.
+ */
+int tcpclv4_parse_transfer_extensions(
+	const uint8_t *items, size_t length, uint64_t *transfer_length);
+
+#endif // CLA_TCPCLV4PROTO_H_INCLUDED
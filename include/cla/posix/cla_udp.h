@@ -0,0 +1,15 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#ifndef CLA_UDP_H_INCLUDED
+#define CLA_UDP_H_INCLUDED
+
+#include "cla/cla.h"
+
+#include "ud3tn/bundle_processor.h"
+
+#include <stddef.h>
+
+struct cla_config *udp_create(
+	const char *const options[], const size_t option_count,
+	const struct bundle_agent_interface *bundle_agent_interface);
+
+#endif /* CLA_UDP_H_INCLUDED */
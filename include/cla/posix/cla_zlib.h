@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#ifndef CLA_ZLIB_H_INCLUDED
+#define CLA_ZLIB_H_INCLUDED
+
+#include "ud3tn/result.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Opaque wrapper around a zlib stream, so that CLAs do not have to include
+// zlib.h, which conflicts with our own crc32().
+struct cla_zlib_stream;
+
+/**
+ * Checks whether uD3TN has been built with zlib support (zlib=yes).
+ */
+bool cla_zlib_available(void);
+
+/**
+ * Creates a new stream for compressing or decompressing data.
+ *
+ * @param compress Whether to create a compressor or a decompressor.
+ * @param level The zlib compression level, ignored for decompressors.
+ * @return The new stream or NULL on error or if zlib is not available.
+ */
+struct cla_zlib_stream *cla_zlib_create(bool compress, int level);
+
+/**
+ * Frees all resources associated with a stream, accepts NULL.
+ */
+void cla_zlib_free(struct cla_zlib_stream *stream);
+
+/**
+ * (De)compresses as much data as possible from the input into the output
+ * buffer. The pointers and lengths are advanced by the consumed input and the
+ * produced output.
+ *
+ * @param stream The stream.
+ * @param in Pointer to the input data, may be NULL if in_length is zero.
+ * @param in_length Length of the input data.
+ * @param out Pointer to the output buffer.
+ * @param out_length Space left in the output buffer.
+ * @param flush Compressors only: Produce all output for the given input, so
+ *              that the peer can decompress everything sent so far.
+ * @return UD3TN_FAIL if the stream is corrupted, UD3TN_OK otherwise.
+ */
+enum ud3tn_result cla_zlib_process(struct cla_zlib_stream *stream,
+				   const uint8_t **in, size_t *in_length,
+				   uint8_t **out, size_t *out_length,
+				   bool flush);
+
+/**
+ * Returns the total amount of bytes produced by the stream.
+ */
+uint64_t cla_zlib_total_out(const struct cla_zlib_stream *stream);
+
+/**
+ * Returns a human-readable description of the last error of the stream.
+ */
+const char *cla_zlib_error(const struct cla_zlib_stream *stream);
+
+#endif // CLA_ZLIB_H_INCLUDED
@@ -91,6 +91,24 @@ enum ud3tn_result hal_queue_receive(QueueIdentifier_t queue,
 				    void *targetBuffer,
 				    int timeout);
 
+/**
+ * @brief hal_queue_receive_until Receive a item from the specific queue,
+ *				  waiting at most until the given point in time
+ *				  Has blocking behaviour!
+ * @param queue The identifier of the Queue that the element should be read
+ *		from
+ * @param targetBuffer A pointer to the memory where the received item should
+ *		       be stored
+ * @param deadline_ms The DTN timestamp (in milliseconds) at which the
+ *		      receiving attempt should be aborted.
+ *		      If this value is UINT64_MAX, receiving will block
+ *		      indefinitely
+ * @return Whether the receiving was successful
+ */
+enum ud3tn_result hal_queue_receive_until(QueueIdentifier_t queue,
+					  void *targetBuffer,
+					  uint64_t deadline_ms);
+
 /**
  * @brief hal_queue_reset Reset (i.e. empty) the specific queue
  * @param queue The queue that should be cleared
@@ -19,6 +19,7 @@
 #include <semaphore.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 
 /**
  * @brief The Queue_t struct Data structure holding all queue-related info
@@ -101,4 +102,16 @@ uint8_t queuePush(Queue_t *queue, const void *item, int timeout, bool force);
  */
 uint8_t queuePop(Queue_t *queue, void *targetBuffer, int timeout);
 
+/**
+ * @brief queuePopUntil Pop an item from the queue, waiting at most until the
+ *			given absolute time
+ * @param queue The pointer to the queue structure
+ * @param targetBuffer The memory the item should be copied to
+ * @param abs_timeout Point in time (CLOCK_REALTIME) at which the waiting
+ *		      is aborted, NULL to block indefinitely
+ * @return EXIT_SUCCESS if an item was received, EXIT_FAILURE on timeout
+ */
+uint8_t queuePopUntil(Queue_t *queue, void *targetBuffer,
+		      const struct timespec *abs_timeout);
+
 #endif /* SIMPLE_QUEUE_H_INCLUDED */
@@ -346,6 +346,9 @@ struct bundle_adu {
 	char *destination;
 	uint8_t *payload;
 	size_t length;
+	// Number of bytes at the start of the payload buffer that are not part
+	// of the ADU, e.g., the header of a BIBE administrative record
+	size_t payload_offset;
 };
 
 
@@ -372,6 +375,12 @@ static inline bool bundle_block_must_be_replicated(
 uint64_t bundle_get_expiration_time_s(
 	const struct bundle *bundle, const uint64_t current_time_s);
 
+/**
+ * Get the approximate latest expiration time of the bundle in milliseconds.
+ */
+uint64_t bundle_get_expiration_time_ms(
+	const struct bundle *bundle, const uint64_t current_time_ms);
+
 enum ud3tn_result bundle_age_update(struct bundle *bundle,
 	const uint64_t dwell_time_ms);
 
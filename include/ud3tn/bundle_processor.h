@@ -25,6 +25,9 @@ enum bundle_processor_signal_type {
 	BP_SIGNAL_LINK_DOWN,
 	BP_SIGNAL_PROCESS_ROUTER_COMMAND,
 	BP_SIGNAL_CONTACT_OVER,
+	BP_SIGNAL_TX_BACKLOG_LOW,
+	BP_SIGNAL_RESCHEDULE_BUNDLES,
+	BP_SIGNAL_TIME_CHANGED,
 };
 
 // for performing (de)register operations
@@ -41,6 +44,7 @@ struct bundle_processor_signal {
 	struct agent_manager_parameters *agent_manager_params;
 	struct contact *contact;
 	struct router_command *router_cmd;
+	struct routed_bundle_list *bundles;
 };
 
 struct bundle_processor_task_parameters {
@@ -59,6 +63,19 @@ void bundle_processor_inform(
 	struct contact *contact,
 	struct router_command *router_cmd);
 
+/**
+ * @brief Hand back all bundles a link could not send in a single signal
+ *
+ * @param bundle_processor_signaling_queue Handle to the signaling queue of
+ *	the BP task
+ * @param bundles The list of bundles, ownership is passed to the BP
+ * @param peer_cla_addr The CLA address of the failed link, freed by the BP
+ */
+void bundle_processor_reschedule_bundles(
+	QueueIdentifier_t bundle_processor_signaling_queue,
+	struct routed_bundle_list *bundles,
+	char *peer_cla_addr);
+
 /**
  * @brief Instruct the BP to interact with the agent manager state
  *
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#ifndef CGR_H_INCLUDED
+#define CGR_H_INCLUDED
+
+#include "ud3tn/bundle.h"
+#include "ud3tn/node.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Contact Graph Routing (CGR)
+ *
+ * The contact plan contains the contacts of the local node with its neighbors,
+ * each annotated with the endpoints that are reachable through it. Every
+ * contact via which a destination is reachable is thus one route to it. The
+ * routes are kept in a list per destination which is ordered by the earliest
+ * possible arrival time (i.e., the contact start), so that the search for the
+ * earliest-arrival route can stop as soon as no remaining contact can improve
+ * on the best route found so far.
+ */
+
+struct cgr_route_list {
+	size_t count;
+	// Sorted by the start of the contact, then by its end
+	struct contact *contacts[];
+};
+
+struct cgr_route {
+	struct contact *contact;
+	uint64_t arrival_time_ms;
+	// Number of skipped contacts which could be used with preemption
+	uint8_t preemption_improved;
+};
+
+/**
+ * @brief Creates the route list for the given (unordered) contacts
+ *
+ * @return A new route list, or NULL if no memory could be allocated
+ */
+struct cgr_route_list *cgr_route_list_create(
+	const struct contact_list *contacts);
+void cgr_route_list_free(struct cgr_route_list *routes);
+
+/**
+ * @brief Determines when a bundle sent via the contact has been received
+ *
+ * This takes into account the bundles already scheduled for the contact,
+ * which are transmitted before the new bundle.
+ *
+ * @param contact The contact to be used
+ * @param size The size of the bundle in bytes
+ * @param time_ms The current time in milliseconds
+ * @return The earliest arrival time of the bundle in milliseconds
+ */
+uint64_t cgr_get_arrival_time_ms(
+	const struct contact *contact, uint32_t size, uint64_t time_ms);
+
+/**
+ * @brief Finds the route with the earliest arrival time for a bundle
+ *
+ * Only contacts with enough remaining capacity for the bundle are considered
+ * and the bundle has to arrive before the given deadline.
+ *
+ * @return True if a route has been found and stored in the result
+ */
+bool cgr_find_route(
+	const struct cgr_route_list *routes, uint32_t size,
+	enum bundle_routing_priority priority, uint64_t time_ms,
+	uint64_t deadline_ms, struct cgr_route *result);
+
+/**
+ * @brief Like cgr_find_route(), but starts at the given index of the list
+ *
+ * Leading contacts which have ended or have no capacity left for the given
+ * priority are skipped and the index is advanced past them, so that they do
+ * not have to be checked again for subsequent bundles. The index is only
+ * valid as long as the route list is unchanged and no capacity of its
+ * contacts has been released.
+ */
+bool cgr_find_route_from(
+	const struct cgr_route_list *routes, size_t *first, uint32_t size,
+	enum bundle_routing_priority priority, uint64_t time_ms,
+	uint64_t deadline_ms, struct cgr_route *result);
+
+#endif /* CGR_H_INCLUDED */
@@ -102,6 +102,26 @@ enum failed_forwarding_policy {
  */
 // Length of the outgoing-bundle queue (contact manager to TX task)
 #define CONTACT_TX_TASK_QUEUE_LENGTH 3
+// Bundles are only handed over to a TX task below this amount of queued data
+#define CONTACT_TX_QUEUE_HIGH_WATERMARK (4 * 1024 * 1024)
+// A congested TX task requests new bundles when falling below this amount
+#define CONTACT_TX_QUEUE_LOW_WATERMARK (1024 * 1024)
+// Whether the TX task limits the sending rate to the bitrate of the contact
+#define CONTACT_TX_PACING_ENABLED 1
+// The max. burst allowed by TX pacing, as time at the contact bitrate
+#define CONTACT_TX_PACING_BURST_MS 100
+// The max. time the TX task waits for the pacer before checking it again
+#define CONTACT_TX_PACING_MAX_DELAY_MS 1000
+// How the TX task selects the routing priority to send the next bundle from:
+// strictly the highest one, or weighted fair via deficit round robin
+#define CONTACT_TX_DISCIPLINE_STRICT 0
+#define CONTACT_TX_DISCIPLINE_WEIGHTED 1
+#define CONTACT_TX_DISCIPLINE CONTACT_TX_DISCIPLINE_STRICT
+// Bytes credited per round to the low, normal, and expedited priorities by
+// the weighted discipline, i.e., their share of the link
+#define CONTACT_TX_QUANTUM_LOW (16 * 1024)
+#define CONTACT_TX_QUANTUM_NORMAL (64 * 1024)
+#define CONTACT_TX_QUANTUM_HIGH (256 * 1024)
 // Length of the listen backlog for single-connection CLAs
 #define CLA_TCP_SINGLE_BACKLOG 1
 // Length of the listen backlog for multi-connection CLAs
@@ -113,10 +133,59 @@ enum failed_forwarding_policy {
 #define CLA_TCP_MAX_RETRY_ATTEMPTS 10
 // The number of slots in the TCP CLA hash tables (e.g. for TCPCLv3 and MTCP)
 #define CLA_TCP_PARAM_HTAB_SLOT_COUNT 32
-// Whether or not to close active TCP connections after a contact
-#define CLA_MTCP_CLOSE_AFTER_CONTACT 1
+// Whether or not to close active TCP connections after a contact. If not,
+// MTCP keeps them in a pool and hands them to the next contact with the peer.
+#define CLA_MTCP_CLOSE_AFTER_CONTACT 0
+// Pooled MTCP connections idle for longer than this are closed (0 = never)
+#define CLA_MTCP_POOL_IDLE_TIMEOUT_MS 60000
+// The interval in which pooled MTCP connections are checked for the timeout
+#define CLA_MTCP_POOL_CHECK_INTERVAL_MS 1000
+// TCP keepalive settings for detecting broken idle (pooled) connections
+#define CLA_TCP_KEEPALIVE_IDLE_S 10
+#define CLA_TCP_KEEPALIVE_INTERVAL_S 5
+#define CLA_TCP_KEEPALIVE_COUNT 3
+// The max. number of parallel connections used by MTCP for striped contacts
+#define CLA_MTCP_MAX_STRIPES 8
+// The interval in which MTCP retries handing bundles to a full stripe queue
+#define CLA_MTCP_DISPATCH_RETRY_INTERVAL_MS 10
+// The zlib level used for TCPCLv3 sessions if both peers enabled compression
+#define CLA_TCPCLV3_COMPRESSION_LEVEL 6
+// The size of the buffers for (de)compressing a TCPCLv3 session
+#define CLA_TCPCLV3_COMPRESSION_BUFFER_SIZE 4096
 // The maximum size of SPPs created by the TCPSPP CLA
 #define CLA_TCPSPP_SPP_MAX_SIZE (1 << 16)
+// The largest XFER_SEGMENT / transfer accepted by the TCPCLv4 CLA (MRUs)
+#define CLA_TCPCLV4_SEGMENT_MRU BUNDLE_MAX_SIZE
+#define CLA_TCPCLV4_TRANSFER_MRU BUNDLE_MAX_SIZE
+// The max. size of XFER_SEGMENTs sent by TCPCLv4, also limited by the peer MRU
+#define CLA_TCPCLV4_TX_SEGMENT_SIZE (1 << 16)
+// The max. accepted size of the extension items of a TCPCLv4 message
+#define CLA_TCPCLV4_MAX_EXTENSION_SIZE 1024
+// The max. size of TCPCLv4 control messages (e.g. XFER_ACK) waiting to be sent
+#define CLA_TCPCLV4_CONTROL_QUEUE_SIZE 4096
+// The default max. size of datagrams sent by the UDP CLA (fits a 1500 MTU)
+#define CLA_UDP_MAX_DATAGRAM_SIZE 1400
+// The upper bound for the max. datagram size configurable for the UDP CLA
+#define CLA_UDP_MAX_DATAGRAM_SIZE_LIMIT 65507
+// The number of datagrams received / sent by the UDP CLA per system call
+#define CLA_UDP_RX_BATCH_SIZE 32
+#define CLA_UDP_TX_BATCH_SIZE 32
+// The number of slots in the UDP CLA hash table
+#define CLA_UDP_PARAM_HTAB_SLOT_COUNT 32
+// The max. burst allowed by UDP pacing, as time at the configured rate
+#define CLA_UDP_PACING_BURST_MS 10
+// The size of every ring in the shared memory segment of the SHM CLA
+#define CLA_SHM_RING_SIZE (1 << 20)
+// The max. number of instances sending to a single SHM CLA at the same time
+#define CLA_SHM_MAX_PEERS 8
+// The max. length of the instance name used to address the SHM CLA
+#define CLA_SHM_MAX_NAME_LENGTH 63
+// The interval in which waiting SHM CLA tasks check whether the peer is alive
+#define CLA_SHM_WAIT_TIMEOUT_MS 100
+// The number of slots in the SHM CLA hash table
+#define CLA_SHM_PARAM_HTAB_SLOT_COUNT 16
+// Bundles of at least this size are passed as memfd by the Unix socket CLA
+#define CLA_UNIX_MEMFD_THRESHOLD 65536
 
 
 
@@ -136,6 +205,8 @@ enum failed_forwarding_policy {
 #define NODE_RELIABILITY_WEIGHT 1.0f
 /* Number of slots in the node hash table */
 #define NODE_HTAB_SLOT_COUNT 128
+/* Max. number of destinations for which the router caches routes */
+#define ROUTER_ROUTE_CACHE_SIZE 256
 /* Below this, NBFs will be consulted */
 #define ROUTER_MIN_CONTACTS_HTAB 10
 /* Below this, a default route will be used */
@@ -145,13 +216,4 @@ enum failed_forwarding_policy {
 #define ROUTER_DEF_BASE_RELIABILITY MIN_PROBABILITY
 
 
-
-/*
- * [CONTACT] contact related configuration
- */
-/* Maximum period (in ms) for checking */
-#define CONTACT_CHECKING_MAX_PERIOD 600000
-/* Maximum number of concurrent contacts that can be handled by CM */
-#define MAX_CONCURRENT_CONTACTS 10
-
 #endif /* CONFIG_H_INCLUDED */
@@ -2,6 +2,7 @@
 #ifndef CONTACTMANAGER_H_INCLUDED
 #define CONTACTMANAGER_H_INCLUDED
 
+#include "ud3tn/contact_timeline.h"
 #include "ud3tn/node.h"
 
 #include "platform/hal_types.h"
@@ -23,6 +24,6 @@ enum contact_manager_signal {
 
 struct contact_manager_params contact_manager_start(
 	QueueIdentifier_t bp_queue,
-	struct contact_list **clistptr);
+	struct contact_timeline *timeline);
 
 #endif /* CONTACTMANAGER_H_INCLUDED */
@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#ifndef CONTACT_TIMELINE_H_INCLUDED
+#define CONTACT_TIMELINE_H_INCLUDED
+
+#include "ud3tn/node.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The contact timeline indexes all contacts of the routing table by their
+ * start and end times. It consists of two balanced (AVL) search trees which
+ * are embedded into the contacts, thus, no allocations are necessary.
+ * Insertion, removal, and all lookups take O(log n) steps.
+ *
+ * The contact manager only visits contacts which started since it last
+ * checked the timeline. Contacts inserted again after that point, e.g.,
+ * because they were modified, are tracked separately in the changed set.
+ */
+struct contact_timeline {
+	struct contact_timeline_entry *starts;
+	struct contact_timeline_entry *ends;
+	size_t count;
+	// Contacts starting before this time have been processed
+	uint64_t processed_before;
+	// Contacts inserted with an earlier start or while being active
+	struct contact_timeline_entry *changed;
+};
+
+void contact_timeline_init(struct contact_timeline *timeline);
+
+/**
+ * @brief Adds a contact to the timeline or updates its position
+ *
+ * Has to be called again whenever the start or end of the contact changes.
+ */
+void contact_timeline_insert(
+	struct contact_timeline *timeline, struct contact *contact);
+
+/**
+ * @brief Removes a contact from the timeline if it is contained in it
+ */
+void contact_timeline_remove(
+	struct contact_timeline *timeline, struct contact *contact);
+
+bool contact_timeline_contains(const struct contact *contact);
+
+/**
+ * @brief Returns the contact which starts first, or NULL if there is none
+ */
+struct contact *contact_timeline_first_start(
+	const struct contact_timeline *timeline);
+
+/**
+ * @brief Returns the contact starting after the given one (or at the same
+ *        time, in a stable order), or NULL if there is none
+ */
+struct contact *contact_timeline_next_start(
+	const struct contact_timeline *timeline, const struct contact *contact);
+
+/**
+ * @brief Returns the first contact starting at or after the given time, or
+ *        NULL if there is none
+ */
+struct contact *contact_timeline_first_start_from(
+	const struct contact_timeline *timeline, uint64_t time);
+
+/**
+ * @brief Marks all contacts starting before the given time as processed
+ *
+ * Contacts inserted afterwards with an earlier start are added to the
+ * changed set, as are all active contacts which are inserted again.
+ */
+void contact_timeline_set_processed(
+	struct contact_timeline *timeline, uint64_t time);
+
+/**
+ * @brief Removes a contact from the changed set and returns it, or NULL if
+ *        the set is empty
+ */
+struct contact *contact_timeline_pop_changed(
+	struct contact_timeline *timeline);
+
+/**
+ * @brief Returns the contact which ends first, or NULL if there is none
+ */
+struct contact *contact_timeline_first_end(
+	const struct contact_timeline *timeline);
+
+/**
+ * @brief Returns the contact ending after the given one (or at the same
+ *        time, in a stable order), or NULL if there is none
+ */
+struct contact *contact_timeline_next_end(
+	const struct contact_timeline *timeline, const struct contact *contact);
+
+/**
+ * @brief Returns the first point in time after the given one at which a
+ *        contact starts or ends, or UINT64_MAX if there is none
+ */
+uint64_t contact_timeline_next_event(
+	const struct contact_timeline *timeline, uint64_t time);
+
+/*
+ * The search trees of the timeline can also be used to build further indexes
+ * of contacts, e.g., of a subset of them. Entries are ordered by their time
+ * and then by the address of their contact. The contact is never accessed,
+ * thus, it may already have been freed while the entry is still indexed.
+ */
+
+/**
+ * @brief Adds an entry, its contact and time have to be set beforehand
+ */
+void contact_index_insert(
+	struct contact_timeline_entry **root, struct contact_timeline_entry *e);
+
+/**
+ * @brief Removes an entry, has no effect if it is not contained in the index
+ */
+void contact_index_remove(
+	struct contact_timeline_entry **root, struct contact_timeline_entry *e);
+
+struct contact_timeline_entry *contact_index_first(
+	struct contact_timeline_entry *root);
+
+struct contact_timeline_entry *contact_index_next(
+	struct contact_timeline_entry *root,
+	const struct contact_timeline_entry *e);
+
+/**
+ * @brief Returns the entry with the given time and contact, or NULL
+ */
+struct contact_timeline_entry *contact_index_find(
+	struct contact_timeline_entry *root,
+	uint64_t time, const struct contact *contact);
+
+#endif /* CONTACT_TIMELINE_H_INCLUDED */
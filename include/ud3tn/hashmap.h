@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#ifndef HASHMAP_H_INCLUDED
+#define HASHMAP_H_INCLUDED
+
+#include "ud3tn/result.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Hash map with string keys using open addressing ("Swiss table" design).
+ *
+ * Slots are organized in groups of HASHMAP_GROUP_WIDTH. For every slot, a
+ * control byte stores whether it is empty or deleted, or seven bits of the
+ * hash of its key. A lookup compares the control bytes of a whole group at
+ * once (using SSE2 if available) and only compares keys for slots with a
+ * matching control byte and cached hash.
+ *
+ * When the map has to grow, a new table is allocated and the entries are
+ * moved over incrementally by every subsequent insertion or removal, so no
+ * single operation has to re-insert all entries.
+ *
+ * In the default mode, the map stores a copy of every key. If keys are
+ * borrowed, the caller has to ensure that a key stays valid and unchanged
+ * until its entry is removed.
+ */
+
+#define HASHMAP_GROUP_WIDTH 16
+
+struct hashmap_slot {
+	uint32_t hash;
+	const char *key;
+	void *value;
+};
+
+struct hashmap_table {
+	uint8_t *ctrl;
+	struct hashmap_slot *slots;
+	size_t group_count;
+	size_t used;
+	size_t deleted;
+};
+
+struct hashmap {
+	struct hashmap_table table;
+	// Previous table of which the entries are still being moved
+	struct hashmap_table old_table;
+	size_t migrated_groups;
+	bool borrow_keys;
+};
+
+/**
+ * @brief Initializes a map that can hold the given number of entries
+ *        without growing
+ */
+enum ud3tn_result hashmap_init(
+	struct hashmap *map, size_t capacity, bool borrow_keys);
+
+/**
+ * @brief Frees all memory of the map except for the values
+ */
+void hashmap_free(struct hashmap *map);
+
+/**
+ * @brief Removes all entries but keeps the allocated table
+ */
+void hashmap_clear(struct hashmap *map);
+
+/**
+ * @brief Adds an entry
+ *
+ * @return UD3TN_FAIL if an entry with the key exists or on allocation failure
+ */
+enum ud3tn_result hashmap_add(
+	struct hashmap *map, const char *key, void *value);
+
+void *hashmap_get(const struct hashmap *map, const char *key);
+
+/**
+ * @brief Removes an entry
+ *
+ * @return The value of the removed entry or NULL if the key was not found
+ */
+void *hashmap_remove(struct hashmap *map, const char *key);
+
+size_t hashmap_count(const struct hashmap *map);
+
+/**
+ * @brief Iterates over all entries in no particular order
+ *
+ * The map must not be modified during the iteration.
+ *
+ * @param iter Position of the iteration, has to be zero initially
+ * @return False if there are no more entries
+ */
+bool hashmap_iterate(
+	const struct hashmap *map, size_t *iter,
+	const char **key, void **value);
+
+#endif /* HASHMAP_H_INCLUDED */
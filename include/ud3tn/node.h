@@ -5,26 +5,57 @@
 #include "ud3tn/bundle.h"
 #include "ud3tn/result.h"
 
+#include <stddef.h>
 #include <stdint.h>
 
 struct routed_bundle_list {
 	struct bundle *data;
 	struct routed_bundle_list *next;
+	// Only maintained while the entry is queued for a contact
+	struct routed_bundle_list *prev;
+	// Contact capacity consumed by the bundle, set by the router
+	uint64_t scheduled_size;
+	// Routing priority of the bundle, set by the router
+	enum bundle_routing_priority priority;
+};
+
+// Node of one of the search trees of the contact timeline
+struct contact_timeline_entry {
+	struct contact *contact;
+	struct contact_timeline_entry *left;
+	struct contact_timeline_entry *right;
+	// The key, i.e., the start or end of the contact when it was inserted
+	uint64_t time;
+	// Height of the subtree, zero if the contact is not in the timeline
+	int8_t height;
 };
 
 struct contact {
 	struct node *node;
+	// Start and end of the contact as DTN timestamps in milliseconds
 	uint64_t from;
 	uint64_t to;
-	uint32_t bitrate;
-	uint32_t total_capacity;
-	int32_t remaining_capacity_p0;
-	int32_t remaining_capacity_p1;
-	int32_t remaining_capacity_p2;
+	// Data rate in bytes per second
+	uint64_t bitrate;
+	// Volume of the contact in bytes, see CONTACT_CAPACITY_INFINITE
+	uint64_t total_capacity;
+	int64_t remaining_capacity_p0;
+	int64_t remaining_capacity_p1;
+	int64_t remaining_capacity_p2;
 	struct endpoint_list *contact_endpoints;
+	// Bundles scheduled for the contact, see contact_*_bundle_entry(). The
+	// list consists of one FIFO sub-queue per routing priority, ordered
+	// from the highest to the lowest priority.
 	struct routed_bundle_list *contact_bundles;
-	uint8_t bundle_count;
+	// The last entry of each sub-queue, NULL if it is empty
+	struct routed_bundle_list *contact_bundles_tail[BUNDLE_RPRIO_MAX];
+	size_t bundle_count;
+	// Sum of the scheduled sizes of all bundles in contact_bundles
+	uint64_t bundle_bytes;
 	int8_t active;
+	struct contact_timeline_entry timeline_start;
+	struct contact_timeline_entry timeline_end;
+	struct contact_timeline_entry timeline_changed;
 };
 
 struct contact_list {
@@ -37,9 +68,18 @@ enum node_flags {
 	NODE_FLAG_INTERNET_ACCESS = 0x1
 };
 
+struct cla_config;
+
 struct node {
 	char *eid;
 	char *cla_addr;
+	// CLA instance and its max. bundle size, resolved from cla_addr when
+	// the node is added to the routing table
+	struct cla_config *cla_config;
+	size_t cla_mbs;
+	// Size of bundles on the wire per 1000 bytes as reported by the CLA
+	// link, lower than 1000 if the CLA compresses the bundles
+	uint16_t wire_size_permille;
 	enum node_flags flags;
 	struct endpoint_list *endpoints;
 	struct contact_list *contacts;
@@ -47,9 +87,14 @@ struct node {
 
 struct node_list {
 	struct node *node;
+	struct node_list *prev;
 	struct node_list *next;
 };
 
+// Capacity of a contact of which the volume cannot be represented, i.e.,
+// an arbitrary number of bundles can be scheduled for it.
+#define CONTACT_CAPACITY_INFINITE INT64_MAX
+
 #define CONTACT_CAPACITY(contact, p) \
 	(p == 1 ? contact->remaining_capacity_p1 : \
 	(p == 2 ? contact->remaining_capacity_p2 : \
@@ -80,7 +125,7 @@ struct contact_list *contact_list_difference(
 struct endpoint_list *endpoint_list_strip_and_sort(struct endpoint_list *el);
 int node_prepare_and_verify(struct node *node);
 void recalculate_contact_capacity(struct contact *contact);
-int32_t contact_get_cur_remaining_capacity(
+int64_t contact_get_cur_remaining_capacity(
 	struct contact *contact, enum bundle_routing_priority prio);
 int add_contact_to_ordered_list(
 	struct contact_list **list, struct contact *contact,
@@ -88,4 +133,26 @@ int add_contact_to_ordered_list(
 int remove_contact_from_list(
 	struct contact_list **list, struct contact *contact);
 
+/* Bundle queue of a contact, all operations except the lookup take O(1). */
+
+/**
+ * @brief Appends an entry to the sub-queue of its priority
+ */
+void contact_append_bundle_entry(
+	struct contact *contact, struct routed_bundle_list *entry);
+void contact_remove_bundle_entry(
+	struct contact *contact, struct routed_bundle_list *entry);
+/**
+ * @brief Returns the entry of the given bundle, searching the sub-queue of
+ *        the given priority from its tail as recently added bundles are the
+ *        most likely to be removed again
+ */
+struct routed_bundle_list *contact_find_bundle_entry(
+	const struct contact *contact, const struct bundle *bundle,
+	enum bundle_routing_priority prio);
+/**
+ * @brief Detaches and returns all queued entries as a NULL-terminated list
+ */
+struct routed_bundle_list *contact_take_bundles(struct contact *contact);
+
 #endif // NODE_H_INCLUDED
@@ -36,15 +36,21 @@ struct router_result {
 
 #define ROUTER_BUNDLE_PRIORITY(bundle) (bundle_get_routing_priority(bundle))
 #define ROUTER_CONTACT_CAPACITY(contact, prio) \
-	(contact_get_cur_remaining_capacity(contact, prio))
+	(router_get_contact_capacity(contact, prio))
 
 struct router_config router_get_config(void);
 void router_update_config(struct router_config config);
 
-struct contact_list *router_lookup_destination(char *dest);
+int64_t router_get_contact_capacity(
+	struct contact *contact, enum bundle_routing_priority prio);
+
+struct node_table_entry *router_lookup_destination(const char *dest);
+// Drops all routes cached per destination EID.
+void router_clear_route_cache(void);
+// Finds the first contact with enough capacity, exp_time is in ms.
 uint8_t router_calculate_fragment_route(
 	struct fragment_route *res, uint32_t size,
-	struct contact_list *contacts, uint32_t preprocessed_size,
+	struct contact_list *contacts, uint64_t preprocessed_size,
 	enum bundle_routing_priority priority, uint64_t exp_time,
 	struct contact **excluded_contacts, uint8_t excluded_contacts_count);
 
@@ -56,6 +62,9 @@ enum ud3tn_result router_add_bundle_to_contact(
 	struct contact *contact, struct bundle *b);
 enum ud3tn_result router_remove_bundle_from_contact(
 	struct contact *contact, struct bundle *bundle);
+// Removes a known entry in O(1) and frees it (but not the bundle).
+void router_remove_bundle_entry_from_contact(
+	struct contact *contact, struct routed_bundle_list *entry);
 
 /* BP-side API */
 
@@ -64,12 +73,18 @@ enum router_command_type {
 	ROUTER_COMMAND_ADD = 0x31,    /* ASCII 1 */
 	ROUTER_COMMAND_UPDATE = 0x32, /* ASCII 2 */
 	ROUTER_COMMAND_DELETE = 0x33, /* ASCII 3 */
-	ROUTER_COMMAND_QUERY = 0x34   /* ASCII 4 */
+	ROUTER_COMMAND_QUERY = 0x34,  /* ASCII 4 */
+	ROUTER_COMMAND_MODIFY = 0x35, /* ASCII 5 */
+	// ADD for all nodes of a bulk contact plan, see contact_plan_parser.h
+	ROUTER_COMMAND_ADD_BULK = 0x36
 };
 
 struct router_command {
 	enum router_command_type type;
 	struct node *data;
+	// The nodes of a ROUTER_COMMAND_ADD_BULK command, data is NULL then
+	struct node **nodes;
+	size_t node_count;
 };
 
 struct bundle_tx_result {
@@ -85,10 +100,44 @@ enum router_result_status {
 	ROUTER_RESULT_EXPIRED,
 };
 
+typedef void (*route_failure_func_t)(
+	struct bundle *bundle,
+	enum router_result_status result,
+	void *route_failure_func_context
+);
+
+struct route_failure_handle {
+	route_failure_func_t route_failure_func;
+	void *route_failure_func_context;
+};
+
+/**
+ * @brief Applies a router command to the routing table and frees it
+ *
+ * Returns UD3TN_OK only if the whole command has been applied. The number of
+ * applied nodes, or of modified contacts for ROUTER_COMMAND_MODIFY, is stored
+ * to applied_count if not NULL. It may be nonzero also on failure of a
+ * ROUTER_COMMAND_ADD_BULK or ROUTER_COMMAND_MODIFY command.
+ */
 enum ud3tn_result router_process_command(
 	struct router_command *command,
-	struct rescheduling_handle rescheduler);
+	struct rescheduling_handle rescheduler,
+	size_t *applied_count);
 enum router_result_status router_route_bundle(
 	struct bundle *b);
 
+/**
+ * @brief Routes all bundles of a list, e.g., those left over by a failed link
+ *
+ * The caller has to hold the routing table lock for the whole batch, so all
+ * bundles are routed against the same routing table state. The list entries
+ * are freed, bundles which cannot be routed are passed to the failure handler,
+ * which must not invoke the router itself.
+ *
+ * @return The number of bundles that have been routed successfully
+ */
+size_t router_route_bundle_list(
+	struct routed_bundle_list *bundles,
+	struct route_failure_handle failure_handler);
+
 #endif /* ROUTER_H_INCLUDED */
@@ -3,6 +3,8 @@
 #define ROUTINGTABLE_H_INCLUDED
 
 #include "ud3tn/bundle.h"
+#include "ud3tn/cgr.h"
+#include "ud3tn/contact_timeline.h"
 #include "ud3tn/node.h"
 #include "ud3tn/result.h"
 
@@ -13,6 +15,8 @@
 struct node_table_entry {
 	uint16_t ref_count;
 	struct contact_list *contacts;
+	// Routes to the EID, created on demand and dropped on every change
+	struct cgr_route_list *routes;
 };
 
 typedef void (*reschedule_func_t)(
@@ -29,6 +33,10 @@ void routing_table_free(void);
 
 struct node *routing_table_lookup_node(const char *eid);
 struct node_table_entry *routing_table_lookup_eid(const char *eid);
+const struct cgr_route_list *routing_table_get_routes(
+	struct node_table_entry *entry);
+// Changes whenever an entry is added, removed, or its contacts change.
+uint32_t routing_table_get_generation(void);
 uint8_t routing_table_lookup_eid_in_nbf(
 	char *eid, struct node **target, uint8_t max);
 uint8_t routing_table_lookup_hot_node(
@@ -42,8 +50,13 @@ bool routing_table_delete_node(
 	struct node *new_node, struct rescheduling_handle rescheduler);
 bool routing_table_delete_node_by_eid(
 	char *eid, struct rescheduling_handle rescheduler);
+// Sets window and data rate of the contacts overlapping the given ones.
+// Returns true if all were modified, their number is stored to modified.
+bool routing_table_modify_contacts(
+	struct node *node, struct rescheduling_handle rescheduler,
+	size_t *modified);
 
-struct contact_list **routing_table_get_raw_contact_list_ptr(void);
+struct contact_timeline *routing_table_get_contact_timeline(void);
 struct node_list *routing_table_get_node_list(void);
 void routing_table_delete_contact(struct contact *contact);
 void routing_table_contact_passed(
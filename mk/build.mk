@@ -40,6 +40,8 @@ $(eval $(call addComponentWithRules,external/util/src))
 
 $(eval $(call generateComponentRules,components/daemon))
 $(eval $(call generateComponentRules,test/unit))
+$(eval $(call generateComponentRules,test/benchmark/hashmap))
+$(eval $(call generateComponentRules,test/benchmark/contact_plan))
 
 build/$(PLATFORM)/libud3tn.so: LDFLAGS += $(LDFLAGS_LIB)
 build/$(PLATFORM)/libud3tn.so: LIBS = $(LIBS_libud3tn.so)
@@ -73,6 +75,25 @@ build/$(PLATFORM)/testud3tn: LIBS = $(LIBS_testud3tn)
 build/$(PLATFORM)/testud3tn: $(LIBS_testud3tn) | build/$(PLATFORM)
 	$(call cmd,link)
 
+# BENCHMARK EXECUTABLE
+
+# Every benchmark has its own component as each of them defines main().
+$(eval $(call addComponent,benchhashmap,test/benchmark/hashmap))
+LIBS_benchhashmap += $(LIBS_libud3tn.so)
+
+build/$(PLATFORM)/benchhashmap: LDFLAGS += $(LDFLAGS_EXECUTABLE)
+build/$(PLATFORM)/benchhashmap: LIBS = $(LIBS_benchhashmap)
+build/$(PLATFORM)/benchhashmap: $(LIBS_benchhashmap) | build/$(PLATFORM)
+	$(call cmd,link)
+
+$(eval $(call addComponent,benchcontactplan,test/benchmark/contact_plan))
+LIBS_benchcontactplan += $(LIBS_libud3tn.so)
+
+build/$(PLATFORM)/benchcontactplan: LDFLAGS += $(LDFLAGS_EXECUTABLE)
+build/$(PLATFORM)/benchcontactplan: LIBS = $(LIBS_benchcontactplan)
+build/$(PLATFORM)/benchcontactplan: $(LIBS_benchcontactplan) | build/$(PLATFORM)
+	$(call cmd,link)
+
 # GENERAL RULES
 
 build/$(PLATFORM): | build
@@ -31,14 +31,16 @@ class RouterCommand(enum.IntEnum):
     UPDATE = 2
     DELETE = 3
     QUERY = 4
+    MODIFY = 5
 
 
 Contact = namedtuple('Contact', ['start', 'end', 'bitrate'])
 Contact.__doc__ = """named tuple holding uD3TN contact information
 
 Attrs:
-    start (int): DTN timestamp when the contact starts
-    end (int): DTN timestamp when the contact is over
+    start (int or float): DTN timestamp in seconds when the contact starts,
+        fractions of a second are considered with millisecond precision
+    end (int or float): DTN timestamp in seconds when the contact is over
     bitrate (int): Bitrate of the contact
 """
 
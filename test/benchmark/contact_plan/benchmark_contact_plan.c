@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+/*
+ * Benchmark comparing the loader for contact plans in the text format
+ * (config_parser.c) with the one for the CBOR bulk format
+ * (contact_plan_parser.c). Measures decoding alone as well as decoding and
+ * adding all nodes to the routing table.
+ *
+ * Usage: benchcontactplan [contact count]
+ */
+#include "agents/config_parser.h"
+#include "agents/contact_plan_parser.h"
+
+#include "ud3tn/node.h"
+#include "ud3tn/router.h"
+#include "ud3tn/routing_table.h"
+
+#include "platform/hal_time.h"
+
+#include "cbor.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CONTACTS_PER_NODE 100
+#define CONTACT_DURATION_MS 60000
+#define CONTACT_BITRATE 1000
+// Upper bounds for the encoded size of one node and one contact
+#define TEXT_NODE_SIZE 64
+#define TEXT_CONTACT_SIZE 64
+#define BULK_NODE_SIZE 32
+#define BULK_CONTACT_SIZE 32
+
+static struct config_parser parser;
+static char **text_commands;
+static size_t node_count;
+static uint8_t *bulk_plan;
+static size_t bulk_length;
+static bool apply_plan;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void *checked_malloc(const size_t size)
+{
+	void *result = malloc(size);
+
+	if (result == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	return result;
+}
+
+static void reschedule_mock(struct bundle *b, const void *ctx)
+{
+	(void)b;
+	(void)ctx;
+}
+
+static const struct rescheduling_handle rescheduler = {
+	.reschedule_func = reschedule_mock,
+	.reschedule_func_context = NULL,
+};
+
+static size_t node_contact_count(const size_t contact_count, const size_t i)
+{
+	const size_t rest = contact_count - i * CONTACTS_PER_NODE;
+
+	return rest < CONTACTS_PER_NODE ? rest : CONTACTS_PER_NODE;
+}
+
+static uint64_t contact_start(const uint64_t base, const size_t i)
+{
+	return base + i * 2 * CONTACT_DURATION_MS;
+}
+
+static size_t generate_text_plan(const size_t contact_count,
+				 const uint64_t base)
+{
+	size_t i, j, pos, total = 0;
+
+	text_commands = checked_malloc(sizeof(char *) * node_count);
+	for (i = 0; i < node_count; i++) {
+		const size_t count = node_contact_count(contact_count, i);
+		const size_t size = TEXT_NODE_SIZE + count * TEXT_CONTACT_SIZE;
+		char *const cmd = checked_malloc(size);
+
+		pos = snprintf(cmd, size, "1(dtn://node%zu.dtn/):()::[", i);
+		for (j = 0; j < count; j++) {
+			const uint64_t from = contact_start(base, j);
+			const uint64_t to = from + CONTACT_DURATION_MS;
+
+			pos += snprintf(
+				cmd + pos, size - pos,
+				"{%llu.%03llu,%llu.%03llu,%d},",
+				(unsigned long long)(from / 1000),
+				(unsigned long long)(from % 1000),
+				(unsigned long long)(to / 1000),
+				(unsigned long long)(to % 1000),
+				CONTACT_BITRATE
+			);
+		}
+		// Replace the last separator.
+		snprintf(cmd + pos - 1, size - pos + 1, "];");
+		text_commands[i] = cmd;
+		total += pos + 1;
+	}
+	return total;
+}
+
+static void generate_bulk_plan(const size_t contact_count,
+			       const uint64_t base)
+{
+	const size_t size = (
+		BULK_NODE_SIZE * (node_count + 1) +
+		BULK_CONTACT_SIZE * contact_count
+	);
+	CborEncoder encoder, nodes, node, list, contact;
+	char eid[TEXT_NODE_SIZE];
+	size_t i, j;
+
+	bulk_plan = checked_malloc(size);
+	cbor_encoder_init(&encoder, bulk_plan, size, 0);
+	cbor_encoder_create_array(&encoder, &nodes, node_count);
+	for (i = 0; i < node_count; i++) {
+		const size_t count = node_contact_count(contact_count, i);
+
+		snprintf(eid, sizeof(eid), "dtn://node%zu.dtn/", i);
+		cbor_encoder_create_array(&nodes, &node, 4);
+		cbor_encode_text_stringz(&node, eid);
+		cbor_encode_text_stringz(&node, "");
+		cbor_encoder_create_array(&node, &list, 0);
+		cbor_encoder_close_container(&node, &list);
+		cbor_encoder_create_array(&node, &list, count);
+		for (j = 0; j < count; j++) {
+			const uint64_t from = contact_start(base, j);
+
+			cbor_encoder_create_array(&list, &contact, 3);
+			cbor_encode_uint(&contact, from);
+			cbor_encode_uint(&contact, from + CONTACT_DURATION_MS);
+			cbor_encode_uint(&contact, CONTACT_BITRATE);
+			cbor_encoder_close_container(&list, &contact);
+		}
+		cbor_encoder_close_container(&node, &list);
+		cbor_encoder_close_container(&nodes, &node);
+	}
+	cbor_encoder_close_container(&encoder, &nodes);
+	bulk_length = cbor_encoder_get_buffer_size(&encoder, bulk_plan);
+}
+
+static void text_command_received(struct router_command *cmd, void *param)
+{
+	(void)param;
+	if (apply_plan)
+		routing_table_add_node(cmd->data, rescheduler);
+	else
+		free_node(cmd->data);
+	free(cmd);
+}
+
+static double load_text_plan(void)
+{
+	const uint64_t start = now_ns();
+	size_t i;
+
+	for (i = 0; i < node_count; i++) {
+		config_parser_reset(&parser);
+		config_parser_read(&parser, (const uint8_t *)text_commands[i],
+				   strlen(text_commands[i]));
+	}
+	return (double)(now_ns() - start) / 1000000;
+}
+
+static double load_bulk_plan(void)
+{
+	const uint64_t start = now_ns();
+	struct router_command *cmd;
+	size_t i;
+
+	cmd = contact_plan_parse(bulk_plan, bulk_length);
+	if (cmd == NULL) {
+		fprintf(stderr, "Invalid bulk plan\n");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < cmd->node_count; i++) {
+		if (apply_plan)
+			routing_table_add_node(cmd->nodes[i], rescheduler);
+		else
+			free_node(cmd->nodes[i]);
+	}
+	free(cmd->nodes);
+	free(cmd);
+	return (double)(now_ns() - start) / 1000000;
+}
+
+static void print_result(const char *format, const char *phase,
+			 const size_t contact_count, const double ms)
+{
+	printf("%-8s %-8s %10zu %10.1f %14.0f\n", format, phase,
+	       contact_count, ms, contact_count / ms * 1000);
+}
+
+int main(int argc, char *argv[])
+{
+	size_t contact_count = 50000;
+	size_t text_length, i;
+	uint64_t base;
+
+	if (argc > 1)
+		contact_count = strtoul(argv[1], NULL, 10);
+	if (contact_count == 0) {
+		fprintf(stderr, "Usage: %s [contact count]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	hal_time_init(0);
+	if (config_parser_init(&parser, &text_command_received, NULL) == NULL ||
+	    routing_table_init() != UD3TN_OK) {
+		fprintf(stderr, "Out of memory\n");
+		return EXIT_FAILURE;
+	}
+	// All contacts start in the future so that none of them is rejected.
+	base = hal_time_get_timestamp_ms() + 3600000;
+	node_count = (contact_count + CONTACTS_PER_NODE - 1) /
+		CONTACTS_PER_NODE;
+	text_length = generate_text_plan(contact_count, base);
+	generate_bulk_plan(contact_count, base);
+	printf("Plan with %zu nodes: text = %zu bytes, bulk = %zu bytes\n\n",
+	       node_count, text_length, bulk_length);
+
+	printf("%-8s %-8s %10s %10s %14s\n", "format", "phase", "contacts",
+	       "time/ms", "contacts/s");
+	apply_plan = false;
+	print_result("text", "decode", contact_count, load_text_plan());
+	print_result("bulk", "decode", contact_count, load_bulk_plan());
+	apply_plan = true;
+	print_result("text", "load", contact_count, load_text_plan());
+	routing_table_free();
+	print_result("bulk", "load", contact_count, load_bulk_plan());
+	routing_table_free();
+
+	for (i = 0; i < node_count; i++)
+		free(text_commands[i]);
+	free(text_commands);
+	free(bulk_plan);
+	return EXIT_SUCCESS;
+}
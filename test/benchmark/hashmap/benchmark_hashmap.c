@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+/*
+ * Microbenchmark comparing the chained, fixed-size htab (simplehtab.c) with
+ * the open-addressing hashmap (hashmap.c) using EID-like string keys.
+ *
+ * Usage: benchhashmap [max. key count]
+ */
+#include "ud3tn/config.h"
+#include "ud3tn/hashmap.h"
+#include "ud3tn/simplehtab.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define LOOKUP_ROUNDS 10
+#define KEY_SIZE 48
+
+struct bench_result {
+	double insert_ns;
+	double hit_ns;
+	double miss_ns;
+	double remove_ns;
+};
+
+static char **keys;
+static char **missing_keys;
+static volatile uintptr_t sink;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static char *make_key(const char *fmt, const size_t i)
+{
+	char *key = malloc(KEY_SIZE);
+
+	if (key == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	snprintf(key, KEY_SIZE, fmt, i);
+	return key;
+}
+
+static void bench_htab(const size_t n, struct bench_result *r)
+{
+	struct htab *tab = htab_alloc(NODE_HTAB_SLOT_COUNT);
+	uint64_t start;
+	size_t i, k;
+
+	start = now_ns();
+	for (i = 0; i < n; i++)
+		htab_add(tab, keys[i], keys[i]);
+	r->insert_ns = (double)(now_ns() - start) / n;
+
+	start = now_ns();
+	for (k = 0; k < LOOKUP_ROUNDS; k++)
+		for (i = 0; i < n; i++)
+			sink += (uintptr_t)htab_get(tab, keys[i]);
+	r->hit_ns = (double)(now_ns() - start) / (n * LOOKUP_ROUNDS);
+
+	start = now_ns();
+	for (k = 0; k < LOOKUP_ROUNDS; k++)
+		for (i = 0; i < n; i++)
+			sink += (uintptr_t)htab_get(tab, missing_keys[i]);
+	r->miss_ns = (double)(now_ns() - start) / (n * LOOKUP_ROUNDS);
+
+	start = now_ns();
+	for (i = 0; i < n; i++)
+		sink += (uintptr_t)htab_remove(tab, keys[i]);
+	r->remove_ns = (double)(now_ns() - start) / n;
+
+	htab_free(tab);
+}
+
+static void bench_hashmap(const size_t n, const bool borrow_keys,
+			  struct bench_result *r)
+{
+	struct hashmap map;
+	uint64_t start;
+	size_t i, k;
+
+	if (hashmap_init(&map, NODE_HTAB_SLOT_COUNT,
+			 borrow_keys) != UD3TN_OK) {
+		fprintf(stderr, "Out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	start = now_ns();
+	for (i = 0; i < n; i++)
+		hashmap_add(&map, keys[i], keys[i]);
+	r->insert_ns = (double)(now_ns() - start) / n;
+
+	start = now_ns();
+	for (k = 0; k < LOOKUP_ROUNDS; k++)
+		for (i = 0; i < n; i++)
+			sink += (uintptr_t)hashmap_get(&map, keys[i]);
+	r->hit_ns = (double)(now_ns() - start) / (n * LOOKUP_ROUNDS);
+
+	start = now_ns();
+	for (k = 0; k < LOOKUP_ROUNDS; k++)
+		for (i = 0; i < n; i++)
+			sink += (uintptr_t)hashmap_get(&map, missing_keys[i]);
+	r->miss_ns = (double)(now_ns() - start) / (n * LOOKUP_ROUNDS);
+
+	start = now_ns();
+	for (i = 0; i < n; i++)
+		sink += (uintptr_t)hashmap_remove(&map, keys[i]);
+	r->remove_ns = (double)(now_ns() - start) / n;
+
+	hashmap_free(&map);
+}
+
+static void print_result(const char *name, const size_t n,
+			 const struct bench_result *r)
+{
+	printf("%-16s %8zu %10.1f %10.1f %10.1f %10.1f\n",
+	       name, n, r->insert_ns, r->hit_ns, r->miss_ns, r->remove_ns);
+}
+
+int main(int argc, char *argv[])
+{
+	size_t max_count = 100000;
+	struct bench_result r;
+	size_t i, n;
+
+	if (argc > 1)
+		max_count = strtoul(argv[1], NULL, 10);
+	if (max_count == 0) {
+		fprintf(stderr, "Usage: %s [max. key count]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	keys = malloc(sizeof(char *) * max_count);
+	missing_keys = malloc(sizeof(char *) * max_count);
+	if (keys == NULL || missing_keys == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		return EXIT_FAILURE;
+	}
+	for (i = 0; i < max_count; i++) {
+		keys[i] = make_key("dtn://node%zu.dtn/", i);
+		missing_keys[i] = make_key("dtn://other%zu.dtn/", i);
+	}
+
+	printf("%-16s %8s %10s %10s %10s %10s\n", "table", "keys",
+	       "insert/ns", "hit/ns", "miss/ns", "remove/ns");
+	for (n = 10; n <= max_count; n *= 10) {
+		bench_htab(n, &r);
+		print_result("htab", n, &r);
+		bench_hashmap(n, false, &r);
+		print_result("hashmap", n, &r);
+		bench_hashmap(n, true, &r);
+		print_result("hashmap/borrow", n, &r);
+	}
+
+	for (i = 0; i < max_count; i++) {
+		free(keys[i]);
+		free(missing_keys[i]);
+	}
+	free(keys);
+	free(missing_keys);
+	return EXIT_SUCCESS;
+}
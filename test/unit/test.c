@@ -5,9 +5,12 @@ void testud3tn(void)
 {
 	RUN_TEST_GROUP(ud3tn);
 	RUN_TEST_GROUP(simplehtab);
+	RUN_TEST_GROUP(hashmap);
 	RUN_TEST_GROUP(sdnv);
 	RUN_TEST_GROUP(node);
 	RUN_TEST_GROUP(routingTable);
+	RUN_TEST_GROUP(cgr);
+	RUN_TEST_GROUP(contact_timeline);
 	RUN_TEST_GROUP(eid);
 	RUN_TEST_GROUP(random);
 	RUN_TEST_GROUP(malloc);
@@ -25,10 +28,13 @@ void testud3tn(void)
 	RUN_TEST_GROUP(aap);
 	RUN_TEST_GROUP(aap_parser);
 	RUN_TEST_GROUP(aap_serializer);
+	RUN_TEST_GROUP(contact_plan_parser);
 	RUN_TEST_GROUP(bibe_header_encoder);
 	RUN_TEST_GROUP(bibe_parser);
 	RUN_TEST_GROUP(bibe_validation);
 #ifdef PLATFORM_POSIX
 	RUN_TEST_GROUP(simple_queue);
+	RUN_TEST_GROUP(tcpclv4_proto);
+	RUN_TEST_GROUP(cla_zlib);
 #endif // PLATFORM_POSIX
 }
@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#include "ud3tn/bundle.h"
+#include "ud3tn/cgr.h"
+#include "ud3tn/common.h"
+#include "ud3tn/node.h"
+#include "ud3tn/routing_table.h"
+
+#include "platform/hal_time.h"
+
+#include "unity_fixture.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+TEST_GROUP(cgr);
+
+static struct node *node;
+static struct contact_list *contacts;
+
+static struct contact *createct(uint64_t from, uint64_t to, uint32_t bitrate)
+{
+	struct contact *c = contact_create(node);
+
+	c->from = from;
+	c->to = to;
+	c->bitrate = bitrate;
+	recalculate_contact_capacity(c);
+	add_contact_to_ordered_list(&node->contacts, c, 1);
+	return c;
+}
+
+static void rescheduling_mock(struct bundle *b, const void *ctx)
+{
+	(void)b;
+	(void)ctx;
+}
+
+static const struct rescheduling_handle rescheduler = {
+	.reschedule_func = rescheduling_mock,
+	.reschedule_func_context = NULL,
+};
+
+TEST_SETUP(cgr)
+{
+	node = node_create("dtn://a/");
+	node->cla_addr = strdup("cla:addr");
+	contacts = NULL;
+	hal_time_init(0);
+}
+
+TEST_TEAR_DOWN(cgr)
+{
+	list_free(contacts);
+	free_node(node);
+}
+
+TEST(cgr, route_list_is_sorted_by_start)
+{
+	struct contact *c1 = createct(30, 40, 1);
+	struct contact *c2 = createct(10, 50, 1);
+	struct contact *c3 = createct(10, 20, 1);
+
+	add_contact_to_ordered_list(&contacts, c1, 0);
+	add_contact_to_ordered_list(&contacts, c2, 0);
+	add_contact_to_ordered_list(&contacts, c3, 0);
+
+	struct cgr_route_list *routes = cgr_route_list_create(contacts);
+
+	TEST_ASSERT_NOT_NULL(routes);
+	TEST_ASSERT_EQUAL(3, routes->count);
+	TEST_ASSERT_EQUAL_PTR(c3, routes->contacts[0]);
+	TEST_ASSERT_EQUAL_PTR(c2, routes->contacts[1]);
+	TEST_ASSERT_EQUAL_PTR(c1, routes->contacts[2]);
+	cgr_route_list_free(routes);
+}
+
+TEST(cgr, arrival_time_includes_scheduled_bundles)
+{
+	struct contact *c = createct(10000, 20000, 100);
+
+	TEST_ASSERT_EQUAL_UINT64(11000, cgr_get_arrival_time_ms(c, 100, 0));
+	TEST_ASSERT_EQUAL_UINT64(12500,
+				 cgr_get_arrival_time_ms(c, 100, 11500));
+	c->remaining_capacity_p0 -= 200;
+	TEST_ASSERT_EQUAL_UINT64(13000, cgr_get_arrival_time_ms(c, 100, 0));
+}
+
+TEST(cgr, find_route_with_earliest_arrival)
+{
+	struct contact *slow = createct(5000, 1000000, 1);
+	struct contact *fast = createct(10000, 20000, 100);
+	struct contact *large = createct(50000, 70000, 1000);
+	struct cgr_route route;
+
+	add_contact_to_ordered_list(&contacts, slow, 0);
+	add_contact_to_ordered_list(&contacts, fast, 0);
+	add_contact_to_ordered_list(&contacts, large, 0);
+
+	struct cgr_route_list *routes = cgr_route_list_create(contacts);
+
+	TEST_ASSERT_TRUE(cgr_find_route(routes, 100, BUNDLE_RPRIO_NORMAL,
+					0, UINT64_MAX, &route));
+	TEST_ASSERT_EQUAL_PTR(fast, route.contact);
+	TEST_ASSERT_EQUAL_UINT64(11000, route.arrival_time_ms);
+
+	// Exceeds the capacity of the first two contacts
+	TEST_ASSERT_TRUE(cgr_find_route(routes, 2000, BUNDLE_RPRIO_NORMAL,
+					0, UINT64_MAX, &route));
+	TEST_ASSERT_EQUAL_PTR(large, route.contact);
+	TEST_ASSERT_EQUAL_UINT64(52000, route.arrival_time_ms);
+
+	// Cannot be delivered before the deadline
+	TEST_ASSERT_FALSE(cgr_find_route(routes, 2000, BUNDLE_RPRIO_NORMAL,
+					 0, 51000, &route));
+	TEST_ASSERT_NULL(route.contact);
+
+	// Only the slow contact can be used before the deadline
+	TEST_ASSERT_FALSE(cgr_find_route(routes, 100, BUNDLE_RPRIO_NORMAL,
+					 0, 9000, &route));
+	TEST_ASSERT_TRUE(cgr_find_route(routes, 2, BUNDLE_RPRIO_NORMAL,
+					0, 9000, &route));
+	TEST_ASSERT_EQUAL_PTR(slow, route.contact);
+
+	cgr_route_list_free(routes);
+}
+
+TEST(cgr, find_route_skips_exhausted_contacts)
+{
+	struct contact *passed = createct(1000, 2000, 100);
+	struct contact *full = createct(3000, 4000, 100);
+	struct contact *free_ct = createct(5000, 6000, 100);
+	struct cgr_route route;
+	size_t first = 0;
+
+	add_contact_to_ordered_list(&contacts, passed, 0);
+	add_contact_to_ordered_list(&contacts, full, 0);
+	add_contact_to_ordered_list(&contacts, free_ct, 0);
+	full->remaining_capacity_p0 = 0;
+	full->remaining_capacity_p1 = 0;
+
+	struct cgr_route_list *routes = cgr_route_list_create(contacts);
+
+	TEST_ASSERT_TRUE(cgr_find_route_from(routes, &first, 10,
+					     BUNDLE_RPRIO_NORMAL, 2500,
+					     UINT64_MAX, &route));
+	TEST_ASSERT_EQUAL_PTR(free_ct, route.contact);
+	TEST_ASSERT_EQUAL(2, first);
+
+	// Capacity left for high priority: the contact is not skipped.
+	first = 0;
+	TEST_ASSERT_TRUE(cgr_find_route_from(routes, &first, 10,
+					     BUNDLE_RPRIO_HIGH, 2500,
+					     UINT64_MAX, &route));
+	TEST_ASSERT_EQUAL_PTR(free_ct, route.contact);
+	TEST_ASSERT_EQUAL(1, route.preemption_improved);
+	TEST_ASSERT_EQUAL(1, first);
+
+	cgr_route_list_free(routes);
+}
+
+TEST(cgr, routes_invalidated_on_change)
+{
+	uint32_t generation;
+
+	struct node_table_entry *entry;
+	const struct cgr_route_list *routes;
+
+	routing_table_init();
+	createct(10000, 20000, 100);
+	TEST_ASSERT_TRUE(routing_table_add_node(node, rescheduler));
+	node = NULL;
+
+	entry = routing_table_lookup_eid("dtn://a/");
+	TEST_ASSERT_NOT_NULL(entry);
+	routes = routing_table_get_routes(entry);
+	TEST_ASSERT_NOT_NULL(routes);
+	TEST_ASSERT_EQUAL(1, routes->count);
+	TEST_ASSERT_EQUAL_PTR(routes, routing_table_get_routes(entry));
+	generation = routing_table_get_generation();
+
+	node = node_create("dtn://a/");
+	node->cla_addr = strdup("");
+	createct(5000, 8000, 100);
+	TEST_ASSERT_TRUE(routing_table_add_node(node, rescheduler));
+	node = NULL;
+
+	TEST_ASSERT_NULL(entry->routes);
+	TEST_ASSERT_TRUE(routing_table_get_generation() != generation);
+	routes = routing_table_get_routes(entry);
+	TEST_ASSERT_EQUAL(2, routes->count);
+	TEST_ASSERT_EQUAL_UINT64(5000, routes->contacts[0]->from);
+
+	routing_table_free();
+}
+
+TEST_GROUP_RUNNER(cgr)
+{
+	RUN_TEST_CASE(cgr, route_list_is_sorted_by_start);
+	RUN_TEST_CASE(cgr, arrival_time_includes_scheduled_bundles);
+	RUN_TEST_CASE(cgr, find_route_with_earliest_arrival);
+	RUN_TEST_CASE(cgr, find_route_skips_exhausted_contacts);
+	RUN_TEST_CASE(cgr, routes_invalidated_on_change);
+}
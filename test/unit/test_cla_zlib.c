@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#include "cla/posix/cla_zlib.h"
+
+#include "ud3tn/common.h"
+#include "ud3tn/result.h"
+
+#include "unity_fixture.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PAYLOAD_SIZE ((size_t)64 * 1024)
+#define COMPRESSED_BUFFER_SIZE (PAYLOAD_SIZE + 1024)
+// Sizes of the chunks received from the socket and read by the RX task
+#define RECEIVE_CHUNK_SIZE ((size_t)16)
+#define READ_CHUNK_SIZE ((size_t)64)
+
+static struct cla_zlib_stream *compressor, *decompressor;
+static uint8_t *payload, *compressed, *decompressed;
+
+TEST_GROUP(cla_zlib);
+
+TEST_SETUP(cla_zlib)
+{
+	compressor = cla_zlib_create(true, 6);
+	decompressor = cla_zlib_create(false, 0);
+	payload = malloc(PAYLOAD_SIZE);
+	compressed = malloc(COMPRESSED_BUFFER_SIZE);
+	decompressed = malloc(PAYLOAD_SIZE);
+}
+
+TEST_TEAR_DOWN(cla_zlib)
+{
+	cla_zlib_free(compressor);
+	cla_zlib_free(decompressor);
+	free(payload);
+	free(compressed);
+	free(decompressed);
+}
+
+// Reads the stream like tcpclv3_read(): zlib is asked for output before
+// further compressed data is received.
+TEST(cla_zlib, round_trip_in_small_chunks)
+{
+	const uint8_t *in = payload;
+	size_t in_length = PAYLOAD_SIZE;
+	uint8_t *out = compressed;
+	size_t out_length = COMPRESSED_BUFFER_SIZE;
+	size_t i, received = 0, read = 0, held_back = 0;
+
+	if (!cla_zlib_available())
+		return;
+	TEST_ASSERT_NOT_NULL(compressor);
+	TEST_ASSERT_NOT_NULL(decompressor);
+
+	// Long repetitions lead to matches spanning multiple read chunks.
+	for (i = 0; i < PAYLOAD_SIZE; i++)
+		payload[i] = (uint8_t)(i % 1000 < 500 ? 'a' : i % 251);
+	TEST_ASSERT_EQUAL(UD3TN_OK, cla_zlib_process(
+		compressor, &in, &in_length, &out, &out_length, true
+	));
+	TEST_ASSERT_EQUAL(0, in_length);
+
+	const size_t compressed_length = COMPRESSED_BUFFER_SIZE - out_length;
+
+	in_length = 0;
+	while (read < PAYLOAD_SIZE) {
+		const bool input_consumed = in_length == 0;
+		size_t chunk = MIN(READ_CHUNK_SIZE, PAYLOAD_SIZE - read);
+
+		out = &decompressed[read];
+		TEST_ASSERT_EQUAL(UD3TN_OK, cla_zlib_process(
+			decompressor, &in, &in_length, &out, &chunk, false
+		));
+
+		const size_t produced = out - &decompressed[read];
+
+		read += produced;
+		if (produced && input_consumed)
+			held_back++;
+		if (produced || in_length)
+			continue;
+
+		// Only receive more data if zlib could not produce any output.
+		TEST_ASSERT_TRUE(received < compressed_length);
+		in = &compressed[received];
+		in_length = MIN(RECEIVE_CHUNK_SIZE,
+				compressed_length - received);
+		received += in_length;
+	}
+
+	TEST_ASSERT_EQUAL_MEMORY(payload, decompressed, PAYLOAD_SIZE);
+	// Without reading the output held back by zlib, the reader would have
+	// waited for data the sender never sends.
+	TEST_ASSERT_TRUE(held_back > 0);
+}
+
+TEST_GROUP_RUNNER(cla_zlib)
+{
+	RUN_TEST_CASE(cla_zlib, round_trip_in_small_chunks);
+}
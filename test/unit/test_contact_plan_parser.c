@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#include "agents/contact_plan_parser.h"
+
+#include "ud3tn/node.h"
+#include "ud3tn/router.h"
+
+#include "platform/hal_time.h"
+
+#include "unity_fixture.h"
+
+#include "cbor.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PLAN_BUFFER_SIZE 256
+
+static uint8_t plan[PLAN_BUFFER_SIZE];
+static struct router_command *cmd;
+
+TEST_GROUP(contact_plan_parser);
+
+TEST_SETUP(contact_plan_parser)
+{
+	hal_time_init(0);
+	cmd = NULL;
+}
+
+TEST_TEAR_DOWN(contact_plan_parser)
+{
+	size_t i;
+
+	if (cmd == NULL)
+		return;
+	for (i = 0; i < cmd->node_count; i++)
+		free_node(cmd->nodes[i]);
+	free(cmd->nodes);
+	free(cmd);
+}
+
+// [["dtn://a/", "tcpclv3:a", ["dtn://b/"], [[1000, 2000, 100, ["dtn://c/"]]]],
+//  ["dtn://d/", null, [], []]]
+static size_t encode_plan(const uint64_t contact_end)
+{
+	CborEncoder encoder, nodes, node, list, contact, eids;
+
+	cbor_encoder_init(&encoder, plan, PLAN_BUFFER_SIZE, 0);
+	cbor_encoder_create_array(&encoder, &nodes, 2);
+
+	cbor_encoder_create_array(&nodes, &node, 4);
+	cbor_encode_text_stringz(&node, "dtn://a/");
+	cbor_encode_text_stringz(&node, "tcpclv3:a");
+	cbor_encoder_create_array(&node, &list, 1);
+	cbor_encode_text_stringz(&list, "dtn://b/");
+	cbor_encoder_close_container(&node, &list);
+	cbor_encoder_create_array(&node, &list, 1);
+	cbor_encoder_create_array(&list, &contact, 4);
+	cbor_encode_uint(&contact, 1000);
+	cbor_encode_uint(&contact, contact_end);
+	cbor_encode_uint(&contact, 100);
+	cbor_encoder_create_array(&contact, &eids, 1);
+	cbor_encode_text_stringz(&eids, "dtn://c/");
+	cbor_encoder_close_container(&contact, &eids);
+	cbor_encoder_close_container(&list, &contact);
+	cbor_encoder_close_container(&node, &list);
+	cbor_encoder_close_container(&nodes, &node);
+
+	cbor_encoder_create_array(&nodes, &node, 4);
+	cbor_encode_text_stringz(&node, "dtn://d/");
+	cbor_encode_null(&node);
+	cbor_encoder_create_array(&node, &list, 0);
+	cbor_encoder_close_container(&node, &list);
+	cbor_encoder_create_array(&node, &list, 0);
+	cbor_encoder_close_container(&node, &list);
+	cbor_encoder_close_container(&nodes, &node);
+
+	cbor_encoder_close_container(&encoder, &nodes);
+	return cbor_encoder_get_buffer_size(&encoder, plan);
+}
+
+TEST(contact_plan_parser, detect_bulk_format)
+{
+	const uint8_t text[] = "1(dtn://a/):(tcpclv3:a);";
+
+	TEST_ASSERT_FALSE(contact_plan_is_bulk(text, sizeof(text) - 1));
+	TEST_ASSERT_FALSE(contact_plan_is_bulk(plan, 0));
+	TEST_ASSERT_TRUE(contact_plan_is_bulk(plan, encode_plan(2000)));
+}
+
+TEST(contact_plan_parser, parse_plan)
+{
+	struct contact *c;
+
+	cmd = contact_plan_parse(plan, encode_plan(2000));
+	TEST_ASSERT_NOT_NULL(cmd);
+	TEST_ASSERT_EQUAL(ROUTER_COMMAND_ADD_BULK, cmd->type);
+	TEST_ASSERT_NULL(cmd->data);
+	TEST_ASSERT_EQUAL(2, cmd->node_count);
+
+	TEST_ASSERT_EQUAL_STRING("dtn://a/", cmd->nodes[0]->eid);
+	TEST_ASSERT_EQUAL_STRING("tcpclv3:a", cmd->nodes[0]->cla_addr);
+	TEST_ASSERT_NOT_NULL(cmd->nodes[0]->endpoints);
+	TEST_ASSERT_EQUAL_STRING("dtn://b/", cmd->nodes[0]->endpoints->eid);
+	TEST_ASSERT_NULL(cmd->nodes[0]->endpoints->next);
+	TEST_ASSERT_NOT_NULL(cmd->nodes[0]->contacts);
+	TEST_ASSERT_NULL(cmd->nodes[0]->contacts->next);
+	c = cmd->nodes[0]->contacts->data;
+	TEST_ASSERT_EQUAL_PTR(cmd->nodes[0], c->node);
+	TEST_ASSERT_EQUAL_UINT64(1000, c->from);
+	TEST_ASSERT_EQUAL_UINT64(2000, c->to);
+	TEST_ASSERT_EQUAL_UINT64(100, c->bitrate);
+	TEST_ASSERT_NOT_NULL(c->contact_endpoints);
+	TEST_ASSERT_EQUAL_STRING("dtn://c/", c->contact_endpoints->eid);
+
+	TEST_ASSERT_EQUAL_STRING("dtn://d/", cmd->nodes[1]->eid);
+	TEST_ASSERT_NULL(cmd->nodes[1]->cla_addr);
+	TEST_ASSERT_NULL(cmd->nodes[1]->endpoints);
+	TEST_ASSERT_NULL(cmd->nodes[1]->contacts);
+}
+
+TEST(contact_plan_parser, reject_invalid_plans)
+{
+	const uint8_t indefinite[] = { 0x9F, 0xFF };
+	size_t length;
+
+	// The contact ends before it starts.
+	TEST_ASSERT_NULL(contact_plan_parse(plan, encode_plan(500)));
+
+	length = encode_plan(2000);
+	TEST_ASSERT_NULL(contact_plan_parse(plan, length - 1));
+	plan[length] = 0x00;
+	TEST_ASSERT_NULL(contact_plan_parse(plan, length + 1));
+	// The node array has to be allocated upfront.
+	TEST_ASSERT_NULL(contact_plan_parse(indefinite, sizeof(indefinite)));
+}
+
+TEST_GROUP_RUNNER(contact_plan_parser)
+{
+	RUN_TEST_CASE(contact_plan_parser, detect_bulk_format);
+	RUN_TEST_CASE(contact_plan_parser, parse_plan);
+	RUN_TEST_CASE(contact_plan_parser, reject_invalid_plans);
+}
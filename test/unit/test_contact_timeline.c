@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#include "ud3tn/contact_timeline.h"
+#include "ud3tn/node.h"
+
+#include "unity_fixture.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+TEST_GROUP(contact_timeline);
+
+#define CONTACT_COUNT 64
+
+static struct contact_timeline timeline;
+static struct contact *contacts[CONTACT_COUNT];
+
+TEST_SETUP(contact_timeline)
+{
+	int i;
+
+	contact_timeline_init(&timeline);
+	// Insert in an order which is neither ascending nor descending
+	for (i = 0; i < CONTACT_COUNT; i++) {
+		contacts[i] = contact_create(NULL);
+		contacts[i]->from = (i * 37) % CONTACT_COUNT * 10;
+		contacts[i]->to = contacts[i]->from + 5 + i % 3;
+		contact_timeline_insert(&timeline, contacts[i]);
+	}
+}
+
+TEST_TEAR_DOWN(contact_timeline)
+{
+	int i;
+
+	for (i = 0; i < CONTACT_COUNT; i++) {
+		contact_timeline_remove(&timeline, contacts[i]);
+		free_contact(contacts[i]);
+	}
+	TEST_ASSERT_EQUAL(0, timeline.count);
+	TEST_ASSERT_NULL(timeline.starts);
+	TEST_ASSERT_NULL(timeline.ends);
+	TEST_ASSERT_NULL(timeline.changed);
+}
+
+TEST(contact_timeline, ordered_iteration)
+{
+	struct contact *c;
+	uint64_t last = 0;
+	int count = 0;
+
+	TEST_ASSERT_EQUAL(CONTACT_COUNT, timeline.count);
+	for (c = contact_timeline_first_start(&timeline); c != NULL;
+	     c = contact_timeline_next_start(&timeline, c)) {
+		TEST_ASSERT_TRUE(c->from >= last);
+		last = c->from;
+		count++;
+	}
+	TEST_ASSERT_EQUAL(CONTACT_COUNT, count);
+
+	last = 0;
+	count = 0;
+	for (c = contact_timeline_first_end(&timeline); c != NULL;
+	     c = contact_timeline_next_end(&timeline, c)) {
+		TEST_ASSERT_TRUE(c->to >= last);
+		last = c->to;
+		count++;
+	}
+	TEST_ASSERT_EQUAL(CONTACT_COUNT, count);
+}
+
+TEST(contact_timeline, next_event)
+{
+	TEST_ASSERT_EQUAL_UINT64(5, contact_timeline_next_event(&timeline, 0));
+	TEST_ASSERT_EQUAL_UINT64(10, contact_timeline_next_event(&timeline, 5));
+	TEST_ASSERT_EQUAL_UINT64(
+		UINT64_MAX,
+		contact_timeline_next_event(&timeline, 10000)
+	);
+}
+
+TEST(contact_timeline, update_and_remove)
+{
+	struct contact *first = contact_timeline_first_start(&timeline);
+
+	TEST_ASSERT_EQUAL_UINT64(0, first->from);
+	first->from = 1000;
+	first->to = 1001;
+	contact_timeline_insert(&timeline, first);
+	TEST_ASSERT_EQUAL(CONTACT_COUNT, timeline.count);
+	TEST_ASSERT_EQUAL_UINT64(
+		10,
+		contact_timeline_first_start(&timeline)->from
+	);
+	TEST_ASSERT_EQUAL_UINT64(
+		1001,
+		contact_timeline_next_event(&timeline, 1000)
+	);
+
+	contact_timeline_remove(&timeline, first);
+	TEST_ASSERT_FALSE(contact_timeline_contains(first));
+	TEST_ASSERT_EQUAL(CONTACT_COUNT - 1, timeline.count);
+	TEST_ASSERT_EQUAL_UINT64(
+		UINT64_MAX,
+		contact_timeline_next_event(&timeline, 1000)
+	);
+	// Removing it again is a no-op
+	contact_timeline_remove(&timeline, first);
+	TEST_ASSERT_EQUAL(CONTACT_COUNT - 1, timeline.count);
+}
+
+TEST(contact_timeline, separate_index)
+{
+	struct contact_timeline_entry entries[CONTACT_COUNT];
+	struct contact_timeline_entry *root = NULL, *e;
+	int i, count = 0;
+
+	// Index all contacts by their end, like the contact manager does.
+	for (i = 0; i < CONTACT_COUNT; i++) {
+		entries[i].contact = contacts[i];
+		entries[i].time = contacts[i]->to;
+		contact_index_insert(&root, &entries[i]);
+	}
+	TEST_ASSERT_EQUAL_PTR(
+		&entries[0],
+		contact_index_find(root, contacts[0]->to, contacts[0])
+	);
+	TEST_ASSERT_NULL(contact_index_find(root, 0, contacts[1]));
+
+	// Removing half of the entries does not affect the timeline.
+	for (i = 0; i < CONTACT_COUNT; i += 2)
+		contact_index_remove(&root, &entries[i]);
+	for (e = contact_index_first(root); e != NULL;
+	     e = contact_index_next(root, e)) {
+		TEST_ASSERT_TRUE(e->contact->to == e->time);
+		TEST_ASSERT_TRUE((e - entries) % 2 == 1);
+		count++;
+	}
+	TEST_ASSERT_EQUAL(CONTACT_COUNT / 2, count);
+	TEST_ASSERT_EQUAL(CONTACT_COUNT, timeline.count);
+}
+
+TEST(contact_timeline, processed_and_changed)
+{
+	struct contact *c = contact_timeline_first_start_from(&timeline, 15);
+
+	TEST_ASSERT_EQUAL_UINT64(20, c->from);
+	TEST_ASSERT_EQUAL_UINT64(
+		20,
+		contact_timeline_first_start_from(&timeline, 20)->from
+	);
+	TEST_ASSERT_EQUAL_UINT64(
+		0,
+		contact_timeline_first_start_from(&timeline, 0)->from
+	);
+	TEST_ASSERT_NULL(contact_timeline_first_start_from(&timeline, 1000));
+	TEST_ASSERT_NULL(contact_timeline_pop_changed(&timeline));
+
+	// Contacts re-inserted after their start has been processed are
+	// reported as changed, later ones are found via the start index.
+	contact_timeline_set_processed(&timeline, 100);
+	c->to = 30;
+	contact_timeline_insert(&timeline, c);
+	contacts[0]->active = 1;
+	contacts[0]->to = 2000;
+	contact_timeline_insert(&timeline, contacts[0]);
+	contacts[0]->active = 0;
+	c = contact_timeline_first_start_from(&timeline, 100);
+	TEST_ASSERT_EQUAL_UINT64(100, c->from);
+	c->from = 95;
+	contact_timeline_insert(&timeline, c);
+	TEST_ASSERT_EQUAL_UINT64(
+		110,
+		contact_timeline_first_start_from(&timeline, 100)->from
+	);
+
+	TEST_ASSERT_NOT_NULL(contact_timeline_pop_changed(&timeline));
+	TEST_ASSERT_NOT_NULL(contact_timeline_pop_changed(&timeline));
+	TEST_ASSERT_NOT_NULL(contact_timeline_pop_changed(&timeline));
+	TEST_ASSERT_NULL(contact_timeline_pop_changed(&timeline));
+
+	// Removing a contact also drops it from the set of changed contacts.
+	contact_timeline_insert(&timeline, c);
+	contact_timeline_remove(&timeline, c);
+	TEST_ASSERT_NULL(contact_timeline_pop_changed(&timeline));
+}
+
+TEST_GROUP_RUNNER(contact_timeline)
+{
+	RUN_TEST_CASE(contact_timeline, ordered_iteration);
+	RUN_TEST_CASE(contact_timeline, next_event);
+	RUN_TEST_CASE(contact_timeline, update_and_remove);
+	RUN_TEST_CASE(contact_timeline, separate_index);
+	RUN_TEST_CASE(contact_timeline, processed_and_changed);
+}
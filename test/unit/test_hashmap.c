@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#include "ud3tn/hashmap.h"
+#include "ud3tn/result.h"
+
+#include "unity_fixture.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+TEST_GROUP(hashmap);
+
+#define KEY_COUNT 1000
+
+static struct hashmap map;
+static char keys[KEY_COUNT][24];
+
+TEST_SETUP(hashmap)
+{
+	int i;
+
+	for (i = 0; i < KEY_COUNT; i++)
+		snprintf(keys[i], sizeof(keys[i]), "dtn://node%d/", i);
+}
+
+TEST_TEAR_DOWN(hashmap)
+{
+	hashmap_free(&map);
+}
+
+TEST(hashmap, add_get_remove)
+{
+	char key[] = "test";
+
+	TEST_ASSERT_EQUAL(UD3TN_OK, hashmap_init(&map, 16, false));
+	TEST_ASSERT_NULL(hashmap_get(&map, "test"));
+	TEST_ASSERT_EQUAL(UD3TN_OK, hashmap_add(&map, key, keys[0]));
+	TEST_ASSERT_EQUAL(UD3TN_FAIL, hashmap_add(&map, "test", keys[1]));
+	// The key has been copied.
+	key[0] = 'b';
+	TEST_ASSERT_EQUAL_PTR(keys[0], hashmap_get(&map, "test"));
+	TEST_ASSERT_NULL(hashmap_get(&map, key));
+	TEST_ASSERT_EQUAL(1, hashmap_count(&map));
+	TEST_ASSERT_EQUAL_PTR(keys[0], hashmap_remove(&map, "test"));
+	TEST_ASSERT_NULL(hashmap_remove(&map, "test"));
+	TEST_ASSERT_EQUAL(0, hashmap_count(&map));
+}
+
+TEST(hashmap, grow_incrementally)
+{
+	int i;
+
+	TEST_ASSERT_EQUAL(UD3TN_OK, hashmap_init(&map, 1, false));
+	for (i = 0; i < KEY_COUNT; i++) {
+		TEST_ASSERT_EQUAL(
+			UD3TN_OK,
+			hashmap_add(&map, keys[i], (void *)(uintptr_t)(i + 1))
+		);
+		// Every entry stays reachable while a resize is in progress.
+		TEST_ASSERT_EQUAL_PTR(
+			(void *)(uintptr_t)(i / 2 + 1),
+			hashmap_get(&map, keys[i / 2])
+		);
+	}
+	TEST_ASSERT_EQUAL(KEY_COUNT, hashmap_count(&map));
+	for (i = 0; i < KEY_COUNT; i += 2)
+		TEST_ASSERT_NOT_NULL(hashmap_remove(&map, keys[i]));
+	TEST_ASSERT_EQUAL(KEY_COUNT / 2, hashmap_count(&map));
+	for (i = 0; i < KEY_COUNT; i++) {
+		if (i % 2 == 0) {
+			TEST_ASSERT_NULL(hashmap_get(&map, keys[i]));
+		} else {
+			TEST_ASSERT_EQUAL_PTR((void *)(uintptr_t)(i + 1),
+					      hashmap_get(&map, keys[i]));
+		}
+	}
+}
+
+TEST(hashmap, reuse_deleted_slots)
+{
+	int i, j;
+
+	TEST_ASSERT_EQUAL(UD3TN_OK, hashmap_init(&map, 32, true));
+	// Churn through many more keys than the map can hold at once.
+	for (j = 0; j < KEY_COUNT; j += 16) {
+		for (i = j; i < j + 16 && i < KEY_COUNT; i++)
+			TEST_ASSERT_EQUAL(UD3TN_OK,
+					  hashmap_add(&map, keys[i], keys[i]));
+		for (i = j; i < j + 16 && i < KEY_COUNT; i++)
+			TEST_ASSERT_EQUAL_PTR(keys[i],
+					      hashmap_remove(&map, keys[i]));
+	}
+	TEST_ASSERT_EQUAL(0, hashmap_count(&map));
+	TEST_ASSERT_TRUE(map.table.group_count <= 4);
+}
+
+TEST(hashmap, borrowed_keys)
+{
+	size_t iter = 0;
+	const char *key;
+
+	TEST_ASSERT_EQUAL(UD3TN_OK, hashmap_init(&map, 4, true));
+	TEST_ASSERT_EQUAL(UD3TN_OK, hashmap_add(&map, keys[0], keys[1]));
+	TEST_ASSERT_EQUAL_PTR(keys[1], hashmap_get(&map, "dtn://node0/"));
+	// The map references the key of the caller instead of a copy.
+	TEST_ASSERT_TRUE(hashmap_iterate(&map, &iter, &key, NULL));
+	TEST_ASSERT_EQUAL_PTR(keys[0], key);
+	TEST_ASSERT_EQUAL_PTR(keys[1], hashmap_remove(&map, keys[0]));
+}
+
+TEST(hashmap, iterate_and_clear)
+{
+	size_t iter = 0;
+	const char *key;
+	void *value;
+	int i, count = 0;
+
+	TEST_ASSERT_EQUAL(UD3TN_OK, hashmap_init(&map, 8, true));
+	for (i = 0; i < 100; i++)
+		TEST_ASSERT_EQUAL(UD3TN_OK,
+				  hashmap_add(&map, keys[i], keys[i]));
+	while (hashmap_iterate(&map, &iter, &key, &value)) {
+		TEST_ASSERT_EQUAL_PTR(key, value);
+		count++;
+	}
+	TEST_ASSERT_EQUAL(100, count);
+
+	hashmap_clear(&map);
+	TEST_ASSERT_EQUAL(0, hashmap_count(&map));
+	TEST_ASSERT_NULL(hashmap_get(&map, keys[0]));
+	iter = 0;
+	TEST_ASSERT_FALSE(hashmap_iterate(&map, &iter, &key, &value));
+}
+
+TEST_GROUP_RUNNER(hashmap)
+{
+	RUN_TEST_CASE(hashmap, add_get_remove);
+	RUN_TEST_CASE(hashmap, grow_incrementally);
+	RUN_TEST_CASE(hashmap, reuse_deleted_slots);
+	RUN_TEST_CASE(hashmap, borrowed_keys);
+	RUN_TEST_CASE(hashmap, iterate_and_clear);
+}
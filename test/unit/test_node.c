@@ -54,13 +54,14 @@ TEST_SETUP(node)
 	some_eids2 = endpoint_list_strip_and_sort(some_eids2);
 	/* contacts */
 	some_ct1 = malloc(sizeof(struct contact_list));
-	some_ct1->data = createct(1, 3, 300, "ipn:1.0");
+	some_ct1->data = createct(1000, 3000, 300, "ipn:1.0");
 	some_ct1->next = malloc(sizeof(struct contact_list));
-	some_ct1->next->data = createct(0x100000000, 0x100000001, 500,
+	some_ct1->next->data = createct(0x100000000000, 0x1000000003E8, 500,
 					"ipn:1.0");
 	some_ct1->next->next = NULL;
 	some_ct2 = malloc(sizeof(struct contact_list));
-	some_ct2->data = createct(0x100000000, 0x100000001, 600, "ipn:1.0");
+	some_ct2->data = createct(0x100000000000, 0x1000000003E8, 600,
+				  "ipn:1.0");
 	some_ct2->next = NULL;
 	/* time */
 	hal_time_init(0);
@@ -81,25 +82,62 @@ TEST_TEAR_DOWN(node)
 TEST(node, contact)
 {
 	/* capacity */
-	TEST_ASSERT_EQUAL_UINT32(500, some_ct1->next->data->total_capacity);
-	TEST_ASSERT_EQUAL_INT32(500,
+	TEST_ASSERT_EQUAL_UINT64(500, some_ct1->next->data->total_capacity);
+	TEST_ASSERT_EQUAL_INT64(500,
 		some_ct1->next->data->remaining_capacity_p0);
 	/* re-calculation accuracy */
 	recalculate_contact_capacity(some_ct1->next->data);
 	recalculate_contact_capacity(some_ct1->next->data);
-	TEST_ASSERT_EQUAL_UINT32(500, some_ct1->next->data->total_capacity);
-	TEST_ASSERT_EQUAL_INT32(500,
+	TEST_ASSERT_EQUAL_UINT64(500, some_ct1->next->data->total_capacity);
+	TEST_ASSERT_EQUAL_INT64(500,
 		some_ct1->next->data->remaining_capacity_p0);
 	/* remaining cap */
 	hal_time_init(0);
-	TEST_ASSERT_EQUAL_INT32(600,
+	TEST_ASSERT_EQUAL_INT64(600,
 		contact_get_cur_remaining_capacity(some_ct1->data, 0));
 	hal_time_init(2);
-	TEST_ASSERT_EQUAL_INT32(300,
+	TEST_ASSERT_EQUAL_INT64(300,
 		contact_get_cur_remaining_capacity(some_ct1->data, 0));
 	hal_time_init(3);
-	TEST_ASSERT_EQUAL_INT32(0,
+	TEST_ASSERT_EQUAL_INT64(0,
 		contact_get_cur_remaining_capacity(some_ct1->data, 0));
+	/* millisecond precision */
+	some_ct1->data->to = 1250;
+	recalculate_contact_capacity(some_ct1->data);
+	TEST_ASSERT_EQUAL_UINT64(75, some_ct1->data->total_capacity);
+	TEST_ASSERT_EQUAL_INT64(75, some_ct1->data->remaining_capacity_p0);
+}
+
+TEST(node, large_contact_capacity)
+{
+	/* 100 MB/s over a day are accounted for exactly, not as "infinite" */
+	struct contact *c = contact_create(NULL);
+
+	c->from = 0;
+	c->to = 86400000;
+	c->bitrate = 100000000;
+	recalculate_contact_capacity(c);
+	TEST_ASSERT_EQUAL_UINT64(8640000000000, c->total_capacity);
+	TEST_ASSERT_EQUAL_INT64(8640000000000, c->remaining_capacity_p0);
+	c->remaining_capacity_p0 -= 5000000000;
+	hal_time_init(0);
+	TEST_ASSERT_EQUAL_INT64(8635000000000,
+		contact_get_cur_remaining_capacity(c, 0));
+	hal_time_init(43200);
+	TEST_ASSERT_EQUAL_INT64(4320000000000,
+		contact_get_cur_remaining_capacity(c, 0));
+	/* Extending the contact keeps the consumed capacity */
+	c->to = 2 * 86400000;
+	recalculate_contact_capacity(c);
+	TEST_ASSERT_EQUAL_INT64(17275000000000, c->remaining_capacity_p0);
+	/* Only an overflow leads to an infinite capacity */
+	c->bitrate = UINT64_MAX / 1000;
+	recalculate_contact_capacity(c);
+	TEST_ASSERT_EQUAL_INT64(CONTACT_CAPACITY_INFINITE,
+		c->remaining_capacity_p0);
+	TEST_ASSERT_EQUAL_INT64(CONTACT_CAPACITY_INFINITE,
+		contact_get_cur_remaining_capacity(c, 0));
+	free_contact(c);
 }
 
 static void assert_in_eidlist(char *eid, struct endpoint_list *l)
@@ -145,17 +183,17 @@ TEST(node, contact_list_union)
 	TEST_ASSERT_NOT_NULL(some_ct1);
 	TEST_ASSERT_NOT_NULL(some_ct1->next);
 	TEST_ASSERT_NULL(some_ct1->next->next);
-	TEST_ASSERT_EQUAL_UINT64(1, some_ct1->data->from);
-	TEST_ASSERT_EQUAL_UINT64(3, some_ct1->data->to);
+	TEST_ASSERT_EQUAL_UINT64(1000, some_ct1->data->from);
+	TEST_ASSERT_EQUAL_UINT64(3000, some_ct1->data->to);
 	TEST_ASSERT_EQUAL_UINT16(300, some_ct1->data->bitrate);
-	TEST_ASSERT_EQUAL_UINT32(600, some_ct1->data->total_capacity);
-	TEST_ASSERT_EQUAL_INT32(
+	TEST_ASSERT_EQUAL_UINT64(600, some_ct1->data->total_capacity);
+	TEST_ASSERT_EQUAL_INT64(
 		600, some_ct1->data->remaining_capacity_p0);
-	TEST_ASSERT_EQUAL_HEX64(0x100000000, some_ct1->next->data->from);
-	TEST_ASSERT_EQUAL_HEX64(0x100000001, some_ct1->next->data->to);
+	TEST_ASSERT_EQUAL_HEX64(0x100000000000, some_ct1->next->data->from);
+	TEST_ASSERT_EQUAL_HEX64(0x1000000003E8, some_ct1->next->data->to);
 	TEST_ASSERT_EQUAL_UINT16(600, some_ct1->next->data->bitrate);
-	TEST_ASSERT_EQUAL_UINT32(600, some_ct1->next->data->total_capacity);
-	TEST_ASSERT_EQUAL_INT32(600,
+	TEST_ASSERT_EQUAL_UINT64(600, some_ct1->next->data->total_capacity);
+	TEST_ASSERT_EQUAL_INT64(600,
 		some_ct1->next->data->remaining_capacity_p0);
 	TEST_ASSERT_NOT_NULL(mod);
 	TEST_ASSERT_NULL(mod->next);
@@ -172,19 +210,19 @@ TEST(node, contact_list_difference)
 	some_ct2 = NULL;
 	TEST_ASSERT_NOT_NULL(some_ct1);
 	TEST_ASSERT_NULL(some_ct1->next);
-	TEST_ASSERT_EQUAL_UINT64(1, some_ct1->data->from);
-	TEST_ASSERT_EQUAL_UINT64(3, some_ct1->data->to);
+	TEST_ASSERT_EQUAL_UINT64(1000, some_ct1->data->from);
+	TEST_ASSERT_EQUAL_UINT64(3000, some_ct1->data->to);
 	TEST_ASSERT_EQUAL_UINT16(300, some_ct1->data->bitrate);
-	TEST_ASSERT_EQUAL_UINT32(600, some_ct1->data->total_capacity);
-	TEST_ASSERT_EQUAL_INT32(600, some_ct1->data->remaining_capacity_p0);
+	TEST_ASSERT_EQUAL_UINT64(600, some_ct1->data->total_capacity);
+	TEST_ASSERT_EQUAL_INT64(600, some_ct1->data->remaining_capacity_p0);
 	TEST_ASSERT_NULL(mod);
 	TEST_ASSERT_NOT_NULL(del);
 	TEST_ASSERT_NULL(del->next);
-	TEST_ASSERT_EQUAL_HEX64(0x100000000, del->data->from);
-	TEST_ASSERT_EQUAL_HEX64(0x100000001, del->data->to);
+	TEST_ASSERT_EQUAL_HEX64(0x100000000000, del->data->from);
+	TEST_ASSERT_EQUAL_HEX64(0x1000000003E8, del->data->to);
 	TEST_ASSERT_EQUAL_UINT16(500, del->data->bitrate);
-	TEST_ASSERT_EQUAL_UINT32(500, del->data->total_capacity);
-	TEST_ASSERT_EQUAL_INT32(500, del->data->remaining_capacity_p0);
+	TEST_ASSERT_EQUAL_UINT64(500, del->data->total_capacity);
+	TEST_ASSERT_EQUAL_INT64(500, del->data->remaining_capacity_p0);
 	del = contact_list_free(del);
 	TEST_ASSERT_NULL(del);
 }
@@ -233,12 +271,83 @@ TEST(node, add_contact_to_ordered_list)
 	free_contact(c3);
 }
 
+TEST(node, contact_bundle_queue)
+{
+	static const enum bundle_routing_priority prio[] = {
+		BUNDLE_RPRIO_LOW,
+		BUNDLE_RPRIO_HIGH,
+		BUNDLE_RPRIO_LOW,
+		BUNDLE_RPRIO_NORMAL,
+	};
+	struct contact *c = contact_create(NULL);
+	struct bundle *bundles = malloc(sizeof(struct bundle) * 4);
+	struct routed_bundle_list *e, *list;
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		e = malloc(sizeof(struct routed_bundle_list));
+		e->data = &bundles[i];
+		e->scheduled_size = 100 * (i + 1);
+		e->priority = prio[i];
+		contact_append_bundle_entry(c, e);
+	}
+	TEST_ASSERT_EQUAL(4, c->bundle_count);
+	TEST_ASSERT_EQUAL_UINT64(1000, c->bundle_bytes);
+	// Ordered by priority, then FIFO
+	e = c->contact_bundles;
+	TEST_ASSERT_EQUAL_PTR(&bundles[1], e->data);
+	TEST_ASSERT_EQUAL_PTR(&bundles[3], e->next->data);
+	TEST_ASSERT_EQUAL_PTR(&bundles[0], e->next->next->data);
+	TEST_ASSERT_EQUAL_PTR(&bundles[2], e->next->next->next->data);
+	TEST_ASSERT_EQUAL_PTR(&bundles[2],
+			      c->contact_bundles_tail[BUNDLE_RPRIO_LOW]->data);
+
+	// Remove the only normal-priority bundle
+	TEST_ASSERT_NULL(contact_find_bundle_entry(c, &bundles[3],
+						   BUNDLE_RPRIO_LOW));
+	e = contact_find_bundle_entry(c, &bundles[3], BUNDLE_RPRIO_NORMAL);
+	TEST_ASSERT_NOT_NULL(e);
+	contact_remove_bundle_entry(c, e);
+	free(e);
+	TEST_ASSERT_NULL(c->contact_bundles_tail[BUNDLE_RPRIO_NORMAL]);
+	TEST_ASSERT_EQUAL(3, c->bundle_count);
+	TEST_ASSERT_EQUAL_UINT64(600, c->bundle_bytes);
+	TEST_ASSERT_EQUAL_PTR(&bundles[0], c->contact_bundles->next->data);
+	TEST_ASSERT_EQUAL_PTR(c->contact_bundles,
+			      c->contact_bundles->next->prev);
+
+	// A normal-priority bundle is inserted before the low-priority ones.
+	e = malloc(sizeof(struct routed_bundle_list));
+	e->data = &bundles[3];
+	e->scheduled_size = 400;
+	e->priority = BUNDLE_RPRIO_NORMAL;
+	contact_append_bundle_entry(c, e);
+	TEST_ASSERT_EQUAL_PTR(e, c->contact_bundles->next);
+
+	list = contact_take_bundles(c);
+	TEST_ASSERT_NULL(c->contact_bundles);
+	for (i = 0; i < BUNDLE_RPRIO_MAX; i++)
+		TEST_ASSERT_NULL(c->contact_bundles_tail[i]);
+	TEST_ASSERT_EQUAL(0, c->bundle_count);
+	TEST_ASSERT_EQUAL_UINT64(0, c->bundle_bytes);
+	for (i = 0; list != NULL; i++) {
+		e = list->next;
+		free(list);
+		list = e;
+	}
+	TEST_ASSERT_EQUAL(4, i);
+	free(bundles);
+	free_contact(c);
+}
+
 TEST_GROUP_RUNNER(node)
 {
 	RUN_TEST_CASE(node, contact);
+	RUN_TEST_CASE(node, large_contact_capacity);
 	RUN_TEST_CASE(node, endpoint_list_difference);
 	RUN_TEST_CASE(node, endpoint_list_union);
 	RUN_TEST_CASE(node, contact_list_union);
 	RUN_TEST_CASE(node, contact_list_difference);
 	RUN_TEST_CASE(node, add_contact_to_ordered_list);
+	RUN_TEST_CASE(node, contact_bundle_queue);
 }
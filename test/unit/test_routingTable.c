@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
 #include "ud3tn/bundle_processor.h"
+#include "ud3tn/common.h"
 #include "ud3tn/node.h"
+#include "ud3tn/router.h"
 #include "ud3tn/routing_table.h"
 
 #include "platform/hal_time.h"
@@ -9,6 +11,7 @@
 
 #include "unity_fixture.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -49,6 +52,25 @@ static void rescheduling_mock(struct bundle *b, const void *ctx)
 	(void)ctx;
 }
 
+static void rescheduling_counter(struct bundle *b, const void *ctx)
+{
+	(void)b;
+	(*(int *)ctx)++;
+}
+
+static void schedule_fake_bundle(struct contact *c, struct bundle *b)
+{
+	struct routed_bundle_list *entry = malloc(
+		sizeof(struct routed_bundle_list)
+	);
+
+	entry->data = b;
+	entry->scheduled_size = 300;
+	entry->priority = BUNDLE_RPRIO_LOW;
+	contact_append_bundle_entry(c, entry);
+	c->remaining_capacity_p0 -= 300;
+}
+
 TEST_SETUP(routingTable)
 {
 	/* node1-1 */
@@ -261,8 +283,200 @@ TEST(routingTable, routing_table_replace)
 	free_node(node3);
 }
 
+TEST(routingTable, routing_table_node_index)
+{
+	struct node *n, *hot[2];
+	char eid[32];
+	int i;
+
+	for (i = 0; i < 1000; i++) {
+		snprintf(eid, sizeof(eid), "dtn://n%d/", i);
+		n = node_create(eid);
+		n->cla_addr = strdup("cla:addr");
+		if (i % 100 == 0)
+			n->flags = NODE_FLAG_INTERNET_ACCESS;
+		TEST_ASSERT_TRUE(routing_table_add_node(n, rescheduler));
+	}
+	for (i = 0; i < 1000; i++) {
+		snprintf(eid, sizeof(eid), "dtn://n%d/", i);
+		n = routing_table_lookup_node(eid);
+		TEST_ASSERT_NOT_NULL(n);
+		TEST_ASSERT_EQUAL_STRING(eid, n->eid);
+	}
+	TEST_ASSERT_EQUAL(2, routing_table_lookup_hot_node(hot, 2));
+	TEST_ASSERT_TRUE(HAS_FLAG(hot[0]->flags, NODE_FLAG_INTERNET_ACCESS));
+	for (i = 0; i < 1000; i++) {
+		snprintf(eid, sizeof(eid), "dtn://n%d/", i);
+		TEST_ASSERT_TRUE(routing_table_delete_node_by_eid(
+			eid,
+			rescheduler
+		));
+	}
+	TEST_ASSERT_NULL(routing_table_lookup_node("dtn://n0/"));
+	TEST_ASSERT_NULL(routing_table_get_node_list());
+	TEST_ASSERT_EQUAL(0, routing_table_lookup_hot_node(hot, 2));
+	free_node(node11);
+	free_node(node12);
+	free_node(node13);
+	free_node(node14);
+	free_node(node2);
+	free_node(node3);
+	free_node(node4);
+}
+
+TEST(routingTable, routing_table_modify_contacts)
+{
+	struct bundle bundles[3];
+	struct node *n, *update;
+	struct contact *first, *second;
+	struct node_table_entry *nti;
+	int rescheduled = 0;
+	size_t modified;
+	const struct rescheduling_handle counter = {
+		.reschedule_func = rescheduling_counter,
+		.reschedule_func_context = &rescheduled,
+	};
+	int i;
+
+	n = node_create("node7");
+	n->cla_addr = strdup("cla:addr7");
+	first = createct(n, 10000, 20000, 100);
+	second = createct(n, 30000, 40000, 100);
+	add_contact_to_ordered_list(&n->contacts, first, 1);
+	add_contact_to_ordered_list(&n->contacts, second, 1);
+	TEST_ASSERT_TRUE(routing_table_add_node(n, counter));
+	for (i = 0; i < 3; i++)
+		schedule_fake_bundle(first, &bundles[i]);
+	TEST_ASSERT_EQUAL_INT64(100, first->remaining_capacity_p0);
+
+	// Adding a contact does not touch the scheduled bundles.
+	n = node_create("node7");
+	add_contact_to_ordered_list(&n->contacts,
+				    createct(n, 50000, 60000, 100), 1);
+	TEST_ASSERT_TRUE(routing_table_add_node(n, counter));
+	TEST_ASSERT_EQUAL(0, rescheduled);
+	TEST_ASSERT_EQUAL(3, first->bundle_count);
+	nti = routing_table_lookup_eid("node7");
+	TEST_ASSERT_EQUAL_UINT16(3, nti->ref_count);
+
+	// Halving the window only re-routes the bundles which do not fit.
+	update = node_create("node7");
+	add_contact_to_ordered_list(&update->contacts,
+				    createct(update, 12000, 17000, 100), 1);
+	TEST_ASSERT_TRUE(routing_table_modify_contacts(
+		update,
+		counter,
+		&modified
+	));
+	TEST_ASSERT_EQUAL(2, rescheduled);
+	TEST_ASSERT_EQUAL(1, first->bundle_count);
+	TEST_ASSERT_EQUAL_PTR(&bundles[0], first->contact_bundles->data);
+	TEST_ASSERT_EQUAL_UINT64(12000, first->from);
+	TEST_ASSERT_EQUAL_UINT64(17000, first->to);
+	TEST_ASSERT_EQUAL_INT64(200, first->remaining_capacity_p0);
+	TEST_ASSERT_EQUAL_PTR(first, nti->contacts->data);
+	TEST_ASSERT_TRUE(contact_timeline_contains(first));
+
+	// Moving it behind the second contact keeps all lists sorted.
+	update = node_create("node7");
+	add_contact_to_ordered_list(&update->contacts,
+				    createct(update, 16000, 45000, 100), 1);
+	TEST_ASSERT_FALSE(routing_table_modify_contacts(
+		update,
+		counter,
+		&modified
+	));
+	update = node_create("node7");
+	add_contact_to_ordered_list(&update->contacts,
+				    createct(update, 16000, 25000, 100), 1);
+	TEST_ASSERT_TRUE(routing_table_modify_contacts(
+		update,
+		counter,
+		&modified
+	));
+	update = node_create("node7");
+	add_contact_to_ordered_list(&update->contacts,
+				    createct(update, 42000, 45000, 1000), 1);
+	TEST_ASSERT_FALSE(routing_table_modify_contacts(
+		update,
+		counter,
+		&modified
+	));
+	TEST_ASSERT_EQUAL_PTR(first, nti->contacts->data);
+	TEST_ASSERT_EQUAL_PTR(second, nti->contacts->next->data);
+	TEST_ASSERT_EQUAL(2, rescheduled);
+	TEST_ASSERT_EQUAL(0, modified);
+
+	// Contacts with a unique overlap are modified even if others are not.
+	update = node_create("node7");
+	add_contact_to_ordered_list(&update->contacts,
+				    createct(update, 30000, 40000, 200), 1);
+	add_contact_to_ordered_list(&update->contacts,
+				    createct(update, 70000, 80000, 100), 1);
+	TEST_ASSERT_FALSE(routing_table_modify_contacts(
+		update,
+		counter,
+		&modified
+	));
+	TEST_ASSERT_EQUAL(1, modified);
+	TEST_ASSERT_EQUAL_UINT64(200, second->bitrate);
+
+	// Deleting the second contact leaves the first one alone.
+	update = node_create("node7");
+	add_contact_to_ordered_list(&update->contacts,
+				    createct(update, 30000, 40000, 100), 1);
+	TEST_ASSERT_TRUE(routing_table_delete_node(update, counter));
+	TEST_ASSERT_EQUAL_UINT16(2, nti->ref_count);
+	TEST_ASSERT_EQUAL_PTR(first, nti->contacts->data);
+	TEST_ASSERT_EQUAL(1, first->bundle_count);
+	TEST_ASSERT_EQUAL(2, rescheduled);
+
+	router_remove_bundle_entry_from_contact(first, first->contact_bundles);
+	free_node(node11);
+	free_node(node12);
+	free_node(node13);
+	free_node(node14);
+	free_node(node2);
+	free_node(node3);
+	free_node(node4);
+}
+
+TEST(routingTable, router_command_partial_bulk)
+{
+	struct router_command *cmd = malloc(sizeof(struct router_command));
+	size_t applied = 0;
+
+	// The node without a CLA address is rejected, the others are applied.
+	cmd->type = ROUTER_COMMAND_ADD_BULK;
+	cmd->data = NULL;
+	cmd->node_count = 3;
+	cmd->nodes = malloc(sizeof(struct node *) * cmd->node_count);
+	cmd->nodes[0] = node2;
+	cmd->nodes[1] = node1_no_cla1;
+	cmd->nodes[2] = node3;
+	TEST_ASSERT_EQUAL(UD3TN_FAIL, router_process_command(
+		cmd,
+		rescheduler,
+		&applied
+	));
+	TEST_ASSERT_EQUAL(2, applied);
+	TEST_ASSERT_EQUAL_PTR(node2, routing_table_lookup_node("node2"));
+	TEST_ASSERT_EQUAL_PTR(node3, routing_table_lookup_node("node3"));
+	TEST_ASSERT_NULL(routing_table_lookup_node("node1"));
+
+	free_node(node11);
+	free_node(node12);
+	free_node(node13);
+	free_node(node14);
+	free_node(node1_no_cla2);
+	free_node(node4);
+}
+
 TEST_GROUP_RUNNER(routingTable)
 {
 	RUN_TEST_CASE(routingTable, routing_table_add_delete);
 	RUN_TEST_CASE(routingTable, routing_table_replace);
+	RUN_TEST_CASE(routingTable, routing_table_node_index);
+	RUN_TEST_CASE(routingTable, routing_table_modify_contacts);
+	RUN_TEST_CASE(routingTable, router_command_partial_bulk);
 }
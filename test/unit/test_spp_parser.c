@@ -215,10 +215,62 @@ TEST(spp_parser, parse_header_with_timestamp_segmentwise)
 			  parser_instance.state);
 }
 
+TEST(spp_parser, parse_header_with_timestamp_span)
+{
+	const uint8_t packet[] = {
+		0x08, 0x01,
+		0x80, 0x03,
+		0x00, 0x09,
+		0x71, 0x68, 0x37, 0x0d, 0x00, 0x06, 0x76, 0xab,
+		0x23, 0x42,
+	};
+
+	struct spp_tc_context_t timecode;
+
+	timecode.with_p_field = false;
+	timecode.defaults.type = SPP_TC_UNSEGMENTED_CCSDS_EPOCH;
+	timecode.defaults.unsegmented.base_unit_octets = 4;
+	timecode.defaults.unsegmented.fractional_octets = 4;
+
+	TEST_ASSERT_TRUE(spp_configure_timecode(ctx, &timecode));
+
+	// The header is consumed up to the end of the given span.
+	size_t read = spp_parser_read(&parser_instance, &packet[0], 10);
+
+	TEST_ASSERT_EQUAL(10, read);
+	TEST_ASSERT_EQUAL(SPP_PARSER_STATE_SH_TIMECODE_SUBPARSER,
+			  parser_instance.state);
+
+	read = spp_parser_read(&parser_instance, &packet[10],
+			       ARRAY_SIZE(packet) - 10);
+
+	TEST_ASSERT_EQUAL(4, read);
+	TEST_ASSERT_EQUAL(SPP_PARSER_STATE_DATA_SUBPARSER,
+			  parser_instance.state);
+	TEST_ASSERT_EQUAL(2, parser_instance.data_length);
+	TEST_ASSERT_EQUAL_UINT64(577279245,
+				 parser_instance.dtn_timestamp);
+
+	// A complete header is decoded with a single call.
+	spp_parser_reset(&parser_instance);
+	read = spp_parser_read(&parser_instance, &packet[0],
+			       ARRAY_SIZE(packet));
+
+	TEST_ASSERT_EQUAL(14, read);
+	TEST_ASSERT_EQUAL(SPP_PARSER_STATE_DATA_SUBPARSER,
+			  parser_instance.state);
+	TEST_ASSERT_EQUAL(1, parser_instance.header.apid);
+	TEST_ASSERT_EQUAL(3, parser_instance.header.segment_number);
+	TEST_ASSERT_EQUAL(2, parser_instance.data_length);
+	TEST_ASSERT_EQUAL_UINT64(577279245,
+				 parser_instance.dtn_timestamp);
+}
+
 TEST_GROUP_RUNNER(spp_parser)
 {
 	RUN_TEST_CASE(spp_parser, parse_header);
 	RUN_TEST_CASE(spp_parser, parse_header_bytewise);
 	RUN_TEST_CASE(spp_parser, parse_header_with_timestamp);
 	RUN_TEST_CASE(spp_parser, parse_header_with_timestamp_segmentwise);
+	RUN_TEST_CASE(spp_parser, parse_header_with_timestamp_span);
 }
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: BSD-3-Clause OR Apache-2.0
+#include "cla/posix/cla_tcpclv4_proto.h"
+
+#include "ud3tn/common.h"
+
+#include "unity_fixture.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+TEST_GROUP(tcpclv4_proto);
+
+TEST_SETUP(tcpclv4_proto)
+{
+}
+
+TEST_TEAR_DOWN(tcpclv4_proto)
+{
+}
+
+TEST(tcpclv4_proto, integer_coding)
+{
+	uint8_t buf[8];
+
+	tcpclv4_write_u16(buf, 0x1234);
+	TEST_ASSERT_EQUAL_HEX8(0x12, buf[0]);
+	TEST_ASSERT_EQUAL_HEX8(0x34, buf[1]);
+	TEST_ASSERT_EQUAL_HEX16(0x1234, tcpclv4_read_u16(buf));
+
+	tcpclv4_write_u32(buf, 0xDEADBEEF);
+	TEST_ASSERT_EQUAL_HEX8(0xDE, buf[0]);
+	TEST_ASSERT_EQUAL_HEX8(0xEF, buf[3]);
+	TEST_ASSERT_EQUAL_HEX32(0xDEADBEEF, tcpclv4_read_u32(buf));
+
+	tcpclv4_write_u64(buf, 0x0102030405060708);
+	TEST_ASSERT_EQUAL_HEX8(0x01, buf[0]);
+	TEST_ASSERT_EQUAL_HEX8(0x08, buf[7]);
+	TEST_ASSERT_EQUAL_HEX64(0x0102030405060708, tcpclv4_read_u64(buf));
+}
+
+TEST(tcpclv4_proto, contact_header_and_sess_init)
+{
+	const uint8_t expected_header[] = { 'd', 't', 'n', '!', 0x04, 0x00 };
+	uint8_t header[TCPCLV4_CONTACT_HEADER_SIZE];
+
+	tcpclv4_generate_contact_header(header);
+	TEST_ASSERT_EQUAL_MEMORY(expected_header, header, sizeof(header));
+
+	const uint8_t expected_sess_init[] = {
+		0x07,
+		0x00, 0x3C,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00,
+		0x00, 0x07,
+		'i', 'p', 'n', ':', '1', '.', '0',
+		0x00, 0x00, 0x00, 0x00,
+	};
+	size_t len;
+	uint8_t *sess_init = tcpclv4_generate_sess_init(
+		"ipn:1.0", 60, 0x10000, 0x40000000, &len);
+
+	TEST_ASSERT_NOT_NULL(sess_init);
+	TEST_ASSERT_EQUAL_UINT(sizeof(expected_sess_init), len);
+	TEST_ASSERT_EQUAL_MEMORY(expected_sess_init, sess_init, len);
+	free(sess_init);
+}
+
+TEST(tcpclv4_proto, segment_header)
+{
+	uint8_t buf[TCPCLV4_MAX_SEGMENT_HEADER_SIZE +
+		    TCPCLV4_TRANSFER_LENGTH_ITEM_SIZE];
+	uint8_t *const end = &buf[sizeof(buf)];
+	size_t len;
+
+	// START segment with Transfer Length extension item
+	const uint8_t expected_start[] = {
+		0x01, 0x02,
+		0, 0, 0, 0, 0, 0, 0, 0x2A,
+		0, 0, 0, 0x0D,
+		0x00, 0x00, 0x01, 0x00, 0x08,
+		0, 0, 0, 0, 0, 0, 0x10, 0x00,
+		0, 0, 0, 0, 0, 0, 0x04, 0x00,
+	};
+
+	len = tcpclv4_prepend_segment_header(
+		end, TCPCLV4_SEGMENT_FLAG_START, 42, 0x1000, 0x400);
+	TEST_ASSERT_EQUAL_UINT(sizeof(expected_start), len);
+	TEST_ASSERT_EQUAL_MEMORY(expected_start, end - len, len);
+
+	// Subsequent END segment without extension items
+	const uint8_t expected_end[] = {
+		0x01, 0x01,
+		0, 0, 0, 0, 0, 0, 0, 0x2A,
+		0, 0, 0, 0, 0, 0, 0x0C, 0x00,
+	};
+
+	len = tcpclv4_prepend_segment_header(
+		end, TCPCLV4_SEGMENT_FLAG_END, 42, 0x1000, 0xC00);
+	TEST_ASSERT_EQUAL_UINT(sizeof(expected_end), len);
+	TEST_ASSERT_EQUAL_MEMORY(expected_end, end - len, len);
+}
+
+TEST(tcpclv4_proto, ack_and_refuse)
+{
+	uint8_t ack[TCPCLV4_XFER_ACK_SIZE];
+	uint8_t refuse[TCPCLV4_XFER_REFUSE_SIZE];
+	const uint8_t expected_ack[] = {
+		0x02, 0x03,
+		0, 0, 0, 0, 0, 0, 0, 0x07,
+		0, 0, 0, 0, 0, 0, 0x01, 0x00,
+	};
+	const uint8_t expected_refuse[] = {
+		0x03, 0x02,
+		0, 0, 0, 0, 0, 0, 0, 0x07,
+	};
+
+	tcpclv4_generate_xfer_ack(ack, TCPCLV4_SEGMENT_FLAG_START |
+				  TCPCLV4_SEGMENT_FLAG_END, 7, 0x100);
+	TEST_ASSERT_EQUAL_MEMORY(expected_ack, ack, sizeof(ack));
+	tcpclv4_generate_xfer_refuse(refuse, TCPCLV4_REFUSE_NO_RESOURCES, 7);
+	TEST_ASSERT_EQUAL_MEMORY(expected_refuse, refuse, sizeof(refuse));
+}
+
+TEST(tcpclv4_proto, transfer_extensions)
+{
+	uint64_t transfer_length = 0;
+	const uint8_t length_item[] = {
+		0x00, 0x00, 0x01, 0x00, 0x08,
+		0, 0, 0, 0, 0, 0x01, 0x00, 0x00,
+	};
+	const uint8_t unknown_item[] = {
+		0x00, 0x12, 0x34, 0x00, 0x01, 0xFF,
+	};
+	const uint8_t critical_item[] = {
+		0x01, 0x12, 0x34, 0x00, 0x01, 0xFF,
+	};
+	const uint8_t truncated_item[] = {
+		0x00, 0x00, 0x01, 0x00, 0x08, 0x00,
+	};
+
+	TEST_ASSERT_EQUAL_INT(0, tcpclv4_parse_transfer_extensions(
+		length_item, sizeof(length_item), &transfer_length));
+	TEST_ASSERT_EQUAL_UINT64(0x10000, transfer_length);
+	TEST_ASSERT_EQUAL_INT(0, tcpclv4_parse_transfer_extensions(
+		unknown_item, sizeof(unknown_item), &transfer_length));
+	TEST_ASSERT_EQUAL_INT(-1, tcpclv4_parse_transfer_extensions(
+		critical_item, sizeof(critical_item), &transfer_length));
+	TEST_ASSERT_EQUAL_INT(-1, tcpclv4_parse_transfer_extensions(
+		truncated_item, sizeof(truncated_item), &transfer_length));
+}
+
+TEST_GROUP_RUNNER(tcpclv4_proto)
+{
+	RUN_TEST_CASE(tcpclv4_proto, integer_coding);
+	RUN_TEST_CASE(tcpclv4_proto, contact_header_and_sess_init);
+	RUN_TEST_CASE(tcpclv4_proto, segment_header);
+	RUN_TEST_CASE(tcpclv4_proto, ack_and_refuse);
+	RUN_TEST_CASE(tcpclv4_proto, transfer_extensions);
+}